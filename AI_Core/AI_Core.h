@@ -5,7 +5,20 @@
 #include "DecisionTree.h"
 #include "FiniteStateMachine.h"
 #include "Kinematic.h"
+#include "KinematicBatch.h"
+#include "SpatialGrid.h"
+#include "Flocking.h"
+#include "OrcaAvoidance.h"
+#include "PathHeuristics.h"
 #include "Graph.h"
+#include "CsrGraph.h"
+#include "HierarchicalPathfinder.h"
+#include "GridMap.h"
+#include "JumpPointSearch.h"
+#include "IncrementalPlanner.h"
+#include "PathRequest.h"
+#include "PathScheduler.h"
+#include "FlowField.h"
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "CsrGraph.h"
+#include <assert.h>
+#include <algorithm>
+#include "Graph.h"
+#include "ThreadPool.h"
+
+
+CsrGraph::CsrGraph()
+{
+	offsets.assign(1, 0);
+}
+
+Void CsrGraph::Build(Graph& graph)
+{
+	uInt nodeCount = graph.getNodeCount();
+
+	//count the connections first, so every array is allocated once
+	uInt edgeCount = 0;
+	list<Connection*> connections;
+	for(uInt node = 0; node < nodeCount; node++)
+	{
+		graph.getNode(node)->getConnections(&connections);
+		for(list<Connection*>::iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+			edgeCount += (*conItr)->getToNode()->isOpen() ? 1 : 0;
+	}
+
+	offsets.resize(nodeCount + 1);
+	targets.resize(edgeCount);
+	costs.resize(edgeCount);
+	positions.resize(nodeCount);
+
+	uInt edge = 0;
+	for(uInt node = 0; node < nodeCount; node++)
+	{
+		PathNode* pathNode = graph.getNode(node);
+		offsets[node] = edge;
+		positions[node] = pathNode->getPosition();
+
+		pathNode->getConnections(&connections);
+		for(list<Connection*>::iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+		{
+			//searches of the graph do not enter closed nodes, so neither do those of the copy
+			PathNode* toNode = (*conItr)->getToNode();
+			assert(toNode->getId() < nodeCount && graph.getNode(toNode->getId()) == toNode);
+			if(!toNode->isOpen())
+				continue;
+
+			targets[edge] = toNode->getId();
+			costs[edge] = (*conItr)->getCost();
+			edge++;
+		}
+	}
+	offsets[nodeCount] = edge;
+}
+
+Void CsrGraph::Build(uInt nodeCount, const uInt* from, const uInt* to, const Float* cost, uInt edgeCount,
+					 const Vector3D* positions)
+{
+	//a counting sort of the edges by the node they leave; stable, so each node keeps the given order
+	offsets.assign(nodeCount + 1, 0);
+	for(uInt e = 0; e < edgeCount; e++)
+	{
+		assert(from[e] < nodeCount && to[e] < nodeCount);
+		offsets[from[e] + 1]++;
+	}
+	for(uInt node = 0; node < nodeCount; node++)
+		offsets[node + 1] += offsets[node];
+
+	targets.resize(edgeCount);
+	costs.resize(edgeCount);
+
+	//offsets[n] walks from the first edge of node n to the first edge of node n + 1, so shift them back after
+	for(uInt e = 0; e < edgeCount; e++)
+	{
+		uInt edge = offsets[from[e]]++;
+		targets[edge] = to[e];
+		costs[edge] = cost[e];
+	}
+	for(uInt node = nodeCount; node > 0; node--)
+		offsets[node] = offsets[node - 1];
+	offsets[0] = 0;
+
+	if(positions != NULL)
+		this->positions.assign(positions, positions + nodeCount);
+	else
+		this->positions.assign(nodeCount, Vector3D());
+}
+
+uInt64 CsrGraph::MemoryUsed() const
+{
+	return (uInt64)offsets.capacity() * sizeof(uInt) + (uInt64)targets.capacity() * sizeof(uInt) +
+		   (uInt64)costs.capacity() * sizeof(Float) + (uInt64)positions.capacity() * sizeof(Vector3D);
+}
+
+Bool CsrGraph::FindPath(uInt start, uInt goal, const Heuristic& heuristic, NodePathResult* result, PathTieBreak tieBreak)
+{
+	return FindPath(start, goal, heuristic, result, tieBreak, context);
+}
+
+Bool CsrGraph::FindPath(uInt start, uInt goal, const Heuristic& heuristic, NodePathResult* result,
+						PathTieBreak tieBreak, SearchContext& context) const
+{
+	result->nodes.clear();
+	result->cost = 0;
+	result->found = AStarSearch(*this, start, goal, heuristic, tieBreak, context, &result->nodesExpanded);
+
+	if(!result->found)
+		return false;
+
+	result->cost = context.Record(goal).costSoFar;
+
+	//follow the parents back to the start
+	for(uInt node = goal; node != noPathNode; node = context.Record(node).parent)
+		result->nodes.push_back(node);
+	std::reverse(result->nodes.begin(), result->nodes.end());
+
+	return true;
+}
+
+Void CsrGraph::FindPaths(const uInt* starts, const uInt* goals, uInt count, const Heuristic& heuristic,
+						 NodePathResult* results, ThreadPool* pool, PathTieBreak tieBreak) const
+{
+	auto findRange = [&](uInt begin, uInt end)
+	{
+		//each thread keeps its own context between batches
+		static thread_local SearchContext threadContext;
+		FindPathsRange(starts, goals, begin, end, heuristic, results, tieBreak, threadContext);
+	};
+
+	//a search is long enough to be worth a chunk of its own
+	if(pool == NULL)
+		findRange(0, count);
+	else
+		pool->ParallelFor(count, 1, findRange);
+}
+
+Void CsrGraph::FindPathsRange(const uInt* starts, const uInt* goals, uInt begin, uInt end, const Heuristic& heuristic,
+							  NodePathResult* results, PathTieBreak tieBreak, SearchContext& context) const
+{
+	for(uInt i = begin; i < end; i++)
+		FindPath(starts[i], goals[i], heuristic, &results[i], tieBreak, context);
+}
@@ -0,0 +1,124 @@
+#ifndef _CSRGRAPH_H_
+#define _CSRGRAPH_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "CoreMathPhysics.h"
+#include "PathSearch.h"
+
+class Graph;
+class ThreadPool;
+
+
+//Class CsrGraph
+//A graph for searching that does not change once built, stored in compressed sparse row form:
+//the connections of node n are entries EdgeBegin(n) to EdgeEnd(n) - 1 of two arrays holding
+//the node each one goes to and its cost. Looking at the connections of a node reads one short
+//run of memory, and a connection takes 8 bytes instead of a list entry and a Connection of its own.
+//Nodes are numbered 0 to NodeCount() - 1; a CsrGraph built from a Graph uses the ids of its nodes.
+//To change the graph, build it again. Searches only read the graph, so many threads can search it at
+//once, each with a SearchContext of its own.
+class CsrGraph
+{
+public:
+	//Constructor
+	//creates a graph with no nodes
+	CsrGraph();
+
+	//Build()
+	//return type: Void
+	//parameters : Graph&
+	//copies the nodes, positions and connections of graph, leaving out connections to closed nodes;
+	//the connections of each node keep their order, so searches find the same paths as on graph
+	Void Build(Graph& graph);
+
+	//Build()
+	//return type: Void
+	//parameters : uInt, const uInt*, const uInt*, const Float*, uInt, const Vector3D*
+	//builds a graph of nodeCount nodes and edgeCount one way connections, edge e going from from[e]
+	//to to[e] with cost[e]; add both directions for a two way connection. The connections of each node
+	//keep the order they are given in. positions, if not NULL, holds the position of every node
+	Void Build(uInt nodeCount, const uInt* from, const uInt* to, const Float* cost, uInt edgeCount,
+			   const Vector3D* positions = NULL);
+
+	uInt NodeCount() const		{ return (uInt)positions.size(); }
+	uInt EdgeCount() const		{ return (uInt)targets.size(); }
+
+	//the connections of a node are the edges EdgeBegin(node) to EdgeEnd(node) - 1
+	uInt EdgeBegin(uInt node) const	{ return offsets[node]; }
+	uInt EdgeEnd(uInt node) const		{ return offsets[node + 1]; }
+	uInt EdgeTarget(uInt edge) const	{ return targets[edge]; }
+	Float EdgeCost(uInt edge) const		{ return costs[edge]; }
+
+	//the arrays themselves: NodeCount() + 1 offsets, EdgeCount() targets and costs
+	const uInt* Offsets() const		{ return offsets.data(); }
+	const uInt* Targets() const		{ return targets.data(); }
+	const Float* Costs() const		{ return costs.data(); }
+
+	//Position()
+	//return type: const Vector3D&
+	//parameters : uInt
+	//returns where a node is, the origin if no positions were given
+	const Vector3D& Position(uInt node) const	{ return positions[node]; }
+
+	//ForEachEdge()
+	//return type: Void
+	//parameters : uInt, Visit
+	//calls visit(to, cost) for each connection of node, in order
+	template <class Visit>
+	Void ForEachEdge(uInt node, Visit visit) const
+	{
+		for(uInt edge = offsets[node]; edge < offsets[node + 1]; edge++)
+			visit(targets[edge], costs[edge]);
+	}
+
+	//MemoryUsed()
+	//return type: uInt64
+	//parameters : none
+	//returns the bytes held by the arrays
+	uInt64 MemoryUsed() const;
+
+
+	/////////////////////////////////////////////////////////////////////
+	//FindPath()
+	//return type: Bool
+	//parameters : uInt, uInt, const Heuristic&, NodePathResult*, PathTieBreak
+	//the same search as Graph::findPath: A* from start to goal, or Dijkstra with an empty heuristic.
+	//Returns true and fills out result->nodes and result->cost if a path was found, false if it
+	//wasn't; result->nodesExpanded is filled out either way. Uses the context of the graph, so only one
+	//thread may call it at a time
+	Bool FindPath(uInt start, uInt goal, const Heuristic& heuristic, NodePathResult* result,
+				  PathTieBreak tieBreak = TIE_NEAR_GOAL);
+
+	//FindPath()
+	//return type: Bool
+	//parameters : uInt, uInt, const Heuristic&, NodePathResult*, PathTieBreak, SearchContext&
+	//the same, keeping the search state in context
+	Bool FindPath(uInt start, uInt goal, const Heuristic& heuristic, NodePathResult* result,
+				  PathTieBreak tieBreak, SearchContext& context) const;
+
+	//FindPaths()
+	//return type: Void
+	//parameters : const uInt*, const uInt*, uInt, const Heuristic&, NodePathResult*, ThreadPool*, PathTieBreak
+	//finds count paths, from starts[i] to goals[i] into results[i]. If a pool is given the searches are
+	//split across its threads, each using a context of its own; the results are the same either way
+	Void FindPaths(const uInt* starts, const uInt* goals, uInt count, const Heuristic& heuristic,
+				   NodePathResult* results, ThreadPool* pool = NULL, PathTieBreak tieBreak = TIE_NEAR_GOAL) const;
+
+	//FindPathsRange()
+	//the same for the queries [begin, end), using context
+	Void FindPathsRange(const uInt* starts, const uInt* goals, uInt begin, uInt end, const Heuristic& heuristic,
+						NodePathResult* results, PathTieBreak tieBreak, SearchContext& context) const;
+
+private:
+	std::vector<uInt> offsets;
+	std::vector<uInt> targets;
+	std::vector<Float> costs;
+	std::vector<Vector3D> positions;
+
+	//search state of FindPath when it is not given a context, kept between searches
+	SearchContext context;
+};
+
+
+#endif
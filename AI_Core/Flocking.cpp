@@ -0,0 +1,222 @@
+#include "Flocking.h"
+#include <assert.h>
+#include <cfloat>
+#include "ThreadPool.h"
+
+//batches smaller than this are not worth splitting across threads
+static const uInt flockingGrain = 1024;
+
+
+SteeringOutput BlendWeighted(const SteeringOutput* behaviors, const Float* weights, uInt count,
+							 Float maxLinear, Float maxAngular)
+{
+	SteeringOutput steering;
+	steering.angularVel = 0;
+
+	for(uInt i = 0; i < count; i++)
+	{
+		steering.linearVel += weights[i] * behaviors[i].linearVel;
+		steering.angularVel += weights[i] * behaviors[i].angularVel;
+	}
+
+	//trim the result to what the agent can do
+	Float speed = steering.linearVel.Length();
+	if(speed > maxLinear)
+		steering.linearVel *= maxLinear / speed;
+
+	if(steering.angularVel > maxAngular)
+		steering.angularVel = maxAngular;
+	else if(steering.angularVel < -maxAngular)
+		steering.angularVel = -maxAngular;
+
+	return steering;
+}
+
+SteeringOutput BlendPriority(const SteeringOutput* behaviors, uInt count, Float epsilon)
+{
+	assert(count > 0);
+
+	for(uInt i = 0; i + 1 < count; i++)
+	{
+		if(behaviors[i].linearVel.LengthSquared() > epsilon * epsilon || fabs(behaviors[i].angularVel) > epsilon)
+			return behaviors[i];
+	}
+
+	return behaviors[count - 1];
+}
+
+
+FlockingSettings::FlockingSettings()
+{
+	neighbourRadius = 5;
+	separationRadius = 1.5f;
+	maxNeighbours = 16;
+	goalWeight = 1;
+	separationWeight = 2;
+	alignmentWeight = 0.5f;
+	cohesionWeight = 0.5f;
+	prioritySeparation = false;
+	priorityEpsilon = 0.01f;
+}
+
+
+Flocking::Flocking()
+{
+}
+
+FlockingSettings& Flocking::Settings()
+{
+	return settings;
+}
+
+Void Flocking::Resize(uInt count)
+{
+	separationX.resize(count);
+	separationY.resize(count);
+	alignmentX.resize(count);
+	alignmentY.resize(count);
+	cohesionX.resize(count);
+	cohesionY.resize(count);
+	linearX.resize(count);
+	linearY.resize(count);
+	angular.resize(count);
+}
+
+Void Flocking::Update(const KinematicBatch& batch, const SpatialGrid& grid,
+					  const Float* velocityX, const Float* velocityY, ThreadPool* pool)
+{
+	Resize(batch.Count());
+
+	if(pool == NULL)
+		UpdateRange(batch, grid, velocityX, velocityY, 0, batch.Count());
+	else
+		pool->ParallelFor(batch.Count(), flockingGrain, [&](uInt begin, uInt end)
+		{
+			UpdateRange(batch, grid, velocityX, velocityY, begin, end);
+		});
+}
+
+Void Flocking::UpdateRange(const KinematicBatch& batch, const SpatialGrid& grid,
+						   const Float* velocityX, const Float* velocityY, uInt begin, uInt end)
+{
+	assert(grid.Count() == batch.Count());
+	assert(begin <= end && end <= batch.Count() && end <= linearX.size());
+
+	const Float* positionX = batch.PositionX();
+	const Float* positionY = batch.PositionY();
+	const Float* maxSpeed = batch.MaxSpeeds();
+	const Float* goalX = batch.LinearX();
+	const Float* goalY = batch.LinearY();
+	const Float* goalAngular = batch.Angular();
+
+	Float separationSquared = settings.separationRadius * settings.separationRadius;
+	Float weights[4] = { settings.goalWeight, settings.separationWeight, settings.alignmentWeight, settings.cohesionWeight };
+
+	for(uInt agent = begin; agent < end; agent++)
+	{
+		Float x = positionX[agent], y = positionY[agent];
+		Float speed = maxSpeed[agent];
+
+		//sum up the neighbours; offsets rather than positions, so that agents far from the
+		//origin do not lose precision
+		uInt neighbours = 0;
+		Float pushX = 0, pushY = 0;
+		Float velocitySumX = 0, velocitySumY = 0;
+		Float offsetSumX = 0, offsetSumY = 0;
+
+		grid.ForEachInRadius(Vector2D(x, y), settings.neighbourRadius,
+			[&](uInt other, Float otherX, Float otherY, Float distanceSquared)
+		{
+			if(other == agent || neighbours >= settings.maxNeighbours)
+				return;
+
+			neighbours++;
+			Float offsetX = otherX - x, offsetY = otherY - y;
+			velocitySumX += velocityX[other];
+			velocitySumY += velocityY[other];
+			offsetSumX += offsetX;
+			offsetSumY += offsetY;
+
+			//away from the neighbour, from nothing at separationRadius to full strength on top of it;
+			//agents on exactly the same spot have no direction to separate in
+			if(distanceSquared < separationSquared && distanceSquared > 0)
+			{
+				Float distance = sqrt(distanceSquared);
+				Float strength = (settings.separationRadius - distance) / (settings.separationRadius * distance);
+				pushX -= offsetX * strength;
+				pushY -= offsetY * strength;
+			}
+		});
+
+		SteeringOutput behaviors[4];
+		behaviors[0].linearVel = Vector2D(goalX[agent], goalY[agent]);
+		behaviors[0].angularVel = goalAngular[agent];
+
+		behaviors[1].linearVel = Vector2D(pushX, pushY) * speed;
+		Float pushSpeed = behaviors[1].linearVel.Length();
+		if(pushSpeed > speed)
+			behaviors[1].linearVel *= speed / pushSpeed;
+		behaviors[1].angularVel = 0;
+
+		behaviors[2].angularVel = 0;
+		behaviors[3].angularVel = 0;
+		if(neighbours > 0)
+		{
+			Float share = 1.0f / neighbours;
+			behaviors[2].linearVel = Vector2D(velocitySumX * share, velocitySumY * share);
+			behaviors[3].linearVel = Vector2D(offsetSumX * share, offsetSumY * share) * (speed / settings.neighbourRadius);
+		}
+
+		SteeringOutput steering = BlendWeighted(behaviors, weights, 4, speed, FLT_MAX);
+		if(settings.prioritySeparation)
+		{
+			SteeringOutput groups[2];
+			groups[0] = BlendWeighted(&behaviors[1], &weights[1], 1, speed, FLT_MAX);
+			groups[1] = steering;
+			steering = BlendPriority(groups, 2, settings.priorityEpsilon);
+		}
+
+		separationX[agent] = behaviors[1].linearVel[0];
+		separationY[agent] = behaviors[1].linearVel[1];
+		alignmentX[agent] = behaviors[2].linearVel[0];
+		alignmentY[agent] = behaviors[2].linearVel[1];
+		cohesionX[agent] = behaviors[3].linearVel[0];
+		cohesionY[agent] = behaviors[3].linearVel[1];
+		linearX[agent] = steering.linearVel[0];
+		linearY[agent] = steering.linearVel[1];
+		angular[agent] = steering.angularVel;
+	}
+}
+
+
+static SteeringOutput Make_Output(Float x, Float y, Float angularVel)
+{
+	SteeringOutput steering;
+	steering.linearVel = Vector2D(x, y);
+	steering.angularVel = angularVel;
+	return steering;
+}
+
+SteeringOutput Flocking::Separation(uInt slot) const
+{
+	assert(slot < linearX.size());
+	return Make_Output(separationX[slot], separationY[slot], 0);
+}
+
+SteeringOutput Flocking::Alignment(uInt slot) const
+{
+	assert(slot < linearX.size());
+	return Make_Output(alignmentX[slot], alignmentY[slot], 0);
+}
+
+SteeringOutput Flocking::Cohesion(uInt slot) const
+{
+	assert(slot < linearX.size());
+	return Make_Output(cohesionX[slot], cohesionY[slot], 0);
+}
+
+SteeringOutput Flocking::Output(uInt slot) const
+{
+	assert(slot < linearX.size());
+	return Make_Output(linearX[slot], linearY[slot], angular[slot]);
+}
@@ -0,0 +1,132 @@
+#ifndef _FLOCKING_H_
+#define _FLOCKING_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "KinematicBatch.h"
+#include "SpatialGrid.h"
+
+class ThreadPool;
+
+
+/////////////////////////////////////////////////////////////////////
+//Blending of steering behaviors
+
+//BlendWeighted()
+//return type: SteeringOutput
+//parameters : const SteeringOutput*, const Float*, uInt, Float, Float
+//adds up count behaviors, each times its weight, and limits the result to maxLinear speed
+//and maxAngular rotation
+SteeringOutput BlendWeighted(const SteeringOutput* behaviors, const Float* weights, uInt count,
+							 Float maxLinear, Float maxAngular);
+
+//BlendPriority()
+//return type: SteeringOutput
+//parameters : const SteeringOutput*, uInt, Float
+//returns the first of count behaviors (most important first) that asks for more than epsilon
+//of linear or angular velocity, or the last one if none does. Each entry is usually a
+//BlendWeighted group, e.g. avoiding others first, then everything else
+SteeringOutput BlendPriority(const SteeringOutput* behaviors, uInt count, Float epsilon);
+
+
+//Structure holding the settings of Flocking
+struct FlockingSettings
+{
+public:
+	//other agents within this distance are neighbours
+	Float neighbourRadius;
+	//neighbours within this distance are pushed away
+	Float separationRadius;
+	//at most this many neighbours are looked at, the first ones the grid finds
+	uInt maxNeighbours;
+
+	//weights of the behavior already in the batch output (e.g. Seek), and of each flocking behavior
+	Float goalWeight;
+	Float separationWeight;
+	Float alignmentWeight;
+	Float cohesionWeight;
+
+	//when true, an agent that needs to separate does only that, and the other behaviors
+	//are blended only when separation asks for less than priorityEpsilon
+	Bool prioritySeparation;
+	Float priorityEpsilon;
+
+	//Constructor
+	//sets settings that suit agents about 1 unit across
+	FlockingSettings();
+};
+
+
+//Class Flocking
+//Separation, alignment and cohesion for every agent of a KinematicBatch, blended with the
+//behavior last run on the batch.
+//Like the Kinematic behaviors each result is a velocity:
+//	separation moves away from neighbours that are too close, faster the closer they are
+//	alignment is the average velocity of the neighbours
+//	cohesion moves towards the centre of the neighbours, faster the further it is
+//Neighbours come from a SpatialGrid holding the positions of the batch, one item per slot.
+//Every agent only reads the shared state and writes its own results, so Update can be split
+//across a ThreadPool and gives the same results however it is split.
+class Flocking
+{
+public:
+	//Constructor
+	//creates flocking with default settings
+	Flocking();
+
+	//Settings()
+	//return type: FlockingSettings&
+	//parameters : none
+	//returns the settings, to read or change
+	FlockingSettings& Settings();
+
+	//Update()
+	//return type: Void
+	//parameters : const KinematicBatch&, const SpatialGrid&, const Float*, const Float*, ThreadPool*
+	//computes the flocking behaviors of every agent and blends them with the output of the batch.
+	//velocityX and velocityY are the current velocities of the agents, e.g. the blended output
+	//of the previous update; grid must hold the positions of the batch
+	Void Update(const KinematicBatch& batch, const SpatialGrid& grid,
+				const Float* velocityX, const Float* velocityY, ThreadPool* pool = NULL);
+
+	//UpdateRange()
+	//the same for the agents in the slots [begin, end); call Update or Resize first so the
+	//results have room for every agent
+	Void UpdateRange(const KinematicBatch& batch, const SpatialGrid& grid,
+					 const Float* velocityX, const Float* velocityY, uInt begin, uInt end);
+
+	//Resize()
+	//return type: Void
+	//parameters : uInt
+	//makes room for the results of count agents
+	Void Resize(uInt count);
+
+
+	/////////////////////////////////////////////////////////////////////
+	//results of the last update for one agent
+	SteeringOutput Separation(uInt slot) const;
+	SteeringOutput Alignment(uInt slot) const;
+	SteeringOutput Cohesion(uInt slot) const;
+	//the blended result
+	SteeringOutput Output(uInt slot) const;
+
+	//the blended velocities of all agents
+	const Float* LinearX() const { return linearX.data(); }
+	const Float* LinearY() const { return linearY.data(); }
+
+private:
+	FlockingSettings settings;
+
+	std::vector<Float> separationX;
+	std::vector<Float> separationY;
+	std::vector<Float> alignmentX;
+	std::vector<Float> alignmentY;
+	std::vector<Float> cohesionX;
+	std::vector<Float> cohesionY;
+	std::vector<Float> linearX;
+	std::vector<Float> linearY;
+	std::vector<Float> angular;
+};
+
+
+#endif
@@ -0,0 +1,356 @@
+#include "FlowField.h"
+#include <assert.h>
+#include <cfloat>
+#include <math.h>
+#include "IndexedHeap.h"
+#include "ThreadPool.h"
+
+const Byte FlowField::noDirection;
+
+//cells across a tile
+static const uInt flowTileSize = 32;
+
+//rows of cells worth giving a thread of their own when picking directions
+static const uInt flowRowGrain = 16;
+
+//cost of a diagonal move; straight moves cost 1
+static const Float flowDiagonalCost = 1.41421356f;
+
+
+namespace
+{
+	//the 8 directions, counterclockwise from +x
+	const Int stepX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+	const Int stepY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+	const Float stepCost[8] = { 1, flowDiagonalCost, 1, flowDiagonalCost, 1, flowDiagonalCost, 1, flowDiagonalCost };
+	const Float unitX[8] = { 1, 0.70710678f, 0, -0.70710678f, -1, -0.70710678f, 0, 0.70710678f };
+	const Float unitY[8] = { 0, 0.70710678f, 1, 0.70710678f, 0, -0.70710678f, -1, -0.70710678f };
+
+	//true if an agent can move from x, y, which must be walkable, one step along direction;
+	//diagonals need both cells beside them walkable too. The same holds moving back
+	inline Bool Can_Move(const GridMap& map, Int x, Int y, uInt direction)
+	{
+		Int dx = stepX[direction];
+		Int dy = stepY[direction];
+		if(!map.IsWalkable(x + dx, y + dy))
+			return false;
+		return dx == 0 || dy == 0 || (map.IsWalkable(x + dx, y) && map.IsWalkable(x, y + dy));
+	}
+
+	//bit for the tile sx, sy (each -1, 0 or 1) from a tile
+	inline uInt Tile_Bit(Int sx, Int sy)
+	{
+		return 1u << ((sy + 1) * 3 + sx + 1);
+	}
+}
+
+
+FlowField::FlowField()
+{
+	origin = Vector2D(0, 0);
+	cellSize = 1;
+	width = height = 0;
+	goal = 0;
+}
+
+Void FlowField::SetPlacement(const Vector2D& origin, Float cellSize)
+{
+	assert(cellSize > 0);
+	this->origin = origin;
+	this->cellSize = cellSize;
+}
+
+Void FlowField::Build(const GridMap& map, uInt goal, ThreadPool* pool)
+{
+	assert(goal < map.CellCount());
+
+	width = map.Width();
+	height = map.Height();
+	this->goal = goal;
+	costs.assign(map.CellCount(), FLT_MAX);
+	directions.assign(map.CellCount(), noDirection);
+
+	if(!map.IsWalkable(map.CellX(goal), map.CellY(goal)))
+		return;
+
+	uInt tilesX = (width + flowTileSize - 1) / flowTileSize;
+	uInt tilesY = (height + flowTileSize - 1) / flowTileSize;
+	tileQueued.assign(tilesX * tilesY, 0);
+	tileChanges.assign(tilesX * tilesY, 0);
+	tileQueued[(map.CellY(goal) / flowTileSize) * tilesX + map.CellX(goal) / flowTileSize] = 1;
+
+	//Search the queued tiles in four groups, by whether their x and y are odd, so no two tiles
+	//searched at once touch, even at a corner. Each search may queue the tiles around it again;
+	//the costs only ever go down, so this ends, at the costs Dijkstra would find
+	for(Bool queued = true; queued; )
+	{
+		queued = false;
+		for(uInt group = 0; group < 4; group++)
+		{
+			batch.clear();
+			for(uInt tileY = group >> 1; tileY < tilesY; tileY += 2)
+				for(uInt tileX = group & 1; tileX < tilesX; tileX += 2)
+				{
+					uInt tile = tileY * tilesX + tileX;
+					if(tileQueued[tile])
+					{
+						tileQueued[tile] = 0;
+						batch.push_back(tile);
+					}
+				}
+
+			if(batch.empty())
+				continue;
+			queued = true;
+
+			auto searchRange = [&](uInt begin, uInt end)
+			{
+				for(uInt i = begin; i < end; i++)
+					tileChanges[batch[i]] = searchTile(map, batch[i] % tilesX, batch[i] / tilesX);
+			};
+
+			if(pool == NULL)
+				searchRange(0, (uInt)batch.size());
+			else
+				pool->ParallelFor((uInt)batch.size(), 1, searchRange);
+
+			//queue the neighbours whose shared edges got cheaper
+			for(uInt i = 0; i < batch.size(); i++)
+			{
+				Int tileX = (Int)(batch[i] % tilesX);
+				Int tileY = (Int)(batch[i] / tilesX);
+				for(Int sy = -1; sy <= 1; sy++)
+					for(Int sx = -1; sx <= 1; sx++)
+					{
+						Int x = tileX + sx;
+						Int y = tileY + sy;
+						if((tileChanges[batch[i]] & Tile_Bit(sx, sy)) && x >= 0 && y >= 0 && x < (Int)tilesX && y < (Int)tilesY)
+							tileQueued[y * tilesX + x] = 1;
+					}
+			}
+		}
+	}
+
+	if(pool == NULL)
+		pickDirections(map, 0, height);
+	else
+		pool->ParallelFor(height, flowRowGrain, [&](uInt begin, uInt end) { pickDirections(map, begin, end); });
+}
+
+uInt FlowField::searchTile(const GridMap& map, uInt tileX, uInt tileY)
+{
+	Int x0 = (Int)(tileX * flowTileSize);
+	Int y0 = (Int)(tileY * flowTileSize);
+	Int x1 = x0 + (Int)flowTileSize < (Int)width ? x0 + (Int)flowTileSize : (Int)width;
+	Int y1 = y0 + (Int)flowTileSize < (Int)height ? y0 + (Int)flowTileSize : (Int)height;
+
+	//the open set of the calling thread, over the cells of one tile
+	static thread_local IndexedHeap open;
+	if(open.Capacity() != flowTileSize * flowTileSize)
+		open.Resize(flowTileSize * flowTileSize);
+
+	uInt changes = 0;
+	auto lowered = [&](Int x, Int y, Float cost)
+	{
+		costs[y * width + x] = cost;
+		open.Push((y - y0) * flowTileSize + (x - x0), cost);
+
+		//cells on the edge are looked at by the tiles across it
+		if(x != x0 && x != x1 - 1 && y != y0 && y != y1 - 1)
+			return;
+		for(Int sy = -1; sy <= 1; sy++)
+			for(Int sx = -1; sx <= 1; sx++)
+				if((sx == 0 || x == (sx < 0 ? x0 : x1 - 1)) && (sy == 0 || y == (sy < 0 ? y0 : y1 - 1)))
+					changes |= Tile_Bit(sx, sy);
+	};
+
+	Int goalX = map.CellX(goal);
+	Int goalY = map.CellY(goal);
+	if(goalX >= x0 && goalX < x1 && goalY >= y0 && goalY < y1 && costs[goal] != 0)
+		lowered(goalX, goalY, 0);
+
+	//the cells on the edge, from the costs of the tiles around
+	for(Int y = y0; y < y1; y++)
+	{
+		Bool edgeRow = y == y0 || y == y1 - 1;
+		for(Int x = x0; x < x1; x += (edgeRow || x1 - 1 == x0) ? 1 : x1 - 1 - x0)
+		{
+			if(!map.IsWalkable(x, y))
+				continue;
+
+			Float best = costs[y * width + x];
+			for(uInt d = 0; d < 8; d++)
+			{
+				Int nx = x + stepX[d];
+				Int ny = y + stepY[d];
+				if(nx >= x0 && nx < x1 && ny >= y0 && ny < y1)
+					continue;
+				if(!Can_Move(map, x, y, d) || costs[ny * width + nx] == FLT_MAX)
+					continue;
+
+				Float cost = costs[ny * width + nx] + stepCost[d];
+				if(cost < best)
+					best = cost;
+			}
+
+			if(best < costs[y * width + x])
+				lowered(x, y, best);
+		}
+	}
+
+	//then Dijkstra inside the tile from the cells that got cheaper
+	while(!open.Empty())
+	{
+		uInt local = open.Pop();
+		Int x = x0 + (Int)(local % flowTileSize);
+		Int y = y0 + (Int)(local / flowTileSize);
+		Float cost = costs[y * width + x];
+
+		for(uInt d = 0; d < 8; d++)
+		{
+			Int nx = x + stepX[d];
+			Int ny = y + stepY[d];
+			if(nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || !Can_Move(map, x, y, d))
+				continue;
+
+			Float through = cost + stepCost[d];
+			if(through < costs[ny * width + nx])
+				lowered(nx, ny, through);
+		}
+	}
+
+	return changes;
+}
+
+Void FlowField::pickDirections(const GridMap& map, uInt begin, uInt end)
+{
+	for(uInt y = begin; y < end; y++)
+	{
+		for(uInt x = 0; x < width; x++)
+		{
+			uInt cell = y * width + x;
+			if(cell == goal || costs[cell] == FLT_MAX)
+				continue;
+
+			//the neighbour the cheapest path goes through
+			Float best = FLT_MAX;
+			for(uInt d = 0; d < 8; d++)
+			{
+				if(!Can_Move(map, (Int)x, (Int)y, d))
+					continue;
+
+				Float neighbour = costs[(y + stepY[d]) * width + x + stepX[d]];
+				if(neighbour != FLT_MAX && neighbour + stepCost[d] < best)
+				{
+					best = neighbour + stepCost[d];
+					directions[cell] = (Byte)d;
+				}
+			}
+		}
+	}
+}
+
+Void FlowField::Step(Byte direction, Int* dx, Int* dy)
+{
+	assert(direction < 8);
+	*dx = stepX[direction];
+	*dy = stepY[direction];
+}
+
+Int FlowField::CellAt(const Vector2D& position) const
+{
+	Float fx = floor((position[0] - origin[0]) / cellSize);
+	Float fy = floor((position[1] - origin[1]) / cellSize);
+	if(fx < 0 || fy < 0 || fx >= (Float)width || fy >= (Float)height)
+		return -1;
+
+	return (Int)fy * (Int)width + (Int)fx;
+}
+
+Vector2D FlowField::DirectionAt(const Vector2D& position) const
+{
+	Int cell = CellAt(position);
+	if(cell < 0 || directions[cell] == noDirection)
+		return Vector2D(0, 0);
+
+	Byte direction = directions[cell];
+	return Vector2D(unitX[direction], unitY[direction]);
+}
+
+uInt64 FlowField::MemoryUsed() const
+{
+	return costs.capacity() * sizeof(Float) + directions.capacity() * sizeof(Byte);
+}
+
+
+FlowFieldCache::FlowFieldCache(uInt capacity)
+{
+	assert(capacity > 0);
+
+	map = NULL;
+	origin = Vector2D(0, 0);
+	cellSize = 1;
+	uses = 0;
+
+	entries.resize(capacity);
+	Clear();
+}
+
+Void FlowFieldCache::SetMap(const GridMap& map, const Vector2D& origin, Float cellSize)
+{
+	this->map = &map;
+	this->origin = origin;
+	this->cellSize = cellSize;
+	Clear();
+}
+
+const FlowField& FlowFieldCache::Get(uInt goal, ThreadPool* pool)
+{
+	assert(map != NULL);
+	uses++;
+
+	//the cached field, or the slot used longest ago to build it in
+	uInt slot = 0;
+	for(uInt i = 0; i < entries.size(); i++)
+	{
+		if(entries[i].built && entries[i].field.Goal() == goal)
+		{
+			entries[i].lastUsed = uses;
+			return entries[i].field;
+		}
+
+		if(!entries[i].built)
+		{
+			if(entries[slot].built)
+				slot = i;
+		}
+		else if(entries[slot].built && entries[i].lastUsed < entries[slot].lastUsed)
+		{
+			slot = i;
+		}
+	}
+
+	Entry& entry = entries[slot];
+	entry.field.SetPlacement(origin, cellSize);
+	entry.field.Build(*map, goal, pool);
+	entry.built = true;
+	entry.lastUsed = uses;
+	return entry.field;
+}
+
+Bool FlowFieldCache::Contains(uInt goal) const
+{
+	for(uInt i = 0; i < entries.size(); i++)
+		if(entries[i].built && entries[i].field.Goal() == goal)
+			return true;
+	return false;
+}
+
+Void FlowFieldCache::Clear()
+{
+	for(uInt i = 0; i < entries.size(); i++)
+	{
+		entries[i].built = false;
+		entries[i].lastUsed = 0;
+	}
+}
@@ -0,0 +1,166 @@
+#ifndef _FLOWFIELD_H_
+#define _FLOWFIELD_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "CoreMathPhysics.h"
+#include "GridMap.h"
+
+class ThreadPool;
+
+
+//Class FlowField
+//The way to one goal from every cell of a GridMap, for many agents going to the same place.
+//Build works out the cost of the cheapest path from each cell to the goal, moving as
+//JumpPointSearch does (8 ways, diagonals 1.41, no cutting corners), and stores for each cell
+//the neighbour to move to. An agent then finds its way with one look up of the cell it is in,
+//however many agents share the field; KinematicBatch::FollowFlow does it for a whole batch.
+//The grid is split into square tiles that are searched on their own, again whenever a
+//neighbouring tile lowers the costs along their shared edge, until nothing changes; tiles that
+//do not touch are searched at the same time, so Build can be split across a ThreadPool.
+//The costs are those of Dijkstra over the grid, however the work is split.
+//Cell x, y covers the square of cellSize from origin + (x, y) * cellSize.
+class FlowField
+{
+public:
+	//direction of cells with no way to the goal, and of the goal itself
+	static const Byte noDirection = 0xFF;
+
+	//Constructor
+	//creates an empty field with cells 1 across from the origin
+	FlowField();
+
+	//SetPlacement()
+	//return type: Void
+	//parameters : const Vector2D&, Float
+	//sets where cell 0, 0 starts and how big cells are, for the lookups by position
+	Void SetPlacement(const Vector2D& origin, Float cellSize);
+
+	//Build()
+	//return type: Void
+	//parameters : const GridMap&, uInt, ThreadPool*
+	//works out the field of map towards the cell goal. If a pool is given the tiles are split across
+	//its threads; the field is the same either way
+	Void Build(const GridMap& map, uInt goal, ThreadPool* pool = NULL);
+
+	uInt Width() const		{ return width; }
+	uInt Height() const		{ return height; }
+	uInt Goal() const		{ return goal; }
+
+	//Cost()
+	//return type: Float
+	//parameters : uInt
+	//returns the cost of the cheapest path from cell to the goal, FLT_MAX if there is none
+	Float Cost(uInt cell) const		{ return costs[cell]; }
+
+	//Direction()
+	//return type: Byte
+	//parameters : uInt
+	//returns which of the 8 neighbours to move to from cell (see Step), or noDirection
+	Byte Direction(uInt cell) const	{ return directions[cell]; }
+
+	//Step()
+	//return type: Void
+	//parameters : Byte, Int*, Int*
+	//the change of x and y that direction moves by
+	static Void Step(Byte direction, Int* dx, Int* dy);
+
+	//CellAt()
+	//return type: Int
+	//parameters : const Vector2D&
+	//returns the cell position is in, or -1 outside the grid
+	Int CellAt(const Vector2D& position) const;
+
+	//DirectionAt()
+	//return type: Vector2D
+	//parameters : const Vector2D&
+	//returns the unit vector to move along at position; zero at the goal, where there is no
+	//way to it, and outside the grid
+	Vector2D DirectionAt(const Vector2D& position) const;
+
+	//MemoryUsed()
+	//return type: uInt64
+	//parameters : none
+	//returns the bytes held by the costs and directions
+	uInt64 MemoryUsed() const;
+
+private:
+	//searches one tile, starting from the costs of the cells around it; returns a bit for each of
+	//the 8 tiles around it whose edge with this one got cheaper
+	uInt searchTile(const GridMap& map, uInt tileX, uInt tileY);
+	//picks the direction of each cell in rows [begin, end) from the costs
+	Void pickDirections(const GridMap& map, uInt begin, uInt end);
+
+	Vector2D origin;
+	Float cellSize;
+
+	uInt width;
+	uInt height;
+	uInt goal;
+
+	std::vector<Float> costs;
+	std::vector<Byte> directions;
+
+	//tiles still to search, and the edges each search lowered
+	std::vector<Byte> tileQueued;
+	std::vector<uInt> tileChanges;
+	std::vector<uInt> batch;
+};
+
+
+//Class FlowFieldCache
+//Keeps the fields of the goals used most recently, so units sent to the same place again, or
+//sent there by another order, do not build the field again. When the cache is full the field used
+//longest ago makes way. After the grid changes, Clear the cache.
+class FlowFieldCache
+{
+public:
+	//Constructor
+	//creates a cache of up to capacity fields
+	explicit FlowFieldCache(uInt capacity = 8);
+
+	//SetMap()
+	//return type: Void
+	//parameters : const GridMap&, const Vector2D&, Float
+	//sets the grid the fields are of, and their placement; drops every field. The grid must
+	//outlive the cache
+	Void SetMap(const GridMap& map, const Vector2D& origin = Vector2D(0, 0), Float cellSize = 1);
+
+	//Get()
+	//return type: const FlowField&
+	//parameters : uInt, ThreadPool*
+	//returns the field towards goal, building it first if it is not cached. The field stays
+	//valid until a Get has to build one in its place
+	const FlowField& Get(uInt goal, ThreadPool* pool = NULL);
+
+	//Contains()
+	//return type: Bool
+	//parameters : uInt
+	//returns true if the field towards goal is cached
+	Bool Contains(uInt goal) const;
+
+	//Clear()
+	//return type: Void
+	//parameters : none
+	//drops every field, keeping their memory
+	Void Clear();
+
+private:
+	struct Entry
+	{
+		Bool built;
+		//when it was last asked for
+		uInt64 lastUsed;
+		FlowField field;
+	};
+
+	const GridMap* map;
+	Vector2D origin;
+	Float cellSize;
+
+	std::vector<Entry> entries;
+	uInt64 uses;
+};
+
+
+#endif
@@ -1,9 +1,35 @@
 #include "Graph.h"
+#include <cfloat>
+#include <assert.h>
+#include <algorithm>
+#include "ThreadPool.h"
 
 PathNode::PathNode()
 {
 	open = true;
 	connections.clear();
+	id = 0;
+}
+
+PathNode::~PathNode()
+{
+	for(list<Connection*>::iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+	{
+		//the neighbour's connection back to this node
+		PathNode* neighbour = (*conItr)->getToNode();
+		for(list<Connection*>::iterator backItr = neighbour->connections.begin(); neighbour != this && backItr != neighbour->connections.end(); backItr++)
+		{
+			if((*backItr)->getToNode() == this)
+			{
+				delete *backItr;
+				neighbour->connections.erase(backItr);
+				break;
+			}
+		}
+
+		delete *conItr;
+	}
+	connections.clear();
 }
 
 Bool PathNode::isOpen()
@@ -48,11 +74,29 @@ Void PathNode::openNode()
 	open = true;
 }
 
-Bool PathNode::operator==(PathNode node)
+uInt PathNode::getId()
+{
+	return id;
+}
+
+Void PathNode::setPosition(const Vector2D& position)
 {
-	list<Connection*> otherConnections;
-	node.getConnections(&otherConnections);
-	if(this->connections == otherConnections)
+	this->position = Vector3D(position, 0);
+}
+
+Void PathNode::setPosition(const Vector3D& position)
+{
+	this->position = position;
+}
+
+const Vector3D& PathNode::getPosition()
+{
+	return position;
+}
+
+Bool PathNode::operator==(const PathNode& node)
+{
+	if(this->connections == node.connections)
 	{
 		return true;
 	}
@@ -61,11 +105,9 @@ Bool PathNode::operator==(PathNode node)
 	}
 }
 
-Bool PathNode::operator!=(PathNode node)
+Bool PathNode::operator!=(const PathNode& node)
 {
-	list<Connection*> otherConnections;
-	node.getConnections(&otherConnections);
-	if(this->connections == otherConnections)
+	if(this->connections == node.connections)
 	{
 		return false;
 	}
@@ -98,10 +140,19 @@ PathNode* Connection::getFromNode()
 }
 
 
+PathResult::PathResult()
+{
+	cost = 0;
+	nodesExpanded = 0;
+	found = false;
+}
+
+
 Graph::Graph()
 {
 	nodes.clear();
 	currentNode = NULL;
+	changeCount = 0;
 }
 
 Void Graph::addNode(PathNode* node)
@@ -111,153 +162,182 @@ Void Graph::addNode(PathNode* node)
 		currentNode = node;
 	}
 
+	node->id = (uInt)nodes.size();
 	nodes.push_back(node);
 }
 
+PathNode* Graph::getNode(uInt id)
+{
+	return nodes[id];
+}
+
+uInt Graph::getNodeCount()
+{
+	return (uInt)nodes.size();
+}
 
-Bool Graph::traverse(PathNode* start, PathNode* end, list<Connection*>* path)
+Bool Graph::setConnectionCost(PathNode* from, PathNode* to, Float cost)
 {
-	//Make sure there is nothing in the path
-	path->clear();
-	//Open up all nodes in this graph
-	for(list<PathNode*>::iterator nodItr = nodes.begin(); nodItr != nodes.end(); nodItr++)
-	{
-		(*nodItr)->openNode();
-	}
+	Bool connected = false;
 
-	//structure to keep track of info for each node
-	struct NodeRecord
+	//the connection each way; a node connected to itself has only one
+	for(list<Connection*>::iterator conItr = from->connections.begin(); conItr != from->connections.end(); conItr++)
 	{
-		PathNode* node;
-		Connection* connection;
-		NodeRecord* prevNode;
-		Float costSoFar;
-
-		Bool operator==(NodeRecord otherRecord)
+		if((*conItr)->toNode == to)
 		{
-			if(this->node == otherRecord.node
-				&& this->connection == otherRecord.connection
-				&& this->costSoFar == otherRecord.costSoFar)
-				return true;
-			else
-				return false;
+			(*conItr)->cost = cost;
+			connected = true;
 		}
+	}
+	for(list<Connection*>::iterator conItr = to->connections.begin(); conItr != to->connections.end(); conItr++)
+	{
+		if((*conItr)->toNode == from)
+			(*conItr)->cost = cost;
+	}
 
-	};
+	if(connected)
+	{
+		recordChange(from->id);
+		recordChange(to->id);
+	}
 
-	//Initialize record for start node
-	NodeRecord startNode;
-	startNode.node = start;
-	startNode.connection = NULL;
-	startNode.costSoFar = 0;
+	return connected;
+}
 
-	//Create open and closed lists of node records
-	list<NodeRecord> open;
-	list<NodeRecord> closed;
+Void Graph::closeNode(PathNode* node)
+{
+	node->closeNode();
+	recordChange(node->id);
+}
 
-	//Put the start node in the open list
-	open.push_back(startNode);
-	
-	//Keep track of the current node
-	NodeRecord current;
-	while( open.size() > 0)
-	{
-		
-		
-		//find the lowest cost so far in the open set of nodes
-		Float lowestCost = FLT_MAX;
-		for(list<NodeRecord>::iterator nodeItr = open.begin(); nodeItr != open.end(); nodeItr++)
-		{
-			if(nodeItr->costSoFar < lowestCost)
-			{
-				lowestCost = nodeItr->costSoFar;
-				current = *nodeItr;
-			}
-		}
+Void Graph::openNode(PathNode* node)
+{
+	node->openNode();
+	recordChange(node->id);
+}
 
-		//If this is the end Node break
-		if(current.node == end)
-		{
-			break;
-		}
+Void Graph::recordChange(uInt node)
+{
+	//the log is only made once something changes
+	if(changes.empty())
+		changes.resize(graphChangeLogSize);
 
-		//to store the connectinos of the currentNode
-		list<Connection*> connections;
-		//Fill out connections
-		current.node->getConnections(&connections);
+	changes[changeCount % graphChangeLogSize] = node;
+	changeCount++;
+}
 
-		//for each connection of this node...
-		for(list<Connection*>::iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
-		{
-			//get the toNode
-			PathNode* endNode = (*conItr)->getToNode();
-			//Figure the cost so far for this connection
-			Float endNodeCost = current.costSoFar + (*conItr)->getCost();
+uInt Graph::getChangeCount() const
+{
+	return changeCount;
+}
 
-			//If this node is closed, skip over it
-			if(!endNode->isOpen())
-			{
-				continue;
-			}
+Bool Graph::getChanges(uInt since, std::vector<uInt>* changed) const
+{
+	changed->clear();
 
-			//check if this node is in the open set and is a worse route
-			Bool worseRoute = false;
-			Bool alreadyInOpen = false;
-			for(list<NodeRecord>::iterator nodeItr = open.begin(); nodeItr != open.end(); nodeItr++)
-			{
-				if(nodeItr->node == endNode && nodeItr->connection == *conItr)
-				{
-					alreadyInOpen = true;
-
-					if(nodeItr->costSoFar < endNodeCost || nodeItr->costSoFar == endNodeCost)
-					{
-						worseRoute = true;
-						break;
-					}
-				}
-			}
-			if(worseRoute) // if this route is worse, go on to next connection
-			{
-				continue;
-			}
+	//the count wraps around, and graphChangeLogSize divides 2^32, so the difference and the positions
+	//in the log stay right when it does
+	uInt behind = changeCount - since;
+	if(behind > graphChangeLogSize)
+		return false;
 
-			//If the node is not closed and not in the open set then we have an unvisited node so add it to the open set
-			if(!alreadyInOpen)
-			{
-				NodeRecord endNodeRecord;
-				endNodeRecord.node = endNode;
-				endNodeRecord.connection = *conItr;
-				endNodeRecord.costSoFar = endNodeCost;
+	for(uInt n = since; n != changeCount; n++)
+		changed->push_back(changes[n % graphChangeLogSize]);
+	return true;
+}
 
-				endNodeRecord.prevNode = new NodeRecord();
-				endNodeRecord.prevNode->node = current.node;
-				endNodeRecord.prevNode->connection = current.connection;
-				endNodeRecord.prevNode->prevNode = current.prevNode;
+GraphAdjacency Graph::getAdjacency() const
+{
+	return GraphAdjacency(nodes);
+}
 
-				open.push_back(endNodeRecord);
-			}
 
+Bool Graph::traverse(PathNode* start, PathNode* end, list<Connection*>* path)
+{
+	//Make sure there is nothing in the path
+	path->clear();
 
-		}
+	if(!search(start, end, Heuristic(), TIE_FIRST_FOUND, context, NULL))
+	{
+		return false;
+	}
 
-		//At this point we have gone through all connections of this node so close it and remove from open set
-		current.node->closeNode();
-		open.remove(current);
+	//follow the route back to the start
+	for(PathNode* current = end; current != start; current = path->front()->getFromNode())
+	{
+		path->push_front(arrivingConnection(current, context));
 	}
 
+	return true;
+}
+
+Bool Graph::findPath(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathResult* result, PathTieBreak tieBreak)
+{
+	return findPath(start, goal, heuristic, result, tieBreak, context);
+}
 
+Bool Graph::findPath(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathResult* result,
+					 PathTieBreak tieBreak, SearchContext& context) const
+{
+	result->path.clear();
+	result->cost = 0;
+	result->found = search(start, goal, heuristic, tieBreak, context, &result->nodesExpanded);
 
-	if(current.node != end)
+	if(!result->found)
 	{
 		return false;
 	}
 
-	while(current.node != start)
+	result->cost = context.Record(goal->id).costSoFar;
+
+	//follow the route back to the start
+	for(PathNode* current = goal; current != start; current = result->path.back()->getFromNode())
 	{
-		path->push_back(current.connection);
-		current = *current.prevNode;
+		result->path.push_back(arrivingConnection(current, context));
 	}
+	std::reverse(result->path.begin(), result->path.end());
 
-	path->reverse();
 	return true;
-}
\ No newline at end of file
+}
+
+Void Graph::findPaths(PathNode* const* starts, PathNode* const* goals, uInt count, const Heuristic& heuristic,
+					  PathResult* results, ThreadPool* pool, PathTieBreak tieBreak) const
+{
+	auto findRange = [&](uInt begin, uInt end)
+	{
+		//each thread keeps its own context between batches
+		static thread_local SearchContext threadContext;
+		for(uInt i = begin; i < end; i++)
+		{
+			findPath(starts[i], goals[i], heuristic, &results[i], tieBreak, threadContext);
+		}
+	};
+
+	//a search is long enough to be worth a chunk of its own
+	if(pool == NULL)
+		findRange(0, count);
+	else
+		pool->ParallelFor(count, 1, findRange);
+}
+
+
+Bool Graph::search(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathTieBreak tieBreak,
+				   SearchContext& context, uInt* nodesExpanded) const
+{
+	return AStarSearch(GraphAdjacency(nodes), start->id, goal->id, heuristic, tieBreak, context, nodesExpanded);
+}
+
+Connection* Graph::arrivingConnection(PathNode* node, SearchContext& context) const
+{
+	PathNode* parent = nodes[context.Record(node->id).parent];
+	for(list<Connection*>::iterator conItr = parent->connections.begin(); conItr != parent->connections.end(); conItr++)
+	{
+		if((*conItr)->getToNode() == node)
+		{
+			return *conItr;
+		}
+	}
+
+	assert(false);
+	return NULL;
+}
@@ -1,10 +1,13 @@
 #ifndef _GRAPH_H_
 #define _GRAPH_H_
 #include "Typedefs.h"
+#include <vector>
+#include "PathSearch.h"
 
 
 class Connection;
-struct NodeRecord;
+class ThreadPool;
+struct GraphAdjacency;
 
 //Individual Nodes that make up a graph
 class PathNode
@@ -12,16 +15,35 @@ class PathNode
 private:
 	Bool open;
 	list<Connection*> connections;
+	//index of the node in its graph, set by Graph::addNode
+	uInt id;
+	//where the node is, for heuristics; 2D nodes have z == 0
+	Vector3D position;
+
+	friend class Graph;
+	friend struct GraphAdjacency;
+
+	//a copy would share the connections of the node
+	PathNode(const PathNode&);
+	PathNode& operator=(const PathNode&);
 public:
 	//constructor
 	//return type: none
 	//parameters : none
 	PathNode();
 
+	//destructor
+	//return type: none
+	//parameters : none
+	//deletes the connections of this node, and those of its neighbours back to it, so nodes can be deleted
+	//in any order. A graph cannot give back a node added to it, so delete a graph's nodes only together with
+	//the graph, once nothing searches it any more
+	~PathNode();
+
 	//isOpen()
 	//return type: Bool
 	//parameters : none
-	//returns a bool of whether or not this node is currently open
+	//returns a bool of whether or not this node is currently open; searches do not enter closed nodes
 	Bool isOpen();
 
 	//addConnection()
@@ -39,7 +61,7 @@ public:
 	//closeNode()
 	//return type: Void
 	//parameters : none
-	//Closes this node
+	//Closes this node, so searches go around it. Graph::closeNode also tells incremental planners
 	Void closeNode();
 
 	//openNode()
@@ -48,9 +70,28 @@ public:
 	//Opens this node
 	Void openNode();
 
+	//getId()
+	//return type: uInt
+	//parameters : none
+	//returns the index of this node in the graph it was added to (0 for the first node added)
+	uInt getId();
+
+	//setPosition()
+	//return type: Void
+	//parameters : const Vector2D& or const Vector3D&
+	//sets where the node is; only heuristics use it, nodes without one are at the origin
+	Void setPosition(const Vector2D& position);
+	Void setPosition(const Vector3D& position);
+
+	//getPosition()
+	//return type: const Vector3D&
+	//parameters : none
+	//returns where the node is
+	const Vector3D& getPosition();
+
 	//Overloading boolean operaters 
-	Bool operator==(PathNode node);
-	Bool operator!=(PathNode node);
+	Bool operator==(const PathNode& node);
+	Bool operator!=(const PathNode& node);
 };
 
 
@@ -61,6 +102,8 @@ private:
 	PathNode* fromNode;
 	Float cost;
 	Connection();
+
+	friend class Graph;
 public:
 	
 	//Constructor
@@ -89,14 +132,99 @@ public:
 };
 
 
+//The nodes of a Graph as searches see them: ids, positions and connections, only read.
+//It refers to the graph, so it sees nodes added later
+struct GraphAdjacency
+{
+public:
+	const std::vector<PathNode*>& nodes;
+
+	explicit GraphAdjacency(const std::vector<PathNode*>& nodes) : nodes(nodes) {}
+
+	uInt NodeCount() const
+	{
+		return (uInt)nodes.size();
+	}
+
+	const Vector3D& Position(uInt node) const
+	{
+		return nodes[node]->position;
+	}
+
+	//returns true if node is open
+	Bool IsOpen(uInt node) const
+	{
+		return nodes[node]->open;
+	}
+
+	//calls visit(to, cost) for each connection of node, open or closed, in order
+	template <class Visit>
+	Void ForEachNeighbour(uInt node, Visit visit) const
+	{
+		const list<Connection*>& connections = nodes[node]->connections;
+		for(list<Connection*>::const_iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+		{
+			visit((*conItr)->getToNode()->id, (*conItr)->getCost());
+		}
+	}
+
+	//calls visit(to, cost) for each connection of node to an open node, in order
+	template <class Visit>
+	Void ForEachEdge(uInt node, Visit visit) const
+	{
+		const list<Connection*>& connections = nodes[node]->connections;
+		for(list<Connection*>::const_iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+		{
+			PathNode* toNode = (*conItr)->getToNode();
+			if(toNode->open)
+				visit(toNode->id, (*conItr)->getCost());
+		}
+	}
+};
+
+
+//Structure holding what Graph::findPath found
+struct PathResult
+{
+public:
+	//the connections from start to goal, empty if no path was found or start is the goal.
+	//Keeps its memory, so reusing a result for the next search does not allocate
+	std::vector<Connection*> path;
+	//the total cost of path
+	Float cost;
+	//how many nodes were taken off the open set and had their connections looked at
+	uInt nodesExpanded;
+	//true if a path was found
+	Bool found;
+
+	//Constructor
+	//an empty result
+	PathResult();
+};
+
+
+//how many of its latest changes a Graph keeps for incremental planners; a power of two
+const uInt graphChangeLogSize = 4096;
 
 class Graph
 {
 private:
-	list<PathNode*> nodes;
+	//nodes by id
+	std::vector<PathNode*> nodes;
 
 	PathNode* currentNode;
 
+	//search state of traverse and findPath when they are not given a context, kept between searches
+	SearchContext context;
+
+	//the last graphChangeLogSize nodes whose connections changed cost or that were closed or opened,
+	//change n at n % graphChangeLogSize, and how many changes have been recorded
+	std::vector<uInt> changes;
+	uInt changeCount;
+
+	//records a change of node
+	Void recordChange(uInt node);
+
 public:
 	//Graph()
 	//return type: none
@@ -107,15 +235,101 @@ public:
 	//addNode()
 	//return type: Void
 	//parameters : PathNode*
-	//Adds a node the graph
+	//Adds a node the graph and gives it the next id
 	Void addNode(PathNode* node);
 
+	//getNode()
+	//return type: PathNode*
+	//parameters : uInt
+	//returns the node with an id
+	PathNode* getNode(uInt id);
+
+	//getNodeCount()
+	//return type: uInt
+	//parameters : none
+	//returns the number of nodes
+	uInt getNodeCount();
+
+	//setConnectionCost()
+	//return type: Bool
+	//parameters : PathNode*, PathNode*, Float
+	//sets the cost of the connection between from and to, both ways, and records the change for
+	//incremental planners. Returns false if the nodes are not connected
+	Bool setConnectionCost(PathNode* from, PathNode* to, Float cost);
+
+	//closeNode() / openNode()
+	//return type: Void
+	//parameters : PathNode*
+	//closes or opens node, as PathNode::closeNode and openNode do, and records the change for incremental planners
+	Void closeNode(PathNode* node);
+	Void openNode(PathNode* node);
+
+	//getChangeCount()
+	//return type: uInt
+	//parameters : none
+	//returns how many changes have been recorded since the graph was made, counting on from 0 past 0xFFFFFFFF
+	uInt getChangeCount() const;
+
+	//getChanges()
+	//return type: Bool
+	//parameters : uInt, std::vector<uInt>*
+	//fills out changed with the ids of the nodes changed since getChangeCount() returned since, a node
+	//once per change. Only the last graphChangeLogSize changes are kept, so the log does not grow while
+	//nothing reads it; returns false if some of those asked for are gone, and the caller has to start over
+	Bool getChanges(uInt since, std::vector<uInt>* changed) const;
+
+	//getAdjacency()
+	//return type: GraphAdjacency
+	//parameters : none
+	//returns a view of the nodes and connections for searches built on top of the graph
+	GraphAdjacency getAdjacency() const;
+
 	//traverse()
 	//return type: Bool
 	//parameters : PathNode*, PathNode*, list<Connection*>*
 	//Using the dijkstra algorithm, finds a path of lowest cost from start to end and fills out path with connections if a path was found
 	//Will return true if a path was found, false if it wasn't
+	//The open set is a binary heap and the record of each node is found by its id, so a search costs
+	//O((nodes + connections) log nodes). Of several paths with the lowest cost, the first one found is returned
+	//Searches only read the graph and write to a SearchContext; this one uses the context of the graph,
+	//so only one thread may call it at a time. Only filling out path allocates; findPath with a reused
+	//result allocates nothing
 	Bool traverse(PathNode* start, PathNode* end, list<Connection*>* path);
+
+	//findPath()
+	//return type: Bool
+	//parameters : PathNode*, PathNode*, const Heuristic&, PathResult*, PathTieBreak
+	//Using A*, finds a path of lowest cost from start to goal, guided by heuristic and the positions of the nodes.
+	//Will return true and fill out result if a path was found, false if it wasn't; result->nodesExpanded is filled out either way.
+	//The path has the lowest cost as long as heuristic never estimates more than the real cost. Nodes whose
+	//cost is lowered after they were expanded are expanded again, so the heuristic does not need to be consistent,
+	//but then more nodes may be expanded. An empty heuristic searches like traverse
+	Bool findPath(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathResult* result,
+				  PathTieBreak tieBreak = TIE_NEAR_GOAL);
+
+	//findPath()
+	//return type: Bool
+	//parameters : PathNode*, PathNode*, const Heuristic&, PathResult*, PathTieBreak, SearchContext&
+	//the same, keeping the search state in context. Threads may search the same graph at once, each
+	//with its own context, as long as no thread changes the graph meanwhile
+	Bool findPath(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathResult* result,
+				  PathTieBreak tieBreak, SearchContext& context) const;
+
+	//findPaths()
+	//return type: Void
+	//parameters : PathNode* const*, PathNode* const*, uInt, const Heuristic&, PathResult*, ThreadPool*, PathTieBreak
+	//finds count paths, from starts[i] to goals[i] into results[i], the same as findPath. If a pool is given the
+	//searches are split across its threads, each using a context of its own; the results are the same either way
+	Void findPaths(PathNode* const* starts, PathNode* const* goals, uInt count, const Heuristic& heuristic,
+				   PathResult* results, ThreadPool* pool = NULL, PathTieBreak tieBreak = TIE_NEAR_GOAL) const;
+
+private:
+	//runs AStarSearch over the nodes
+	Bool search(PathNode* start, PathNode* goal, const Heuristic& heuristic, PathTieBreak tieBreak,
+				SearchContext& context, uInt* nodesExpanded) const;
+
+	//returns the connection the route found by the last search of context arrives at node by
+	Connection* arrivingConnection(PathNode* node, SearchContext& context) const;
 };
 
 
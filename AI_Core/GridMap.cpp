@@ -0,0 +1,60 @@
+#include "GridMap.h"
+#include <assert.h>
+
+
+GridMap::GridMap()
+{
+	Resize(0, 0);
+}
+
+GridMap::GridMap(uInt width, uInt height, Bool walkable)
+{
+	Resize(width, height, walkable);
+}
+
+Void GridMap::Resize(uInt width, uInt height, Bool walkable)
+{
+	this->width = width;
+	this->height = height;
+	rowWords = (width + 2 + 63) / 64;
+	words.assign((uInt64)(height + 2) * rowWords, 0);
+
+	if(!walkable)
+		return;
+
+	//bits 1 to width of each row in the grid, leaving the border cells blocked
+	for(uInt y = 0; y < height; y++)
+	{
+		uInt64* row = &words[(y + 1) * rowWords];
+		for(uInt bit = 1; bit <= width; bit++)
+			row[bit >> 6] |= (uInt64)1 << (bit & 63);
+	}
+}
+
+Void GridMap::SetWalkable(Int x, Int y, Bool walkable)
+{
+	assert(x >= 0 && y >= 0 && x < (Int)width && y < (Int)height);
+
+	uInt bit = (uInt)x + 1;
+	uInt64& word = words[((uInt)y + 1) * rowWords + (bit >> 6)];
+	uInt64 mask = (uInt64)1 << (bit & 63);
+	if(walkable)
+		word |= mask;
+	else
+		word &= ~mask;
+}
+
+Void GridMap::Transpose(GridMap* result) const
+{
+	result->Resize(height, width, false);
+
+	for(uInt y = 0; y < height; y++)
+		for(uInt x = 0; x < width; x++)
+			if(IsWalkable((Int)x, (Int)y))
+				result->SetWalkable((Int)y, (Int)x, true);
+}
+
+uInt64 GridMap::MemoryUsed() const
+{
+	return words.capacity() * sizeof(uInt64);
+}
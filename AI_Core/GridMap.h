@@ -0,0 +1,106 @@
+#ifndef _GRIDMAP_H_
+#define _GRIDMAP_H_
+
+#include "Typedefs.h"
+#include <vector>
+
+
+//Class GridMap
+//Which cells of a grid can be walked on, one bit per cell.
+//Cells are x 0 to Width() - 1 and y 0 to Height() - 1, numbered y * Width() + x, as a CsrGraph
+//built from the same grid would number its nodes. Everything outside the grid reads as blocked.
+//Each row is stored as a run of 64 bit words with a blocked cell on either side, so 64 cells
+//of a row can be read at once with Bits.
+class GridMap
+{
+public:
+	//Constructor
+	//creates a grid with no cells
+	GridMap();
+
+	//Constructor
+	//creates a grid of width by height cells, all walkable or all blocked
+	GridMap(uInt width, uInt height, Bool walkable = true);
+
+	//Resize()
+	//return type: Void
+	//parameters : uInt, uInt, Bool
+	//makes the grid width by height cells and sets every cell to walkable
+	Void Resize(uInt width, uInt height, Bool walkable = true);
+
+	uInt Width() const		{ return width; }
+	uInt Height() const		{ return height; }
+	uInt CellCount() const	{ return width * height; }
+
+	//Cell() / CellX() / CellY()
+	//converts between a cell number and its x and y
+	uInt Cell(Int x, Int y) const	{ return (uInt)y * width + (uInt)x; }
+	Int CellX(uInt cell) const		{ return (Int)(cell % width); }
+	Int CellY(uInt cell) const		{ return (Int)(cell / width); }
+
+	//IsWalkable()
+	//return type: Bool
+	//parameters : Int, Int
+	//returns true if the cell at x, y can be walked on; false outside the grid
+	Bool IsWalkable(Int x, Int y) const
+	{
+		if(x < 0 || y < 0 || x >= (Int)width || y >= (Int)height)
+			return false;
+		uInt bit = (uInt)x + 1;
+		return ((words[((uInt)y + 1) * rowWords + (bit >> 6)] >> (bit & 63)) & 1) != 0;
+	}
+
+	//SetWalkable()
+	//return type: Void
+	//parameters : Int, Int, Bool
+	//sets whether the cell at x, y, which must be in the grid, can be walked on
+	Void SetWalkable(Int x, Int y, Bool walkable);
+
+	//Bits()
+	//return type: uInt64
+	//parameters : Int, Int
+	//returns the cells x to x + 63 of row y, bit i set if cell x + i can be walked on
+	uInt64 Bits(Int x, Int y) const
+	{
+		if(y < -1 || y > (Int)height)
+			return 0;
+
+		Int bit = x + 1;
+		if(bit < 0)
+			return bit <= -64 ? 0 : Bits(-1, y) << -bit;
+
+		uInt word = (uInt)bit >> 6;
+		uInt shift = (uInt)bit & 63;
+		if(word >= rowWords)
+			return 0;
+
+		const uInt64* row = &words[((uInt)y + 1) * rowWords];
+		uInt64 bits = row[word] >> shift;
+		if(shift != 0 && word + 1 < rowWords)
+			bits |= row[word + 1] << (64 - shift);
+		return bits;
+	}
+
+	//Transpose()
+	//return type: Void
+	//parameters : GridMap*
+	//fills out result with this grid turned on its side: cell x, y of result is cell y, x of this grid
+	Void Transpose(GridMap* result) const;
+
+	//MemoryUsed()
+	//return type: uInt64
+	//parameters : none
+	//returns the bytes held by the bits
+	uInt64 MemoryUsed() const;
+
+private:
+	uInt width;
+	uInt height;
+	//words per row, the row and the blocked cell either side of it
+	uInt rowWords;
+	//height + 2 rows, the ones above and below the grid all blocked; cell x of a row is bit x + 1
+	std::vector<uInt64> words;
+};
+
+
+#endif
@@ -0,0 +1,493 @@
+#include "HierarchicalPathfinder.h"
+#include <assert.h>
+#include <math.h>
+#include <map>
+#include <algorithm>
+
+//stretches of border with at least this many nodes get a transition at each end instead of one in the middle
+static const uInt longEntrance = 6;
+
+
+namespace
+{
+	//the nodes of one cluster of a Graph, as AStarSearch sees them when refining a segment
+	struct ClusterAdjacency
+	{
+		GraphAdjacency graph;
+		const uInt* clusterOf;
+		uInt cluster;
+
+		ClusterAdjacency(const GraphAdjacency& graph, const uInt* clusterOf, uInt cluster)
+			: graph(graph), clusterOf(clusterOf), cluster(cluster) {}
+
+		uInt NodeCount() const						{ return graph.NodeCount(); }
+		const Vector3D& Position(uInt node) const	{ return graph.Position(node); }
+
+		template <class Visit>
+		Void ForEachEdge(uInt node, Visit visit) const
+		{
+			graph.ForEachEdge(node, [&](uInt to, Float cost)
+			{
+				if(clusterOf[to] == cluster)
+					visit(to, cost);
+			});
+		}
+	};
+
+	//a connection leaving a cluster, while its transitions are being chosen. from is the node in the
+	//cluster of lower number, so both clusters see a border the same way and choose the same transitions
+	struct Crossing
+	{
+		uInt toCluster;
+		Float along;	//position along the border of from and to, to put the crossings in order
+		Float alongTo;
+		uInt from;
+		uInt to;
+		Float cost;
+		Bool reversed;	//from is in the other cluster
+
+		Bool operator<(const Crossing& other) const
+		{
+			if(toCluster != other.toCluster)
+				return toCluster < other.toCluster;
+			if(along != other.along)
+				return along < other.along;
+			if(alongTo != other.alongTo)
+				return alongTo < other.alongTo;
+			if(from != other.from)
+				return from < other.from;
+			return to < other.to;
+		}
+	};
+
+	//true if a and b are the same node or have a connection between them
+	Bool Next_To(const GraphAdjacency& graph, uInt a, uInt b)
+	{
+		Bool found = a == b;
+		graph.ForEachEdge(a, [&](uInt to, Float) { found = found || to == b; });
+		return found;
+	}
+}
+
+
+//The abstract graph of a HierarchicalPathfinder during FindPath: the entrances, with the start and
+//goal of the search joined to the entrances of their clusters
+struct AbstractAdjacency
+{
+	const HierarchicalPathfinder& pathfinder;
+	GraphAdjacency graph;
+	uInt start;
+	uInt goal;
+
+	AbstractAdjacency(const HierarchicalPathfinder& pathfinder, uInt start, uInt goal)
+		: pathfinder(pathfinder), graph(pathfinder.graph->getAdjacency()), start(start), goal(goal) {}
+
+	uInt NodeCount() const						{ return graph.NodeCount(); }
+	const Vector3D& Position(uInt node) const	{ return graph.Position(node); }
+
+	template <class Visit>
+	Void ForEachEdge(uInt node, Visit visit) const
+	{
+		uInt cluster = pathfinder.clusterOf[node];
+		const HierarchicalPathfinder::Cluster& nodeCluster = pathfinder.clusters[cluster];
+		uInt index = pathfinder.entranceIndex[node];
+		uInt entrances = (uInt)nodeCluster.entrances.size();
+
+		if(index != noPathNode)
+		{
+			//to the other entrances of the cluster, and across its transitions
+			const Float* costs = &nodeCluster.costs[index * entrances];
+			for(uInt j = 0; j < entrances; j++)
+			{
+				if(j != index && costs[j] < FLT_MAX)
+					visit(nodeCluster.entrances[j], costs[j]);
+			}
+
+			for(uInt t = 0; t < nodeCluster.transitions.size(); t++)
+			{
+				if(nodeCluster.transitions[t].from == node)
+					visit(nodeCluster.transitions[t].to, nodeCluster.transitions[t].cost);
+			}
+		}
+		else if(node == start)
+		{
+			for(uInt j = 0; j < entrances; j++)
+			{
+				if(pathfinder.startCosts[j] < FLT_MAX)
+					visit(nodeCluster.entrances[j], pathfinder.startCosts[j]);
+			}
+		}
+
+		//into the goal from its own cluster
+		if(node == start)
+		{
+			if(pathfinder.startToGoal < FLT_MAX)
+				visit(goal, pathfinder.startToGoal);
+		}
+		else if(cluster == pathfinder.clusterOf[goal] && index != noPathNode && node != goal)
+		{
+			if(pathfinder.goalCosts[index] < FLT_MAX)
+				visit(goal, pathfinder.goalCosts[index]);
+		}
+	}
+};
+
+
+HierarchicalPath::HierarchicalPath()
+{
+	cost = 0;
+	nodesExpanded = 0;
+	found = false;
+}
+
+
+HierarchicalPathfinder::HierarchicalPathfinder()
+{
+	graph = NULL;
+	clusterSize = 1;
+	entranceCount = 0;
+	startToGoal = FLT_MAX;
+}
+
+Void HierarchicalPathfinder::Build(const Graph& graph, Float clusterSize)
+{
+	assert(clusterSize > 0);
+	this->graph = &graph;
+	this->clusterSize = clusterSize;
+
+	GraphAdjacency adjacency = graph.getAdjacency();
+	uInt nodeCount = adjacency.NodeCount();
+
+	clusters.clear();
+	clusterOf.resize(nodeCount);
+	entranceIndex.assign(nodeCount, noPathNode);
+	entranceCount = 0;
+
+	//a cluster for every cell that has nodes, numbered in the order they are first seen
+	std::map<std::pair<Int, Int>, uInt> cells;
+	for(uInt node = 0; node < nodeCount; node++)
+	{
+		const Vector3D& position = adjacency.Position(node);
+		std::pair<Int, Int> cell((Int)floor(position[0] / clusterSize), (Int)floor(position[1] / clusterSize));
+
+		std::map<std::pair<Int, Int>, uInt>::iterator found = cells.find(cell);
+		if(found == cells.end())
+		{
+			found = cells.insert(std::make_pair(cell, (uInt)clusters.size())).first;
+			clusters.push_back(Cluster());
+			clusters.back().cellX = cell.first;
+			clusters.back().cellY = cell.second;
+		}
+
+		clusterOf[node] = found->second;
+		clusters[found->second].nodes.push_back(node);
+	}
+
+	//entrances come from the transitions of both sides, so find all transitions first
+	for(uInt cluster = 0; cluster < clusters.size(); cluster++)
+		findTransitions(cluster);
+	for(uInt cluster = 0; cluster < clusters.size(); cluster++)
+		findEntrances(cluster);
+}
+
+Void HierarchicalPathfinder::RebuildCluster(uInt cluster)
+{
+	assert(cluster < clusters.size());
+
+	//the neighbours before and after the change both have transitions to find again
+	std::vector<uInt> touched = clusters[cluster].neighbours;
+	findTransitions(cluster);
+	for(uInt i = 0; i < clusters[cluster].neighbours.size(); i++)
+	{
+		uInt neighbour = clusters[cluster].neighbours[i];
+		if(std::find(touched.begin(), touched.end(), neighbour) == touched.end())
+			touched.push_back(neighbour);
+	}
+
+	for(uInt i = 0; i < touched.size(); i++)
+		findTransitions(touched[i]);
+
+	findEntrances(cluster);
+	for(uInt i = 0; i < touched.size(); i++)
+		findEntrances(touched[i]);
+}
+
+uInt HierarchicalPathfinder::ClusterCount() const
+{
+	return (uInt)clusters.size();
+}
+
+uInt HierarchicalPathfinder::ClusterOf(uInt node) const
+{
+	assert(node < clusterOf.size());
+	return clusterOf[node];
+}
+
+uInt HierarchicalPathfinder::EntranceCount() const
+{
+	return entranceCount;
+}
+
+Void HierarchicalPathfinder::findTransitions(uInt cluster)
+{
+	GraphAdjacency adjacency = graph->getAdjacency();
+	Cluster& current = clusters[cluster];
+
+	//every connection leaving the cluster, in order along the border with each neighbour
+	std::vector<Crossing> crossings;
+	for(uInt i = 0; i < current.nodes.size(); i++)
+	{
+		uInt from = current.nodes[i];
+		//ForEachEdge leaves out connections into closed nodes; leave out those out of them too, so both
+		//clusters see the same crossings
+		if(!adjacency.IsOpen(from))
+			continue;
+		adjacency.ForEachEdge(from, [&](uInt to, Float cost)
+		{
+			uInt toCluster = clusterOf[to];
+			if(toCluster == cluster)
+				return;
+
+			//seen from the cluster of lower number, across the direction to the other one
+			Bool reversed = toCluster < cluster;
+			const Cluster& lower = reversed ? clusters[toCluster] : current;
+			const Cluster& upper = reversed ? current : clusters[toCluster];
+			Float acrossX = (Float)-(upper.cellY - lower.cellY);
+			Float acrossY = (Float)(upper.cellX - lower.cellX);
+			const Vector3D& fromPosition = adjacency.Position(reversed ? to : from);
+			const Vector3D& toPosition = adjacency.Position(reversed ? from : to);
+
+			Crossing crossing = { toCluster, fromPosition[0] * acrossX + fromPosition[1] * acrossY,
+								  toPosition[0] * acrossX + toPosition[1] * acrossY,
+								  reversed ? to : from, reversed ? from : to, cost, reversed };
+			crossings.push_back(crossing);
+		});
+	}
+	std::sort(crossings.begin(), crossings.end());
+
+	current.transitions.clear();
+	current.neighbours.clear();
+
+	//the transition of a crossing, leaving this cluster
+	auto addTransition = [&](const Crossing& crossing)
+	{
+		Transition transition = { crossing.reversed ? crossing.to : crossing.from,
+								  crossing.reversed ? crossing.from : crossing.to, crossing.cost };
+		current.transitions.push_back(transition);
+	};
+
+	//split each border into stretches whose nodes are next to each other on both sides, and give
+	//each stretch a transition in the middle, or one at each end if it is long
+	uInt first = 0;
+	while(first < crossings.size())
+	{
+		uInt last = first;
+		while(last + 1 < crossings.size() && crossings[last + 1].toCluster == crossings[first].toCluster &&
+			  Next_To(adjacency, crossings[last].from, crossings[last + 1].from) &&
+			  Next_To(adjacency, crossings[last].to, crossings[last + 1].to))
+		{
+			last++;
+		}
+
+		//the length is in nodes; a node can have several connections across
+		uInt length = 1;
+		for(uInt i = first + 1; i <= last; i++)
+		{
+			if(crossings[i].from != crossings[i - 1].from)
+				length++;
+		}
+
+		if(length < longEntrance)
+		{
+			addTransition(crossings[(first + last) / 2]);
+		}
+		else
+		{
+			addTransition(crossings[first]);
+			addTransition(crossings[last]);
+		}
+
+		if(current.neighbours.empty() || current.neighbours.back() != crossings[first].toCluster)
+			current.neighbours.push_back(crossings[first].toCluster);
+
+		first = last + 1;
+	}
+}
+
+Void HierarchicalPathfinder::findEntrances(uInt cluster)
+{
+	Cluster& current = clusters[cluster];
+
+	for(uInt i = 0; i < current.entrances.size(); i++)
+		entranceIndex[current.entrances[i]] = noPathNode;
+	entranceCount -= (uInt)current.entrances.size();
+	current.entrances.clear();
+
+	//the nodes of this cluster at either end of a transition
+	for(uInt t = 0; t < current.transitions.size(); t++)
+	{
+		uInt node = current.transitions[t].from;
+		if(entranceIndex[node] == noPathNode)
+		{
+			entranceIndex[node] = (uInt)current.entrances.size();
+			current.entrances.push_back(node);
+		}
+	}
+
+	for(uInt n = 0; n < current.neighbours.size(); n++)
+	{
+		const Cluster& neighbour = clusters[current.neighbours[n]];
+		for(uInt t = 0; t < neighbour.transitions.size(); t++)
+		{
+			uInt node = neighbour.transitions[t].to;
+			if(clusterOf[node] == cluster && entranceIndex[node] == noPathNode)
+			{
+				entranceIndex[node] = (uInt)current.entrances.size();
+				current.entrances.push_back(node);
+			}
+		}
+	}
+	entranceCount += (uInt)current.entrances.size();
+
+	//the cost between every two entrances, staying inside the cluster
+	uInt entrances = (uInt)current.entrances.size();
+	current.costs.resize(entrances * entrances);
+	for(uInt i = 0; i < entrances; i++)
+	{
+		searchCluster(current.entrances[i], cluster);
+		for(uInt j = 0; j < entrances; j++)
+			current.costs[i * entrances + j] = clusterCost(current.entrances[j]);
+	}
+}
+
+Void HierarchicalPathfinder::searchCluster(uInt source, uInt cluster)
+{
+	ClusterAdjacency adjacency(graph->getAdjacency(), clusterOf.data(), cluster);
+	localContext.Begin(adjacency.NodeCount());
+	IndexedHeap& open = localContext.Open();
+
+	localContext.Record(source).costSoFar = 0;
+	open.Push(source, 0);
+
+	while(!open.Empty())
+	{
+		uInt current = open.Pop();
+		Float currentCost = localContext.Record(current).costSoFar;
+
+		adjacency.ForEachEdge(current, [&](uInt to, Float cost)
+		{
+			NodeRecord& record = localContext.Record(to);
+			if(currentCost + cost >= record.costSoFar)
+				return;
+
+			record.parent = current;
+			record.costSoFar = currentCost + cost;
+			open.Push(to, record.costSoFar);
+		});
+	}
+}
+
+Float HierarchicalPathfinder::clusterCost(uInt target)
+{
+	return localContext.Reached(target) ? localContext.Record(target).costSoFar : FLT_MAX;
+}
+
+
+Bool HierarchicalPathfinder::FindPath(uInt start, uInt goal, const Heuristic& heuristic, HierarchicalPath* path)
+{
+	assert(graph != NULL && start < clusterOf.size() && goal < clusterOf.size());
+	path->waypoints.clear();
+	path->cost = 0;
+
+	//no connection leads into a closed goal, as with Graph::findPath
+	if(goal != start && !graph->getAdjacency().IsOpen(goal))
+	{
+		path->nodesExpanded = 0;
+		path->found = false;
+		return false;
+	}
+
+	//join the start and the goal to the entrances of their clusters
+	const Cluster& startCluster = clusters[clusterOf[start]];
+	const Cluster& goalCluster = clusters[clusterOf[goal]];
+
+	searchCluster(start, clusterOf[start]);
+	startCosts.resize(startCluster.entrances.size());
+	for(uInt j = 0; j < startCluster.entrances.size(); j++)
+		startCosts[j] = clusterCost(startCluster.entrances[j]);
+	startToGoal = clusterOf[start] == clusterOf[goal] ? clusterCost(goal) : FLT_MAX;
+
+	//connections are two way and the goal is open, so the costs from the goal are those to it
+	searchCluster(goal, clusterOf[goal]);
+	goalCosts.resize(goalCluster.entrances.size());
+	for(uInt j = 0; j < goalCluster.entrances.size(); j++)
+		goalCosts[j] = clusterCost(goalCluster.entrances[j]);
+
+	path->found = AStarSearch(AbstractAdjacency(*this, start, goal), start, goal, heuristic, TIE_NEAR_GOAL,
+							  abstractContext, &path->nodesExpanded);
+	if(!path->found)
+		return false;
+
+	path->cost = abstractContext.Record(goal).costSoFar;
+
+	//follow the parents back to the start
+	for(uInt node = goal; node != noPathNode; node = abstractContext.Record(node).parent)
+		path->waypoints.push_back(node);
+	std::reverse(path->waypoints.begin(), path->waypoints.end());
+
+	return true;
+}
+
+Bool HierarchicalPathfinder::RefineSegment(const HierarchicalPath& path, uInt segment, std::vector<uInt>* nodes,
+										   const Heuristic& heuristic)
+{
+	assert(segment + 1 < path.waypoints.size());
+	uInt from = path.waypoints[segment];
+	uInt to = path.waypoints[segment + 1];
+	nodes->clear();
+
+	GraphAdjacency adjacency = graph->getAdjacency();
+
+	//a transition between two clusters is a single connection
+	if(clusterOf[from] != clusterOf[to])
+	{
+		if(!Next_To(adjacency, from, to))
+			return false;
+
+		nodes->push_back(from);
+		nodes->push_back(to);
+		return true;
+	}
+
+	//otherwise the route inside the cluster
+	if(!AStarSearch(ClusterAdjacency(adjacency, clusterOf.data(), clusterOf[from]), from, to, heuristic, TIE_NEAR_GOAL,
+					localContext, NULL))
+	{
+		return false;
+	}
+
+	for(uInt node = to; node != noPathNode; node = localContext.Record(node).parent)
+		nodes->push_back(node);
+	std::reverse(nodes->begin(), nodes->end());
+
+	return true;
+}
+
+Bool HierarchicalPathfinder::Refine(const HierarchicalPath& path, std::vector<uInt>* nodes, const Heuristic& heuristic)
+{
+	nodes->clear();
+	if(path.waypoints.empty())
+		return false;
+
+	nodes->push_back(path.waypoints[0]);
+	for(uInt segment = 0; segment + 1 < path.waypoints.size(); segment++)
+	{
+		if(!RefineSegment(path, segment, &segmentNodes, heuristic))
+			return false;
+
+		//each segment starts where the last one ended
+		nodes->insert(nodes->end(), segmentNodes.begin() + 1, segmentNodes.end());
+	}
+
+	return true;
+}
@@ -0,0 +1,161 @@
+#ifndef _HIERARCHICALPATHFINDER_H_
+#define _HIERARCHICALPATHFINDER_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "Graph.h"
+
+
+//Structure holding a path found by HierarchicalPathfinder
+struct HierarchicalPath
+{
+public:
+	//the nodes the path goes through at the abstract level: the start, the entrances it crosses
+	//clusters at, and the goal. Each pair next to each other is a segment, refined on demand
+	std::vector<uInt> waypoints;
+	//the total cost of the path
+	Float cost;
+	//how many nodes of the abstract graph were expanded
+	uInt nodesExpanded;
+	//true if a path was found
+	Bool found;
+
+	//Constructor
+	//an empty path
+	HierarchicalPath();
+};
+
+
+//Class HierarchicalPathfinder
+//Hierarchical path finding (HPA*) over a Graph, for long paths on big graphs.
+//The nodes are split into square clusters by their positions. Where the connections between two
+//neighbouring clusters form a stretch of border, one or two of them become transitions and their
+//nodes entrances; the costs between the entrances of each cluster are worked out once. A search
+//then only looks at the start, the goal and the entrances: an abstract graph that is a small part
+//of the real one. The path it finds is a list of waypoints, and each segment between two of them
+//is turned into real nodes with RefineSegment only when it is needed; an agent usually only needs
+//the next one.
+//Paths are close to, but not always, the cheapest, since routes inside a cluster only go between
+//its entrances. Connections must be two way with the same cost both ways, as Graph makes them.
+//When connections change, RebuildCluster brings the clusters they touch up to date; adding
+//nodes needs a new Build.
+class HierarchicalPathfinder
+{
+public:
+	//Constructor
+	//creates a pathfinder with no graph
+	HierarchicalPathfinder();
+
+	//Build()
+	//return type: Void
+	//parameters : const Graph&, Float
+	//splits the nodes of graph into clusters clusterSize across (in x and y) and builds the abstract
+	//graph. The graph must outlive the pathfinder
+	Void Build(const Graph& graph, Float clusterSize);
+
+	//RebuildCluster()
+	//return type: Void
+	//parameters : uInt
+	//after connections inside a cluster or between it and its neighbours have changed, finds its
+	//transitions and entrance costs again, and those of its neighbours
+	Void RebuildCluster(uInt cluster);
+
+	//ClusterCount()
+	//return type: uInt
+	//parameters : none
+	//returns the number of clusters
+	uInt ClusterCount() const;
+
+	//ClusterOf()
+	//return type: uInt
+	//parameters : uInt
+	//returns the cluster a node is in
+	uInt ClusterOf(uInt node) const;
+
+	//EntranceCount()
+	//return type: uInt
+	//parameters : none
+	//returns the number of entrances of all clusters, the size of the abstract graph
+	uInt EntranceCount() const;
+
+
+	/////////////////////////////////////////////////////////////////////
+	//FindPath()
+	//return type: Bool
+	//parameters : uInt, uInt, const Heuristic&, HierarchicalPath*
+	//finds the waypoints of a path from the node start to the node goal, using heuristic to guide the
+	//search of the abstract graph. Returns true and fills out path if a path was found, false if it wasn't;
+	//as with Graph::findPath there is none to a closed goal
+	Bool FindPath(uInt start, uInt goal, const Heuristic& heuristic, HierarchicalPath* path);
+
+	//RefineSegment()
+	//return type: Bool
+	//parameters : const HierarchicalPath&, uInt, std::vector<uInt>*, const Heuristic&
+	//fills out nodes with the real nodes from path.waypoints[segment] to path.waypoints[segment + 1],
+	//both included. Returns false if the graph has changed so that the segment can not be followed
+	Bool RefineSegment(const HierarchicalPath& path, uInt segment, std::vector<uInt>* nodes,
+					   const Heuristic& heuristic = Heuristic());
+
+	//Refine()
+	//return type: Bool
+	//parameters : const HierarchicalPath&, std::vector<uInt>*, const Heuristic&
+	//fills out nodes with every real node of path, for when the whole path is needed at once
+	Bool Refine(const HierarchicalPath& path, std::vector<uInt>* nodes, const Heuristic& heuristic = Heuristic());
+
+private:
+	friend struct AbstractAdjacency;
+
+	//a connection between two clusters that the abstract graph uses
+	struct Transition
+	{
+		uInt from;
+		uInt to;
+		Float cost;
+	};
+
+	struct Cluster
+	{
+		//the cell of the cluster
+		Int cellX, cellY;
+		std::vector<uInt> nodes;
+		//the nodes on the border that paths enter and leave by
+		std::vector<uInt> entrances;
+		//cost from entrance i to entrance j at [i * entrances + j], FLT_MAX if there is no route inside the cluster
+		std::vector<Float> costs;
+		//transitions leaving the cluster
+		std::vector<Transition> transitions;
+		//the clusters it has transitions with
+		std::vector<uInt> neighbours;
+	};
+
+	//finds the transitions of cluster
+	Void findTransitions(uInt cluster);
+	//finds the entrances of cluster from the transitions and the costs between them
+	Void findEntrances(uInt cluster);
+	//runs Dijkstra from source over the nodes of cluster, leaving the costs in localContext
+	Void searchCluster(uInt source, uInt cluster);
+	//the cost from source to target found by the last searchCluster, FLT_MAX if it was not reached
+	Float clusterCost(uInt target);
+
+	const Graph* graph;
+	Float clusterSize;
+
+	std::vector<Cluster> clusters;
+	//per node: its cluster, and its index in the entrances of the cluster or noPathNode
+	std::vector<uInt> clusterOf;
+	std::vector<uInt> entranceIndex;
+	uInt entranceCount;
+
+	//search state, kept between searches
+	SearchContext abstractContext;
+	SearchContext localContext;
+	//costs from the start of a search to the entrances of its cluster, and from those of the goal's to the goal
+	std::vector<Float> startCosts;
+	std::vector<Float> goalCosts;
+	Float startToGoal;
+	//the nodes of one segment while Refine joins them up
+	std::vector<uInt> segmentNodes;
+};
+
+
+#endif
@@ -0,0 +1,244 @@
+#include "IncrementalPlanner.h"
+#include <cfloat>
+#include <assert.h>
+
+
+namespace
+{
+	//cost plus a cost to the goal that may be FLT_MAX, for no route
+	inline Float Through(Float cost, Float costToGoal)
+	{
+		return costToGoal == FLT_MAX ? FLT_MAX : cost + costToGoal;
+	}
+
+	//compares keys, the first part and then the second
+	inline Bool Key_Less(Float a1, Float a2, Float b1, Float b2)
+	{
+		return a1 < b1 || (a1 == b1 && a2 < b2);
+	}
+}
+
+
+IncrementalPlanner::IncrementalPlanner()
+{
+	graph = NULL;
+	start = goal = lastStart = 0;
+	keyModifier = 0;
+	changesSeen = 0;
+}
+
+Void IncrementalPlanner::Begin(const Graph& graph, uInt start, uInt goal, const Heuristic& heuristic)
+{
+	this->graph = &graph;
+	this->start = start;
+	this->goal = goal;
+	this->heuristic = heuristic;
+	restart();
+}
+
+Void IncrementalPlanner::MoveStart(uInt start)
+{
+	this->start = start;
+}
+
+Bool IncrementalPlanner::FindPath(NodePathResult* result)
+{
+	assert(graph != NULL);
+
+	result->nodes.clear();
+	result->cost = 0;
+	result->nodesExpanded = 0;
+	result->found = false;
+
+	GraphAdjacency adjacency = graph->getAdjacency();
+
+	//nodes added, or changes gone from the log before the search saw them: nothing of it can be trusted
+	if(adjacency.NodeCount() != costToGoal.size() || !graph->getChanges(changesSeen, &changed))
+	{
+		restart();
+		changed.clear();
+	}
+	changesSeen = graph->getChangeCount();
+
+	//the keys already queued were worked out from where the start was then; rather than work them
+	//all out again, lower those still to come by no more than the start has moved
+	if(start != lastStart)
+	{
+		if(heuristic)
+			keyModifier += heuristic(adjacency.Position(lastStart), adjacency.Position(start));
+		lastStart = start;
+	}
+
+	//a changed node changes the costs of going through it, and of its neighbours going to it
+	for(uInt i = 0; i < changed.size(); i++)
+	{
+		recompute(changed[i]);
+		adjacency.ForEachNeighbour(changed[i], [&](uInt to, Float)
+		{
+			recompute(to);
+		});
+	}
+
+	computePath(&result->nodesExpanded);
+
+	if(lookahead[start] == FLT_MAX)
+		return false;
+
+	//down the costs from the start, each time to the neighbour that is cheapest to go on from
+	uInt node = start;
+	result->nodes.push_back(node);
+	while(node != goal)
+	{
+		uInt next = noPathNode;
+		Float best = FLT_MAX;
+		Float nextCost = 0;
+		adjacency.ForEachEdge(node, [&](uInt to, Float cost)
+		{
+			Float total = Through(cost, costToGoal[to]);
+			if(total < best)
+			{
+				best = total;
+				next = to;
+				nextCost = cost;
+			}
+		});
+
+		//a path visits each node once; more steps would mean the costs are wrong
+		if(next == noPathNode || result->nodes.size() > costToGoal.size())
+		{
+			result->nodes.clear();
+			result->cost = 0;
+			return false;
+		}
+
+		result->cost += nextCost;
+		result->nodes.push_back(next);
+		node = next;
+	}
+
+	result->found = true;
+	return true;
+}
+
+Void IncrementalPlanner::restart()
+{
+	uInt nodeCount = graph->getAdjacency().NodeCount();
+	assert(start < nodeCount && goal < nodeCount);
+
+	costToGoal.assign(nodeCount, FLT_MAX);
+	lookahead.assign(nodeCount, FLT_MAX);
+	open.Resize(nodeCount);
+	keyModifier = 0;
+	lastStart = start;
+	changesSeen = graph->getChangeCount();
+
+	lookahead[goal] = 0;
+	open.Push(goal, estimate(goal), 0);
+}
+
+Float IncrementalPlanner::estimate(uInt node) const
+{
+	if(!heuristic)
+		return 0;
+
+	GraphAdjacency adjacency = graph->getAdjacency();
+	return heuristic(adjacency.Position(start), adjacency.Position(node));
+}
+
+Void IncrementalPlanner::queue(uInt node)
+{
+	if(costToGoal[node] != lookahead[node])
+	{
+		Float lower = costToGoal[node] < lookahead[node] ? costToGoal[node] : lookahead[node];
+		open.Push(node, lower + estimate(node) + keyModifier, lower);
+	}
+	else
+	{
+		open.Remove(node);
+	}
+}
+
+Void IncrementalPlanner::recompute(uInt node)
+{
+	if(node != goal)
+	{
+		Float best = FLT_MAX;
+		graph->getAdjacency().ForEachEdge(node, [&](uInt to, Float cost)
+		{
+			Float total = Through(cost, costToGoal[to]);
+			if(total < best)
+				best = total;
+		});
+		lookahead[node] = best;
+	}
+
+	queue(node);
+}
+
+Void IncrementalPlanner::computePath(uInt* expanded)
+{
+	GraphAdjacency adjacency = graph->getAdjacency();
+
+	while(!open.Empty())
+	{
+		//done once nothing queued could lower the cost of the start, and its costs agree
+		Float startLower = costToGoal[start] < lookahead[start] ? costToGoal[start] : lookahead[start];
+		Float startKey = startLower == FLT_MAX ? FLT_MAX : startLower + keyModifier;
+		if(!Key_Less(open.TopKey(), open.TopTie(), startKey, startLower) && lookahead[start] == costToGoal[start])
+			break;
+
+		uInt node = open.Top();
+		Float oldKey = open.TopKey();
+		Float oldTie = open.TopTie();
+
+		Float lower = costToGoal[node] < lookahead[node] ? costToGoal[node] : lookahead[node];
+		Float newKey = lower + estimate(node) + keyModifier;
+
+		//queued before the start moved; put it back where it belongs now
+		if(Key_Less(oldKey, oldTie, newKey, lower))
+		{
+			open.Change(node, newKey, lower);
+			continue;
+		}
+
+		(*expanded)++;
+
+		//nodes that can not be entered are no way to the goal for their neighbours
+		Bool enterable = adjacency.IsOpen(node);
+
+		if(costToGoal[node] > lookahead[node])
+		{
+			//a cheaper way to the goal: settle on it and offer it to the neighbours
+			costToGoal[node] = lookahead[node];
+			open.Remove(node);
+
+			if(enterable)
+				adjacency.ForEachNeighbour(node, [&](uInt from, Float cost)
+				{
+					if(from == goal)
+						return;
+					Float total = cost + costToGoal[node];
+					if(total < lookahead[from])
+					{
+						lookahead[from] = total;
+						queue(from);
+					}
+				});
+		}
+		else
+		{
+			//the way it settled on got dearer: forget it, and let the neighbours that went
+			//through it look for another
+			Float oldCost = costToGoal[node];
+			costToGoal[node] = FLT_MAX;
+
+			recompute(node);
+			if(enterable)
+				adjacency.ForEachNeighbour(node, [&](uInt from, Float cost)
+				{
+					if(from != goal && lookahead[from] == Through(cost, oldCost))
+						recompute(from);
+				});
+		}
+	}
+}
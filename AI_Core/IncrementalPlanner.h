@@ -0,0 +1,82 @@
+#ifndef _INCREMENTALPLANNER_H_
+#define _INCREMENTALPLANNER_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "Graph.h"
+
+
+//Class IncrementalPlanner
+//Keeps a path from one agent to its goal up to date while the graph changes, using D* Lite.
+//The search runs back from the goal and is kept between calls: when connections change cost or
+//nodes are closed or opened through Graph, the next FindPath only repairs the costs the changes
+//reach, instead of searching again from scratch. The agent may move along the path with MoveStart
+//without losing the search either.
+//Connections must be two way with the same cost both ways, as Graph makes them, and the heuristic
+//must never estimate more than the real cost between two nodes, in either direction.
+class IncrementalPlanner
+{
+public:
+	//Constructor
+	//creates a planner with no graph
+	IncrementalPlanner();
+
+	//Begin()
+	//return type: Void
+	//parameters : const Graph&, uInt, uInt, const Heuristic&
+	//forgets any earlier search and plans from the node start to the node goal of graph, guided by
+	//heuristic; an empty heuristic searches like Dijkstra. The graph must outlive the planner
+	Void Begin(const Graph& graph, uInt start, uInt goal, const Heuristic& heuristic = Heuristic());
+
+	//MoveStart()
+	//return type: Void
+	//parameters : uInt
+	//the agent is now at the node start, usually the next node of the last path; the search is kept
+	Void MoveStart(uInt start);
+
+	//FindPath()
+	//return type: Bool
+	//parameters : NodePathResult*
+	//takes in the changes the graph has recorded since the last call, repairs the search and fills out
+	//result with the path from the start to the goal. Returns false if there is none.
+	//result->nodesExpanded counts the nodes this call expanded. If the graph has changed more than
+	//graphChangeLogSize times since the last call, the search starts over
+	Bool FindPath(NodePathResult* result);
+
+	uInt Start() const	{ return start; }
+	uInt Goal() const	{ return goal; }
+
+private:
+	//sets up the search from nothing
+	Void restart();
+	//estimate of the cost between the start and node
+	Float estimate(uInt node) const;
+	//queues node with its key if its costs disagree, takes it off the queue if they agree
+	Void queue(uInt node);
+	//works out the cost to the goal through the best neighbour of node again, and queues it
+	Void recompute(uInt node);
+	//expands nodes until the costs of the start are right
+	Void computePath(uInt* expanded);
+
+	const Graph* graph;
+	Heuristic heuristic;
+	uInt start;
+	uInt goal;
+	//where the start was when the keys of the queue were last worked out, and how much they have
+	//dropped since the search began
+	uInt lastStart;
+	Float keyModifier;
+
+	//per node: the cost to the goal the search settled on, and the one its neighbours give now
+	std::vector<Float> costToGoal;
+	std::vector<Float> lookahead;
+	//nodes whose two costs disagree, keyed by estimated total cost and then their lower cost
+	IndexedHeap open;
+
+	//how many of the graph's changes the search has taken in, and scratch for the new ones
+	uInt changesSeen;
+	std::vector<uInt> changed;
+};
+
+
+#endif
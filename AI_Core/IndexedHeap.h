@@ -0,0 +1,225 @@
+#ifndef _INDEXEDHEAP_H_
+#define _INDEXEDHEAP_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include <assert.h>
+
+
+//Class IndexedHeap
+//Priority queue of ids 0 to Capacity() - 1 with Float keys, smallest key first.
+//It knows where each id sits in the heap, so the key of a queued id can be lowered in
+//O(log n) instead of queuing the id again. Ids with equal keys come out smallest tie first,
+//then in the order they were last pushed or changed.
+//The arrays are kept between uses, so after the first few searches pushing and popping
+//does not allocate.
+class IndexedHeap
+{
+public:
+	//position of the ids that are not queued
+	static const uInt notQueued = 0xFFFFFFFF;
+
+	//Constructor
+	//creates an empty heap with room for no ids
+	IndexedHeap()
+	{
+		sequence = 0;
+	}
+
+	//Resize()
+	//return type: Void
+	//parameters : uInt
+	//empties the heap and makes room for the ids 0 to capacity - 1
+	Void Resize(uInt capacity)
+	{
+		Clear();
+		position.assign(capacity, (uInt)notQueued);
+	}
+
+	//Clear()
+	//return type: Void
+	//parameters : none
+	//empties the heap; costs the number of ids still queued, not the capacity
+	Void Clear()
+	{
+		for(uInt i = 0; i < heap.size(); i++)
+			position[heap[i].id] = notQueued;
+		heap.clear();
+		sequence = 0;
+	}
+
+	uInt Capacity() const	{ return (uInt)position.size(); }
+	uInt Size() const		{ return (uInt)heap.size(); }
+	Bool Empty() const		{ return heap.empty(); }
+
+	//Contains()
+	//return type: Bool
+	//parameters : uInt
+	//returns true if id is queued
+	Bool Contains(uInt id) const
+	{
+		assert(id < Capacity());
+		return position[id] != notQueued;
+	}
+
+	//Key()
+	//return type: Float
+	//parameters : uInt
+	//returns the key of a queued id
+	Float Key(uInt id) const
+	{
+		assert(Contains(id));
+		return heap[position[id]].key;
+	}
+
+	//Top() / TopKey() / TopTie()
+	//the id with the smallest key, its key and its tie; the heap must not be empty
+	uInt Top() const		{ assert(!Empty()); return heap[0].id; }
+	Float TopKey() const	{ assert(!Empty()); return heap[0].key; }
+	Float TopTie() const	{ assert(!Empty()); return heap[0].tie; }
+
+	//Push()
+	//return type: Void
+	//parameters : uInt, Float, Float
+	//queues id with key, or changes its key if it is already queued; tie orders ids with equal keys
+	Void Push(uInt id, Float key, Float tie = 0)
+	{
+		assert(id < Capacity());
+
+		if(position[id] != notQueued)
+		{
+			Change(id, key, tie);
+			return;
+		}
+
+		Entry entry = { key, tie, sequence++, id };
+		heap.push_back(entry);
+		position[id] = (uInt)heap.size() - 1;
+		Sift_Up(position[id]);
+	}
+
+	//Change()
+	//return type: Void
+	//parameters : uInt, Float, Float
+	//changes the key (and tie) of a queued id, up or down
+	Void Change(uInt id, Float key, Float tie = 0)
+	{
+		assert(Contains(id));
+
+		uInt index = position[id];
+		Entry entry = { key, tie, sequence++, id };
+		Bool lower = Before(entry, heap[index]);
+		heap[index] = entry;
+
+		if(lower)
+			Sift_Up(index);
+		else
+			Sift_Down(index);
+	}
+
+	//Pop()
+	//return type: uInt
+	//parameters : none
+	//removes and returns the id with the smallest key
+	uInt Pop()
+	{
+		assert(!Empty());
+
+		uInt id = heap[0].id;
+		Remove_At(0);
+		return id;
+	}
+
+	//Remove()
+	//return type: Void
+	//parameters : uInt
+	//removes id from the heap if it is queued
+	Void Remove(uInt id)
+	{
+		assert(id < Capacity());
+
+		if(position[id] != notQueued)
+			Remove_At(position[id]);
+	}
+
+private:
+	struct Entry
+	{
+		Float key;
+		Float tie;		//orders entries with equal keys
+		uInt order;		//when the entry was pushed or changed, to break the remaining ties
+		uInt id;
+	};
+
+	static Bool Before(const Entry& a, const Entry& b)
+	{
+		if(a.key != b.key)
+			return a.key < b.key;
+		if(a.tie != b.tie)
+			return a.tie < b.tie;
+		return a.order < b.order;
+	}
+
+	Void Place(uInt index, const Entry& entry)
+	{
+		heap[index] = entry;
+		position[entry.id] = index;
+	}
+
+	Void Sift_Up(uInt index)
+	{
+		Entry entry = heap[index];
+		while(index > 0)
+		{
+			uInt parent = (index - 1) / 2;
+			if(!Before(entry, heap[parent]))
+				break;
+			Place(index, heap[parent]);
+			index = parent;
+		}
+		Place(index, entry);
+	}
+
+	Void Sift_Down(uInt index)
+	{
+		Entry entry = heap[index];
+		uInt count = (uInt)heap.size();
+		for(;;)
+		{
+			uInt child = index * 2 + 1;
+			if(child >= count)
+				break;
+			if(child + 1 < count && Before(heap[child + 1], heap[child]))
+				child++;
+			if(!Before(heap[child], entry))
+				break;
+			Place(index, heap[child]);
+			index = child;
+		}
+		Place(index, entry);
+	}
+
+	Void Remove_At(uInt index)
+	{
+		position[heap[index].id] = notQueued;
+
+		Entry last = heap.back();
+		heap.pop_back();
+		if(index == heap.size())
+			return;
+
+		//the last entry fills the hole and moves whichever way it belongs
+		Place(index, last);
+		if(index > 0 && Before(last, heap[(index - 1) / 2]))
+			Sift_Up(index);
+		else
+			Sift_Down(index);
+	}
+
+	std::vector<Entry> heap;
+	std::vector<uInt> position;		//index in heap of each id, or notQueued
+	uInt sequence;
+};
+
+
+#endif
@@ -0,0 +1,347 @@
+#include "JumpPointSearch.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <algorithm>
+#if defined( _MSC_VER )
+	#include <intrin.h>
+#endif
+
+//returned by the scans when there is no jump point
+static const Int noJump = -1;
+
+//cost of a diagonal move; straight moves cost 1
+static const Float diagonalCost = 1.41421356f;
+
+
+namespace
+{
+	//index of the lowest and highest set bit; bits must not be 0
+	inline Int Lowest_Bit(uInt64 bits)
+	{
+#if defined( _MSC_VER )
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return (Int)index;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	inline Int Highest_Bit(uInt64 bits)
+	{
+#if defined( _MSC_VER )
+		unsigned long index;
+		_BitScanReverse64(&index, bits);
+		return (Int)index;
+#else
+		return 63 - __builtin_clzll(bits);
+#endif
+	}
+
+	inline Int Sign(Int value)
+	{
+		return (value > 0) - (value < 0);
+	}
+
+	//cost of the cheapest path between two cells on an open grid
+	inline Float Octile(Int dx, Int dy)
+	{
+		dx = abs(dx);
+		dy = abs(dy);
+		return dx > dy ? (dx - dy) + dy * diagonalCost : (dy - dx) + dx * diagonalCost;
+	}
+
+	//the cells of a grid, by row and position along it
+	struct RowCells
+	{
+		const GridMap& map;
+		Bool operator()(Int row, Int along) const	{ return map.IsWalkable(along, row); }
+	};
+
+	//the cells of a grid, by column and position along it
+	struct ColumnCells
+	{
+		const GridMap& map;
+		Bool operator()(Int column, Int along) const	{ return map.IsWalkable(column, along); }
+	};
+
+	//Scans a line one cell at a time, from along + direction onwards, for the first cell that is the
+	//goal or beside which a turn opens up: a walkable cell on the next line over whose cell behind is
+	//blocked. Returns the position of that cell, or noJump if a blocked cell comes first
+	template <class Cells>
+	Int Scan_Cells(const Cells& cells, Int line, Int along, Int direction, Int goalLine, Int goalAlong)
+	{
+		for(Int at = along + direction; ; at += direction)
+		{
+			if(!cells(line, at))
+				return noJump;
+			if(line == goalLine && at == goalAlong)
+				return at;
+			if((cells(line + 1, at) && !cells(line + 1, at - direction)) ||
+			   (cells(line - 1, at) && !cells(line - 1, at - direction)))
+				return at;
+		}
+	}
+
+	//The same scan along row line of map, 64 cells at a time
+	Int Scan_Blocks(const GridMap& map, Int line, Int along, Int direction, Int goalLine, Int goalAlong)
+	{
+		if(direction > 0)
+		{
+			for(Int first = along + 1; ; first += 64)
+			{
+				uInt64 open = map.Bits(first, line);
+				uInt64 turns = (map.Bits(first, line + 1) & ~map.Bits(first - 1, line + 1)) |
+							   (map.Bits(first, line - 1) & ~map.Bits(first - 1, line - 1));
+				uInt64 stop = ~open | turns;
+				if(line == goalLine && goalAlong >= first && goalAlong < first + 64)
+					stop |= (uInt64)1 << (goalAlong - first);
+
+				//the grid has a blocked cell past its edge, so every row stops
+				if(stop != 0)
+				{
+					Int bit = Lowest_Bit(stop);
+					return ((open >> bit) & 1) ? first + bit : noJump;
+				}
+			}
+		}
+		else
+		{
+			for(Int last = along - 1; ; last -= 64)
+			{
+				Int first = last - 63;
+				uInt64 open = map.Bits(first, line);
+				uInt64 turns = (map.Bits(first, line + 1) & ~map.Bits(first + 1, line + 1)) |
+							   (map.Bits(first, line - 1) & ~map.Bits(first + 1, line - 1));
+				uInt64 stop = ~open | turns;
+				if(line == goalLine && goalAlong >= first && goalAlong <= last)
+					stop |= (uInt64)1 << (goalAlong - first);
+
+				if(stop != 0)
+				{
+					Int bit = Highest_Bit(stop);
+					return ((open >> bit) & 1) ? first + bit : noJump;
+				}
+			}
+		}
+	}
+}
+
+
+JumpPointSearch::JumpPointSearch()
+{
+	map = NULL;
+}
+
+Void JumpPointSearch::SetMap(const GridMap& map)
+{
+	this->map = &map;
+	map.Transpose(&transposed);
+}
+
+Bool JumpPointSearch::FindPath(uInt start, uInt goal, NodePathResult* result, JumpMode mode)
+{
+	return FindPath(start, goal, result, mode, context);
+}
+
+Bool JumpPointSearch::FindPath(uInt start, uInt goal, NodePathResult* result, JumpMode mode,
+							   SearchContext& context) const
+{
+	assert(map != NULL);
+	assert(start < map->CellCount() && goal < map->CellCount());
+
+	result->nodes.clear();
+	result->cost = 0;
+	result->nodesExpanded = 0;
+	result->found = false;
+
+	Int goalX = map->CellX(goal);
+	Int goalY = map->CellY(goal);
+	if(!map->IsWalkable(map->CellX(start), map->CellY(start)) || !map->IsWalkable(goalX, goalY))
+		return false;
+
+	context.Begin(map->CellCount());
+	IndexedHeap& open = context.Open();
+
+	NodeRecord& startRecord = context.Record(start);
+	startRecord.costSoFar = 0;
+	startRecord.estimate = Octile(goalX - map->CellX(start), goalY - map->CellY(start));
+	open.Push(start, startRecord.estimate);
+
+	uInt expanded = 0;
+	while(!open.Empty())
+	{
+		uInt current = open.Pop();
+		NodeRecord& currentRecord = context.Record(current);
+		currentRecord.closed = true;
+
+		if(current == goal)
+		{
+			result->found = true;
+			break;
+		}
+
+		expanded++;
+		Int x = map->CellX(current);
+		Int y = map->CellY(current);
+		Float currentCost = currentRecord.costSoFar;
+
+		//the directions worth leaving in: all of them from the start; otherwise on along the way in,
+		//and, going straight, to either side where the cell beside the one behind is blocked
+		Int directions[8][2];
+		uInt directionCount = 0;
+		if(currentRecord.parent == noPathNode)
+		{
+			for(Int dy = -1; dy <= 1; dy++)
+				for(Int dx = -1; dx <= 1; dx++)
+					if(dx != 0 || dy != 0)
+					{
+						directions[directionCount][0] = dx;
+						directions[directionCount][1] = dy;
+						directionCount++;
+					}
+		}
+		else
+		{
+			Int dx = Sign(x - map->CellX(currentRecord.parent));
+			Int dy = Sign(y - map->CellY(currentRecord.parent));
+
+			directions[0][0] = dx;
+			directions[0][1] = dy;
+			directionCount = 1;
+			if(dx != 0 && dy != 0)
+			{
+				directions[1][0] = dx;
+				directions[1][1] = 0;
+				directions[2][0] = 0;
+				directions[2][1] = dy;
+				directionCount = 3;
+			}
+			else
+			{
+				for(Int side = -1; side <= 1; side += 2)
+				{
+					Bool turn = dx != 0 ? !map->IsWalkable(x - dx, y + side) : !map->IsWalkable(x + side, y - dy);
+					if(!turn)
+						continue;
+
+					directions[directionCount][0] = dx != 0 ? 0 : side;
+					directions[directionCount][1] = dx != 0 ? side : 0;
+					directionCount++;
+					directions[directionCount][0] = dx != 0 ? dx : side;
+					directions[directionCount][1] = dx != 0 ? side : dy;
+					directionCount++;
+				}
+			}
+		}
+
+		for(uInt d = 0; d < directionCount; d++)
+		{
+			Int jumpX, jumpY;
+			if(!jump(x, y, directions[d][0], directions[d][1], mode, goalX, goalY, &jumpX, &jumpY))
+				continue;
+
+			uInt to = map->Cell(jumpX, jumpY);
+			NodeRecord& record = context.Record(to);
+
+			Float costSoFar = currentCost + Octile(jumpX - x, jumpY - y);
+			if(costSoFar >= record.costSoFar)
+				continue;
+
+			if(record.costSoFar == FLT_MAX)
+				record.estimate = Octile(goalX - jumpX, goalY - jumpY);
+
+			record.parent = current;
+			record.costSoFar = costSoFar;
+			record.closed = false;
+			open.Push(to, costSoFar + record.estimate, -costSoFar);
+		}
+	}
+
+	result->nodesExpanded = expanded;
+	if(!result->found)
+		return false;
+
+	result->cost = context.Record(goal).costSoFar;
+	for(uInt cell = goal; cell != noPathNode; cell = context.Record(cell).parent)
+		result->nodes.push_back(cell);
+	std::reverse(result->nodes.begin(), result->nodes.end());
+
+	return true;
+}
+
+Void JumpPointSearch::ExpandPath(const std::vector<uInt>& jumpPoints, std::vector<uInt>* cells) const
+{
+	cells->clear();
+	if(jumpPoints.empty())
+		return;
+
+	cells->push_back(jumpPoints[0]);
+	for(uInt i = 1; i < jumpPoints.size(); i++)
+	{
+		Int x = map->CellX(jumpPoints[i - 1]);
+		Int y = map->CellY(jumpPoints[i - 1]);
+		Int toX = map->CellX(jumpPoints[i]);
+		Int toY = map->CellY(jumpPoints[i]);
+		Int dx = Sign(toX - x);
+		Int dy = Sign(toY - y);
+		assert(dx == 0 || dy == 0 || abs(toX - x) == abs(toY - y));
+
+		while(x != toX || y != toY)
+		{
+			x += dx;
+			y += dy;
+			cells->push_back(map->Cell(x, y));
+		}
+	}
+}
+
+Int JumpPointSearch::jumpStraight(Int x, Int y, Int dx, Int dy, JumpMode mode, Int goalX, Int goalY) const
+{
+	//columns are scanned as rows of the grid turned on its side
+	if(dy == 0)
+	{
+		if(mode == JUMP_BLOCKS)
+			return Scan_Blocks(*map, y, x, dx, goalY, goalX);
+		RowCells cells = { *map };
+		return Scan_Cells(cells, y, x, dx, goalY, goalX);
+	}
+
+	if(mode == JUMP_BLOCKS)
+		return Scan_Blocks(transposed, x, y, dy, goalX, goalY);
+	ColumnCells cells = { *map };
+	return Scan_Cells(cells, x, y, dy, goalX, goalY);
+}
+
+Bool JumpPointSearch::jump(Int x, Int y, Int dx, Int dy, JumpMode mode, Int goalX, Int goalY,
+						   Int* jumpX, Int* jumpY) const
+{
+	if(dx == 0 || dy == 0)
+	{
+		Int along = jumpStraight(x, y, dx, dy, mode, goalX, goalY);
+		if(along == noJump)
+			return false;
+
+		*jumpX = dx != 0 ? along : x;
+		*jumpY = dx != 0 ? y : along;
+		return true;
+	}
+
+	//diagonally, one cell at a time, stopping where a straight scan either way finds a jump point
+	for(;;)
+	{
+		if(!map->IsWalkable(x + dx, y + dy) || !map->IsWalkable(x + dx, y) || !map->IsWalkable(x, y + dy))
+			return false;
+
+		x += dx;
+		y += dy;
+		if((x == goalX && y == goalY) ||
+		   jumpStraight(x, y, dx, 0, mode, goalX, goalY) != noJump ||
+		   jumpStraight(x, y, 0, dy, mode, goalX, goalY) != noJump)
+		{
+			*jumpX = x;
+			*jumpY = y;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef _JUMPPOINTSEARCH_H_
+#define _JUMPPOINTSEARCH_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "GridMap.h"
+#include "PathSearch.h"
+
+
+//How JumpPointSearch scans along rows and columns
+enum JumpMode
+{
+	//one cell at a time
+	JUMP_CELLS,
+	//64 cells at a time, from the bits of the grid
+	JUMP_BLOCKS
+};
+
+
+//Class JumpPointSearch
+//Finds paths over a GridMap where each cell connects to its 8 neighbours, straight moves costing 1
+//and diagonal ones the square root of 2. A diagonal move needs both cells beside it to be walkable,
+//so paths never cut corners.
+//Jump point search is A* that does not queue every cell it reaches: from a cell it scans straight
+//or diagonally until something could make a turn there worth taking, and only queues that cell,
+//the jump point. The paths cost the same as those Dijkstra finds over the same grid.
+//With JUMP_BLOCKS a scan reads 64 cells of a row at once; columns are scanned on a copy of the grid
+//turned on its side, which SetMap makes, so the grid takes 2 bits per cell in that mode.
+class JumpPointSearch
+{
+public:
+	//Constructor
+	//creates a search with no grid
+	JumpPointSearch();
+
+	//SetMap()
+	//return type: Void
+	//parameters : const GridMap&
+	//sets the grid to search. The grid must outlive the search, and SetMap must be called again
+	//after cells of it change
+	Void SetMap(const GridMap& map);
+
+	//FindPath()
+	//return type: Bool
+	//parameters : uInt, uInt, NodePathResult*, JumpMode
+	//finds a path from the cell start to the cell goal. Returns true and fills out result->nodes with
+	//the jump points of the path, start and goal included, and result->cost, false if there is no path
+	//or either cell is blocked; result->nodesExpanded is filled out either way. Uses the context of
+	//the search, so only one thread may call it at a time
+	Bool FindPath(uInt start, uInt goal, NodePathResult* result, JumpMode mode = JUMP_BLOCKS);
+
+	//FindPath()
+	//return type: Bool
+	//parameters : uInt, uInt, NodePathResult*, JumpMode, SearchContext&
+	//the same, keeping the search state in context
+	Bool FindPath(uInt start, uInt goal, NodePathResult* result, JumpMode mode, SearchContext& context) const;
+
+	//ExpandPath()
+	//return type: Void
+	//parameters : const std::vector<uInt>&, std::vector<uInt>*
+	//fills out cells with every cell of a path from its jump points, each pair of which lies on a
+	//straight or diagonal line
+	Void ExpandPath(const std::vector<uInt>& jumpPoints, std::vector<uInt>* cells) const;
+
+private:
+	//scans from x, y along dx, dy, one of them 0, for a jump point. Returns its position along the
+	//row or column, or noJump
+	Int jumpStraight(Int x, Int y, Int dx, Int dy, JumpMode mode, Int goalX, Int goalY) const;
+	//scans from x, y along dx, dy for a jump point; returns false if there is none
+	Bool jump(Int x, Int y, Int dx, Int dy, JumpMode mode, Int goalX, Int goalY, Int* jumpX, Int* jumpY) const;
+
+	const GridMap* map;
+	//the grid turned on its side, so columns can be scanned as rows
+	GridMap transposed;
+
+	//search state of FindPath when it is not given a context, kept between searches
+	SearchContext context;
+};
+
+
+#endif
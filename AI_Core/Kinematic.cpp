@@ -1,227 +1,184 @@
 #include "Kinematic.h"
-#include <time.h>
+#include <atomic>
+#include "Random.h"
+
+//stream given to the next Kinematic constructed
+static std::atomic<uInt64> nextStream(0);
 
 Kinematic::Kinematic()
 {
-	position.Zero_Vector();
-	rotation = 0;
-	target.Zero_Vector();
-	maxSpeed = 0;
-	slowRadius = 0;
-	wanderRotation = 0;
+	createBatch(Vector2D(), 0, Vector2D(), 0, 0, 0);
 }
 
 Kinematic::~Kinematic()
 {
+	if(ownsBatch)
+		delete batch;
 }
 
 Kinematic::Kinematic(Vector2D position, Float rotation, Vector2D target, Float maxSpeed, Float slowRadius, Float wanderRadius)
 {
-	this->position = position;
-	this->rotation = rotation;
-	this->target = target;
-	this->maxSpeed = maxSpeed;
-	this->slowRadius = slowRadius;
-	this->wanderRotation = wanderRadius;
+	createBatch(position, rotation, target, maxSpeed, slowRadius, wanderRadius);
 }
 
 
 Kinematic::Kinematic(Vector2D position, Float rotation)
 {
-	this->position = position;
-	this->rotation = rotation;
-
-	target.Zero_Vector();
-	maxSpeed = 1;
-	slowRadius = 0;
-	wanderRotation = 0;
+	createBatch(position, rotation, Vector2D(), 1, 0, 0);
 }
 
 Kinematic::Kinematic(Vector2D position, Vector2D target)
 {
-	this->position = position;
-	this->target = target;
-
-	rotation = 0;
-	target.Zero_Vector();
-	maxSpeed = 1;
-	slowRadius = 0;
-	wanderRotation = 0;
+	createBatch(position, 0, target, 1, 0, 0);
 }
 
 
 Kinematic::Kinematic(Vector2D position, Float rotation, Float wanderRadius)
 {
-	this->position = position;
-	this->rotation = rotation;
-	this->wanderRotation = wanderRadius;
+	createBatch(position, rotation, Vector2D(), 1, 0, wanderRadius);
+}
 
-	target.Zero_Vector();
-	maxSpeed = 1;
-	slowRadius = 0;
+Kinematic::Kinematic(KinematicBatch& batch, uInt slot)
+{
+	this->batch = &batch;
+	this->slot = slot;
+	ownsBatch = false;
+}
+
+Kinematic::Kinematic(const Kinematic& other)
+{
+	batch = other.ownsBatch ? new KinematicBatch(*other.batch) : other.batch;
+	slot = other.slot;
+	ownsBatch = other.ownsBatch;
+}
+
+Kinematic& Kinematic::operator =(const Kinematic& other)
+{
+	if(this != &other)
+	{
+		KinematicBatch* copy = other.ownsBatch ? new KinematicBatch(*other.batch) : other.batch;
+		if(ownsBatch)
+			delete batch;
+
+		batch = copy;
+		slot = other.slot;
+		ownsBatch = other.ownsBatch;
+	}
+	return *this;
+}
+
+Void Kinematic::createBatch(Vector2D position, Float rotation, Vector2D target, Float maxSpeed, Float slowRadius, Float wanderRotation)
+{
+	batch = new KinematicBatch();
+	slot = batch->Add(position, rotation, target, maxSpeed, slowRadius, wanderRotation);
+	ownsBatch = true;
+	batch->setRandomSeed(slot, Random::default_seed, nextStream++);
 }
 
 
 Vector2D Kinematic::Position()
 {
-	return position;
+	return batch->Position(slot);
 }
 
 Float Kinematic::Rotation()
 {
-	return rotation;
+	return batch->Rotation(slot);
 }
 
 Vector2D Kinematic::Target()
 {
-	return target;
+	return batch->Target(slot);
 }
 
 Float Kinematic::MaxSpeed()
 {
-	return maxSpeed;
+	return batch->MaxSpeed(slot);
 }
 
 Float Kinematic::SlowRadius()
 {
-	return slowRadius;
+	return batch->SlowRadius(slot);
 }
 
 Float Kinematic::WanderRotation()
 {
-	return wanderRotation;
+	return batch->WanderRotation(slot);
+}
+
+Bool Kinematic::FastTrig()
+{
+	return batch->FastTrig();
+}
+
+KinematicBatch& Kinematic::Batch()
+{
+	return *batch;
+}
+
+uInt Kinematic::Slot()
+{
+	return slot;
 }
 
 
 
 Void Kinematic::setPosition(Vector2D position)
 {
-	this->position = position;
+	batch->setPosition(slot, position);
 }
 
 Void Kinematic::setRotation(Float rotation)
 {
-	this->rotation = rotation;
+	batch->setRotation(slot, rotation);
 }
 
-Void Kinematic::setTarget(Vector2D target)	
+Void Kinematic::setTarget(Vector2D target)
 {
-	this->target = target;
+	batch->setTarget(slot, target);
 }
 
 Void Kinematic::setMaxSpeed(Float maxSpeed)
 {
-	this->maxSpeed = maxSpeed;
+	batch->setMaxSpeed(slot, maxSpeed);
 }
 
 Void Kinematic::setSlowRadius(Float radius)
 {
-	this->slowRadius = slowRadius;
+	batch->setSlowRadius(slot, radius);
 }
 
 Void Kinematic::setWanderRotation(Float radius)
 {
-	this->wanderRotation = wanderRotation;
+	batch->setWanderRotation(slot, radius);
 }
 
-
-
-SteeringOutput Kinematic::Seek()
+Void Kinematic::setFastTrig(Bool fast)
 {
-	//Create structure for output
-	SteeringOutput steering;
-
-	// Get direction of target
-	steering.linearVel = target - position;
-
-	// Set velocity 
-	if(steering.linearVel.Length() == 0)
-	{
-		steering.linearVel = 0;
-	}
-	else if(steering.linearVel.Length() < slowRadius)
-	{
-		steering.linearVel.Normalize();
-		steering.linearVel *= maxSpeed/2.0f;
-	} 
-	else
-	{
-		steering.linearVel.Normalize();
-		steering.linearVel *= maxSpeed;
-	}
-
-	// Face in the direction we want to move
-	rotation = atan2(-steering.linearVel[0], steering.linearVel[1]);
-
-	// Output the steering
-	steering.angularVel = 0;
-
-	return steering;
+	batch->setFastTrig(fast);
 }
 
-SteeringOutput Kinematic::Flee()
+Void Kinematic::setRandomSeed(uInt64 seed, uInt64 stream)
 {
-	//Create structure for output
-	SteeringOutput steering;
-
-	// Get direction of target
-	steering.linearVel = position - target;
-
-	// Set velocity 
-		steering.linearVel.Normalize();
-		steering.linearVel *= maxSpeed;
-	
-
-	// Face in the direction we want to move
-	rotation = -1*atan2(-steering.linearVel[0], steering.linearVel[1]);
-
-	// Output the steering
-	steering.angularVel = 0;
-
-	return steering;
+	batch->setRandomSeed(slot, seed, stream);
 }
 
-SteeringOutput Kinematic::Wander()
-{
-	//Create structure for output
-	SteeringOutput steering;
-	
-	// gets the character orientation as a vector
-	Vector2D charOrientation;
-	charOrientation[0] = sin(rotation);
-	charOrientation[1] = cos(rotation);
 
-	//Get velocity from the vector form of the orientation
-	steering.linearVel = maxSpeed * charOrientation;
 
-	// Change orientation randomly
-	steering.angularVel = randomBinomial() * wanderRotation;
-
-	// Output steering
-	return steering;
+SteeringOutput Kinematic::Seek()
+{
+	batch->SeekRange(slot, slot + 1);
+	return batch->Output(slot);
 }
 
-
-//Returns a number between -1 and 1
-float Kinematic::randomBinomial()
+SteeringOutput Kinematic::Flee()
 {
-
-	return random() - random();
+	batch->FleeRange(slot, slot + 1);
+	return batch->Output(slot);
 }
 
-// Returns a number between 0 and 1
-float Kinematic::random()
+SteeringOutput Kinematic::Wander()
 {
-		srand((unsigned int)time(NULL));
-		int a  = rand();
-		srand((unsigned int)time(NULL));
-		int b  = rand();
-
-		float c;
-		if( a > b)
-			c = (float)b/(float)a;
-		else
-			c = (float)a/(float)b;
-
-		return c;
-}
\ No newline at end of file
+	batch->WanderRange(slot, slot + 1);
+	return batch->Output(slot);
+}
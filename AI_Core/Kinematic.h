@@ -2,51 +2,26 @@
 #define _KINEMATIC_H_
 
 #include "Typedefs.h"
-#include "Vector2D.h"
-
-
-//Sturcture that is returned from the kinematic behaviors
-//contains the linear Velocity and angular velocity to be applied to the object
-struct SteeringOutput
-{
-public:
-	//Linear Velocity
-	Vector2D linearVel;
-	//Angular Velocity
-	float angularVel;
-
-	//overload operator += for SteeringOutput
-	SteeringOutput operator +=(SteeringOutput steering)
-	{
-		this->linearVel += steering.linearVel;
-		this->angularVel += steering.angularVel ;
-		return *this;
-	}
-};
+#include "CoreMathPhysics.h"
+#include "KinematicBatch.h"
 
 
 //Class Kinematic
 //used for simple kinematic behaviors(Seek, Flee, Wander)
+//A Kinematic is a view of one slot of a KinematicBatch. The constructors that take the
+//state create a batch for the object alone; to steer many agents, keep them in one
+//KinematicBatch and use Kinematic(batch, slot) where one agent needs to be handled on its own
 class Kinematic
 {
 private:
-	//Current position
-	Vector2D position;
-	//Current rotation
-	Float rotation;
-	//Target to seek/flee
-	Vector2D target;
-	//Max Speed to travel
-	Float maxSpeed;
-	//How close to target should the object start to slow
-	Float slowRadius;
-	//angle of rotation to wander
-	Float wanderRotation;
-
-	//used to find a random number (0,1)
-	Float random();
-	//used to find a random number (-1,1)
-	Float randomBinomial();
+	//the batch holding the state of this object, and its slot there
+	KinematicBatch* batch;
+	uInt slot;
+	//true if the batch was created for this object alone
+	Bool ownsBatch;
+
+	//creates a batch for this object alone
+	Void createBatch(Vector2D position, Float rotation, Vector2D target, Float maxSpeed, Float slowRadius, Float wanderRotation);
 
 public:
 	//Empty constructor
@@ -78,6 +53,16 @@ public:
 	Kinematic(Vector2D position,
 			  Float rotation,
 			  Float wanderRadius);
+	//Constuctor
+	//parameters: KinematicBatch&, uInt)
+	//views the agent in slot of batch; the batch must outlive the object
+	Kinematic(KinematicBatch& batch,
+			  uInt slot);
+	//Copy constructor and assignment
+	//a Kinematic with its own batch copies it, including the state of the random numbers;
+	//a view of a shared batch copies the view
+	Kinematic(const Kinematic& other);
+	Kinematic& operator =(const Kinematic& other);
 
 	
 	/////////////////////////////////////////////////////////////////////
@@ -117,6 +102,24 @@ public:
 	//returns the rotation of the wander
 	Float WanderRotation();
 
+	//FastTrig()
+	//return type: Bool
+	//parameters : none
+	//returns true if the behaviors use the FastMath approximations
+	Bool FastTrig();
+
+	//Batch()
+	//return type: KinematicBatch&
+	//parameters : none
+	//returns the batch holding the state
+	KinematicBatch& Batch();
+
+	//Slot()
+	//return type: uInt
+	//parameters : none
+	//returns the slot in Batch()
+	uInt Slot();
+
 
 	/////////////////////////////////////////////////////////////////////
 	//setPosition()
@@ -156,6 +159,23 @@ public:
 	//sets the angle to wander
 	Void setWanderRotation(Float angle);
 
+	//setFastTrig()
+	//return type: none
+	//parameters : Bool
+	//use the FastMath approximations of atan2, sin and cos in the behaviors;
+	//the headings they produce are within 3e-7 radians of the exact ones.
+	//This is a setting of the batch, so it applies to every agent in a shared batch
+	Void setFastTrig(Bool fast);
+
+	//setRandomSeed()
+	//return type: none
+	//parameters : uInt64, uInt64
+	//restarts the random numbers used by Wander. By default each Kinematic with its own batch
+	//gets the next stream of Random::default_seed in the order they are constructed, and an
+	//agent added to a KinematicBatch gets the stream of its slot; give agents fixed
+	//streams (e.g. their ids) to get the same wandering however the updates are scheduled
+	Void setRandomSeed(uInt64 seed, uInt64 stream);
+
 
 	/////////////////////////////////////////////////////////////////////
 	//Seek()
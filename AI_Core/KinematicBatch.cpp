@@ -0,0 +1,504 @@
+#include "KinematicBatch.h"
+#include <assert.h>
+#include "FastMath.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "FlowField.h"
+
+//batches smaller than this are not worth splitting across threads
+static const uInt steeringGrain = 2048;
+
+
+struct KinematicBatch::Arrays
+{
+	Float* positionX;
+	Float* positionY;
+	Float* rotation;
+	const Float* targetX;
+	const Float* targetY;
+	const Float* maxSpeed;
+	const Float* slowRadius;
+	const Float* wanderRotation;
+	uInt* randomState[4];
+	Float* linearX;
+	Float* linearY;
+	Float* angular;
+	Float timeToTarget;
+};
+
+KinematicBatch::Arrays KinematicBatch::Get_Arrays()
+{
+	Arrays a;
+	a.positionX = positionX.data();
+	a.positionY = positionY.data();
+	a.rotation = rotation.data();
+	a.targetX = targetX.data();
+	a.targetY = targetY.data();
+	a.maxSpeed = maxSpeed.data();
+	a.slowRadius = slowRadius.data();
+	a.wanderRotation = wanderRotation.data();
+	for(Int word = 0; word < 4; word++)
+		a.randomState[word] = randomState[word].data();
+	a.linearX = linearX.data();
+	a.linearY = linearY.data();
+	a.angular = angular.data();
+	a.timeToTarget = 0;
+	return a;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//The trig functions the kernels use.
+//ExactTrig calls atan2, sin and cos one agent at a time, ApproxTrig runs the FastMath kernels
+//on whole lanes
+namespace
+{
+	struct ExactTrig
+	{
+		static Float Atan2(Float y, Float x)
+		{
+			return atan2(y, x);
+		}
+
+		static Void SinCos(Float angle, Float& s, Float& c)
+		{
+			s = sin(angle);
+			c = cos(angle);
+		}
+	};
+
+	template<class L>
+	struct ApproxTrig
+	{
+		static typename L::V Atan2(typename L::V y, typename L::V x)
+		{
+			return FastMath::Atan2Kernel<L>(y, x);
+		}
+
+		static Void SinCos(typename L::V angle, typename L::V& s, typename L::V& c)
+		{
+			FastMath::SinCosKernel<L>(angle, s, c);
+		}
+	};
+
+
+	/////////////////////////////////////////////////////////////////////
+	//The behaviors, for the L::width agents starting at i.
+	//Every width computes the same thing in the same order, so an agent gets the same
+	//result whichever lane or thread it lands in
+
+	//vector from a to b, and its length
+	template<class L>
+	inline Void Offset(const Float* ax, const Float* ay, const Float* bx, const Float* by, uInt i,
+					   typename L::V& x, typename L::V& y, typename L::V& length)
+	{
+		x = L::Sub(L::Load(bx + i), L::Load(ax + i));
+		y = L::Sub(L::Load(by + i), L::Load(ay + i));
+		length = L::Sqrt(L::Add(L::Mul(x, x), L::Mul(y, y)));
+	}
+
+	struct SeekKernel
+	{
+		template<class L, class T>
+		static Void Run(const KinematicBatch::Arrays& a, uInt i);
+	};
+
+	struct FleeKernel
+	{
+		template<class L, class T>
+		static Void Run(const KinematicBatch::Arrays& a, uInt i);
+	};
+
+	struct WanderKernel
+	{
+		template<class L, class T>
+		static Void Run(const KinematicBatch::Arrays& a, uInt i);
+	};
+
+	struct ArriveKernel
+	{
+		template<class L, class T>
+		static Void Run(const KinematicBatch::Arrays& a, uInt i);
+	};
+}
+
+template<class L, class T>
+Void SeekKernel::Run(const KinematicBatch::Arrays& a, uInt i)
+{
+	typedef typename L::V V;
+	V x, y, distance;
+	Offset<L>(a.positionX, a.positionY, a.targetX, a.targetY, i, x, y, distance);
+
+	//full speed, or half speed inside slowRadius; scaling by speed / distance normalizes
+	//and sets the speed in one pass
+	V zero = L::Splat(0);
+	V speed = L::Load(a.maxSpeed + i);
+	speed = L::Select(L::Less(distance, L::Load(a.slowRadius + i)), L::Mul(speed, L::Splat(0.5f)), speed);
+	typename L::Mask arrived = L::Equal(distance, zero);
+	V scale = L::Select(arrived, zero, L::Div(speed, L::Select(arrived, L::Splat(1), distance)));
+
+	x = L::Mul(x, scale);
+	y = L::Mul(y, scale);
+	L::Store(a.linearX + i, x);
+	L::Store(a.linearY + i, y);
+	L::Store(a.angular + i, zero);
+
+	//face in the direction we want to move
+	L::Store(a.rotation + i, T::Atan2(L::Sub(zero, x), y));
+}
+
+template<class L, class T>
+Void FleeKernel::Run(const KinematicBatch::Arrays& a, uInt i)
+{
+	typedef typename L::V V;
+	V x, y, distance;
+	Offset<L>(a.targetX, a.targetY, a.positionX, a.positionY, i, x, y, distance);
+
+	V zero = L::Splat(0);
+	typename L::Mask arrived = L::Equal(distance, zero);
+	V scale = L::Select(arrived, zero, L::Div(L::Load(a.maxSpeed + i), L::Select(arrived, L::Splat(1), distance)));
+
+	x = L::Mul(x, scale);
+	y = L::Mul(y, scale);
+	L::Store(a.linearX + i, x);
+	L::Store(a.linearY + i, y);
+	L::Store(a.angular + i, zero);
+
+	L::Store(a.rotation + i, L::Sub(zero, T::Atan2(L::Sub(zero, x), y)));
+}
+
+//expects the random numbers for the turn in angular
+template<class L, class T>
+Void WanderKernel::Run(const KinematicBatch::Arrays& a, uInt i)
+{
+	typedef typename L::V V;
+
+	//the character orientation as a vector
+	V s, c;
+	T::SinCos(L::Load(a.rotation + i), s, c);
+
+	V speed = L::Load(a.maxSpeed + i);
+	L::Store(a.linearX + i, L::Mul(speed, s));
+	L::Store(a.linearY + i, L::Mul(speed, c));
+
+	//change orientation randomly
+	L::Store(a.angular + i, L::Mul(L::Load(a.angular + i), L::Load(a.wanderRotation + i)));
+}
+
+template<class L, class T>
+Void ArriveKernel::Run(const KinematicBatch::Arrays& a, uInt i)
+{
+	typedef typename L::V V;
+	V x, y, distance;
+	Offset<L>(a.positionX, a.positionY, a.targetX, a.targetY, i, x, y, distance);
+
+	//stop inside slowRadius, otherwise cover the distance in timeToTarget, capped at maxSpeed
+	V zero = L::Splat(0);
+	typename L::Mask arrived = L::Or(L::Less(distance, L::Load(a.slowRadius + i)), L::Equal(distance, zero));
+	V capped = L::Div(L::Load(a.maxSpeed + i), L::Select(arrived, L::Splat(1), distance));
+	V scale = L::Select(arrived, zero, L::Min(L::Splat(1.0f / a.timeToTarget), capped));
+
+	x = L::Mul(x, scale);
+	y = L::Mul(y, scale);
+	L::Store(a.linearX + i, x);
+	L::Store(a.linearY + i, y);
+	L::Store(a.angular + i, zero);
+
+	//face in the direction we want to move, or keep facing the same way once stopped
+	V rotation = L::Load(a.rotation + i);
+	L::Store(a.rotation + i, L::Select(arrived, rotation, T::Atan2(L::Sub(zero, x), y)));
+}
+
+//runs the kernel over [begin, end), as wide as the build allows when fast is set
+template<class Kernel>
+static Void Run_Range(const KinematicBatch::Arrays& a, uInt begin, uInt end, Bool fast)
+{
+	uInt i = begin;
+
+	if(fast)
+	{
+#if defined( MATHPHYSICS_AVX )
+		for(; i + 8 <= end; i += 8)
+			Kernel::template Run<FastMath::AVXLanes, ApproxTrig<FastMath::AVXLanes> >(a, i);
+#endif
+#if defined( MATHPHYSICS_SSE )
+		for(; i + 4 <= end; i += 4)
+			Kernel::template Run<FastMath::SSELanes, ApproxTrig<FastMath::SSELanes> >(a, i);
+#endif
+		for(; i < end; i++)
+			Kernel::template Run<FastMath::ScalarLanes, ApproxTrig<FastMath::ScalarLanes> >(a, i);
+	}
+	else
+	{
+		for(; i < end; i++)
+			Kernel::template Run<FastMath::ScalarLanes, ExactTrig>(a, i);
+	}
+}
+
+
+/////////////////////////////////////////////////////////////////////
+KinematicBatch::KinematicBatch()
+{
+	fastTrig = false;
+}
+
+uInt KinematicBatch::Add(const Vector2D& position, Float rotation, const Vector2D& target,
+						 Float maxSpeed, Float slowRadius, Float wanderRotation)
+{
+	uInt slot = Count();
+
+	this->positionX.push_back(position[0]);
+	this->positionY.push_back(position[1]);
+	this->rotation.push_back(rotation);
+	this->targetX.push_back(target[0]);
+	this->targetY.push_back(target[1]);
+	this->maxSpeed.push_back(maxSpeed);
+	this->slowRadius.push_back(slowRadius);
+	this->wanderRotation.push_back(wanderRotation);
+
+	for(Int word = 0; word < 4; word++)
+		randomState[word].push_back(0);
+	setRandomSeed(slot, Random::default_seed, slot);
+
+	linearX.push_back(0);
+	linearY.push_back(0);
+	angular.push_back(0);
+
+	return slot;
+}
+
+uInt KinematicBatch::Count() const
+{
+	return (uInt)positionX.size();
+}
+
+
+Vector2D KinematicBatch::Position(uInt slot) const
+{
+	assert(slot < Count());
+	return Vector2D(positionX[slot], positionY[slot]);
+}
+
+Float KinematicBatch::Rotation(uInt slot) const
+{
+	assert(slot < Count());
+	return rotation[slot];
+}
+
+Vector2D KinematicBatch::Target(uInt slot) const
+{
+	assert(slot < Count());
+	return Vector2D(targetX[slot], targetY[slot]);
+}
+
+Float KinematicBatch::MaxSpeed(uInt slot) const
+{
+	assert(slot < Count());
+	return maxSpeed[slot];
+}
+
+Float KinematicBatch::SlowRadius(uInt slot) const
+{
+	assert(slot < Count());
+	return slowRadius[slot];
+}
+
+Float KinematicBatch::WanderRotation(uInt slot) const
+{
+	assert(slot < Count());
+	return wanderRotation[slot];
+}
+
+
+Void KinematicBatch::setPosition(uInt slot, const Vector2D& position)
+{
+	assert(slot < Count());
+	positionX[slot] = position[0];
+	positionY[slot] = position[1];
+}
+
+Void KinematicBatch::setRotation(uInt slot, Float rotation)
+{
+	assert(slot < Count());
+	this->rotation[slot] = rotation;
+}
+
+Void KinematicBatch::setTarget(uInt slot, const Vector2D& target)
+{
+	assert(slot < Count());
+	targetX[slot] = target[0];
+	targetY[slot] = target[1];
+}
+
+Void KinematicBatch::setMaxSpeed(uInt slot, Float maxSpeed)
+{
+	assert(slot < Count());
+	this->maxSpeed[slot] = maxSpeed;
+}
+
+Void KinematicBatch::setSlowRadius(uInt slot, Float radius)
+{
+	assert(slot < Count());
+	slowRadius[slot] = radius;
+}
+
+Void KinematicBatch::setWanderRotation(uInt slot, Float angle)
+{
+	assert(slot < Count());
+	wanderRotation[slot] = angle;
+}
+
+Void KinematicBatch::setRandomSeed(uInt slot, uInt64 seed, uInt64 stream)
+{
+	assert(slot < Count());
+	uInt state[4];
+	Random::Seed_State(seed, stream, state);
+	for(Int word = 0; word < 4; word++)
+		randomState[word][slot] = state[word];
+}
+
+Bool KinematicBatch::FastTrig() const
+{
+	return fastTrig;
+}
+
+Void KinematicBatch::setFastTrig(Bool fast)
+{
+	fastTrig = fast;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+Void KinematicBatch::SeekRange(uInt begin, uInt end)
+{
+	assert(begin <= end && end <= Count());
+	Run_Range<SeekKernel>(Get_Arrays(), begin, end, fastTrig);
+}
+
+Void KinematicBatch::FleeRange(uInt begin, uInt end)
+{
+	assert(begin <= end && end <= Count());
+	Run_Range<FleeKernel>(Get_Arrays(), begin, end, fastTrig);
+}
+
+Void KinematicBatch::WanderRange(uInt begin, uInt end)
+{
+	assert(begin <= end && end <= Count());
+	Arrays a = Get_Arrays();
+
+	//a random number in (-1, 1) per agent, the difference of two draws from its generator,
+	//stored in angular for the kernel to scale
+	uInt i = begin;
+	Float first[4], second[4];
+	for(; i + 4 <= end; i += 4)
+	{
+		Random::Step4(a.randomState[0] + i, a.randomState[1] + i, a.randomState[2] + i, a.randomState[3] + i, first);
+		Random::Step4(a.randomState[0] + i, a.randomState[1] + i, a.randomState[2] + i, a.randomState[3] + i, second);
+		for(Int j = 0; j < 4; j++)
+			a.angular[i + j] = first[j] - second[j];
+	}
+	for(; i < end; i++)
+	{
+		Float draw = Random::Step(a.randomState[0][i], a.randomState[1][i], a.randomState[2][i], a.randomState[3][i]);
+		a.angular[i] = draw - Random::Step(a.randomState[0][i], a.randomState[1][i], a.randomState[2][i], a.randomState[3][i]);
+	}
+
+	Run_Range<WanderKernel>(a, begin, end, fastTrig);
+}
+
+Void KinematicBatch::ArriveRange(uInt begin, uInt end, Float timeToTarget)
+{
+	assert(begin <= end && end <= Count());
+	assert(timeToTarget > 0);
+	Arrays a = Get_Arrays();
+	a.timeToTarget = timeToTarget;
+	Run_Range<ArriveKernel>(a, begin, end, fastTrig);
+}
+
+
+Void KinematicBatch::Seek(ThreadPool* pool)
+{
+	if(pool == NULL)
+		SeekRange(0, Count());
+	else
+		pool->ParallelFor(Count(), steeringGrain, [this](uInt begin, uInt end) { SeekRange(begin, end); });
+}
+
+Void KinematicBatch::Flee(ThreadPool* pool)
+{
+	if(pool == NULL)
+		FleeRange(0, Count());
+	else
+		pool->ParallelFor(Count(), steeringGrain, [this](uInt begin, uInt end) { FleeRange(begin, end); });
+}
+
+Void KinematicBatch::Wander(ThreadPool* pool)
+{
+	if(pool == NULL)
+		WanderRange(0, Count());
+	else
+		pool->ParallelFor(Count(), steeringGrain, [this](uInt begin, uInt end) { WanderRange(begin, end); });
+}
+
+Void KinematicBatch::Arrive(Float timeToTarget, ThreadPool* pool)
+{
+	if(pool == NULL)
+		ArriveRange(0, Count(), timeToTarget);
+	else
+		pool->ParallelFor(Count(), steeringGrain, [this, timeToTarget](uInt begin, uInt end) { ArriveRange(begin, end, timeToTarget); });
+}
+
+Void KinematicBatch::FollowFlow(const FlowField& field, ThreadPool* pool)
+{
+	if(pool == NULL)
+		FollowFlowRange(0, Count(), field);
+	else
+		pool->ParallelFor(Count(), steeringGrain, [this, &field](uInt begin, uInt end) { FollowFlowRange(begin, end, field); });
+}
+
+Void KinematicBatch::FollowFlowRange(uInt begin, uInt end, const FlowField& field)
+{
+	assert(begin <= end && end <= Count());
+
+	//there are only 8 directions, so their unit vectors and the rotations facing them are worked out once
+	Float unitX[8], unitY[8], facing[8];
+	for(Byte d = 0; d < 8; d++)
+	{
+		Int dx, dy;
+		FlowField::Step(d, &dx, &dy);
+		Float scale = dx != 0 && dy != 0 ? 0.70710678f : 1.0f;
+		unitX[d] = dx * scale;
+		unitY[d] = dy * scale;
+		facing[d] = atan2(-unitX[d], unitY[d]);
+	}
+
+	//a look up per agent, which does not fit the lanes of the other behaviors
+	for(uInt i = begin; i < end; i++)
+	{
+		Int cell = field.CellAt(Vector2D(positionX[i], positionY[i]));
+		Byte direction = cell >= 0 ? field.Direction((uInt)cell) : FlowField::noDirection;
+		angular[i] = 0;
+
+		if(direction == FlowField::noDirection)
+		{
+			linearX[i] = 0;
+			linearY[i] = 0;
+			continue;
+		}
+
+		linearX[i] = unitX[direction] * maxSpeed[i];
+		linearY[i] = unitY[direction] * maxSpeed[i];
+		//face in the direction we want to move
+		rotation[i] = facing[direction];
+	}
+}
+
+
+SteeringOutput KinematicBatch::Output(uInt slot) const
+{
+	assert(slot < Count());
+	SteeringOutput steering;
+	steering.linearVel = Vector2D(linearX[slot], linearY[slot]);
+	steering.angularVel = angular[slot];
+	return steering;
+}
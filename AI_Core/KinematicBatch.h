@@ -0,0 +1,176 @@
+#ifndef _KINEMATICBATCH_H_
+#define _KINEMATICBATCH_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "CoreMathPhysics.h"
+
+class ThreadPool;
+class FlowField;
+
+
+//Sturcture that is returned from the kinematic behaviors
+//contains the linear Velocity and angular velocity to be applied to the object
+struct SteeringOutput
+{
+public:
+	//Linear Velocity
+	Vector2D linearVel;
+	//Angular Velocity
+	float angularVel;
+
+	//overload operator += for SteeringOutput
+	SteeringOutput operator +=(SteeringOutput steering)
+	{
+		this->linearVel += steering.linearVel;
+		this->angularVel += steering.angularVel ;
+		return *this;
+	}
+};
+
+
+//Class KinematicBatch
+//Runs the kinematic behaviors (Seek, Flee, Wander, Arrive, FollowFlow) over many agents at once.
+//Agent state is kept as one array per field (structure of arrays), so each behavior is a
+//single pass over contiguous memory that processes 4 or 8 agents per instruction, and can
+//be split across a ThreadPool. Each behavior writes its result to the output arrays
+//(LinearX, LinearY, Angular) and, like Kinematic, updates the rotation of the agents.
+//Agents are identified by the slot returned by Add; slots never move.
+class KinematicBatch
+{
+public:
+	//Constructor
+	//creates an empty batch
+	KinematicBatch();
+
+	//Add()
+	//return type: uInt
+	//parameters : Vector2D, Float, Vector2D, Float, Float, Float
+	//adds an agent and returns its slot. Its random numbers are stream "slot" of
+	//Random::default_seed, so the same agents wander the same way every run
+	uInt Add(const Vector2D& position,
+			 Float rotation,
+			 const Vector2D& target,
+			 Float maxSpeed,
+			 Float slowRadius,
+			 Float wanderRotation);
+
+	//Count()
+	//return type: uInt
+	//parameters : none
+	//returns the number of agents
+	uInt Count() const;
+
+
+	/////////////////////////////////////////////////////////////////////
+	//per agent accessors
+	Vector2D Position(uInt slot) const;
+	Float Rotation(uInt slot) const;
+	Vector2D Target(uInt slot) const;
+	Float MaxSpeed(uInt slot) const;
+	Float SlowRadius(uInt slot) const;
+	Float WanderRotation(uInt slot) const;
+
+	Void setPosition(uInt slot, const Vector2D& position);
+	Void setRotation(uInt slot, Float rotation);
+	Void setTarget(uInt slot, const Vector2D& target);
+	Void setMaxSpeed(uInt slot, Float maxSpeed);
+	Void setSlowRadius(uInt slot, Float radius);
+	Void setWanderRotation(uInt slot, Float angle);
+
+	//setRandomSeed()
+	//return type: none
+	//parameters : uInt, uInt64, uInt64
+	//restarts the random numbers the agent uses to wander
+	Void setRandomSeed(uInt slot, uInt64 seed, uInt64 stream);
+
+	//FastTrig() / setFastTrig()
+	//by default the behaviors call atan2, sin and cos one agent at a time, giving the same
+	//results as Kinematic always did. With fast trig they use the FastMath approximations
+	//(within 3e-7 radians) and process 4 or 8 agents per instruction
+	Bool FastTrig() const;
+	Void setFastTrig(Bool fast);
+
+
+	/////////////////////////////////////////////////////////////////////
+	//Behaviors over every agent. If a pool is given the agents are split across its threads
+
+	//Seek()
+	//moves at maxSpeed towards the target, at half speed inside slowRadius
+	Void Seek(ThreadPool* pool = NULL);
+
+	//Flee()
+	//moves at maxSpeed away from the target
+	Void Flee(ThreadPool* pool = NULL);
+
+	//Wander()
+	//moves at maxSpeed in the direction of the rotation, and turns by a random
+	//amount of up to wanderRotation
+	Void Wander(ThreadPool* pool = NULL);
+
+	//Arrive()
+	//moves towards the target fast enough to reach it in timeToTarget seconds, but no faster
+	//than maxSpeed, and stops inside slowRadius
+	Void Arrive(Float timeToTarget = 0.25f, ThreadPool* pool = NULL);
+
+	//FollowFlow()
+	//moves at maxSpeed the way field points in the cell the agent is in, one look up per agent.
+	//At the goal of the field, where it has no way there and off the grid the agent stops
+	//and keeps its rotation
+	Void FollowFlow(const FlowField& field, ThreadPool* pool = NULL);
+
+	//The same behaviors for the agents in the slots [begin, end)
+	Void SeekRange(uInt begin, uInt end);
+	Void FleeRange(uInt begin, uInt end);
+	Void WanderRange(uInt begin, uInt end);
+	Void ArriveRange(uInt begin, uInt end, Float timeToTarget = 0.25f);
+	Void FollowFlowRange(uInt begin, uInt end, const FlowField& field);
+
+
+	/////////////////////////////////////////////////////////////////////
+	//Output()
+	//return type: SteeringOutput
+	//parameters : uInt
+	//returns the result of the last behavior run on the agent
+	SteeringOutput Output(uInt slot) const;
+
+	//the state and output arrays, Count() long, for systems that work on all agents at once
+	Float* PositionX() { return positionX.data(); }
+	Float* PositionY() { return positionY.data(); }
+	Float* Rotations() { return rotation.data(); }
+	const Float* PositionX() const { return positionX.data(); }
+	const Float* PositionY() const { return positionY.data(); }
+	const Float* Rotations() const { return rotation.data(); }
+	const Float* MaxSpeeds() const { return maxSpeed.data(); }
+	const Float* LinearX() const { return linearX.data(); }
+	const Float* LinearY() const { return linearY.data(); }
+	const Float* Angular() const { return angular.data(); }
+
+	//pointers to the arrays, handed to the behavior kernels
+	struct Arrays;
+
+private:
+	Arrays Get_Arrays();
+
+	//state
+	std::vector<Float> positionX;
+	std::vector<Float> positionY;
+	std::vector<Float> rotation;
+	std::vector<Float> targetX;
+	std::vector<Float> targetY;
+	std::vector<Float> maxSpeed;
+	std::vector<Float> slowRadius;
+	std::vector<Float> wanderRotation;
+	//state of each agent's random number generator, one array per word
+	std::vector<uInt> randomState[4];
+
+	//output of the last behavior
+	std::vector<Float> linearX;
+	std::vector<Float> linearY;
+	std::vector<Float> angular;
+
+	Bool fastTrig;
+};
+
+
+#endif
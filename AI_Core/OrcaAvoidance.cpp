@@ -0,0 +1,310 @@
+#include "OrcaAvoidance.h"
+#include <assert.h>
+#include "ThreadPool.h"
+
+//batches smaller than this are not worth splitting across threads
+static const uInt orcaGrain = 512;
+
+//directions closer to parallel than this are treated as parallel
+static const Float orcaEpsilon = 0.00001f;
+
+
+namespace
+{
+	//the velocities allowed by one neighbour: the half plane left of direction, through point
+	struct OrcaLine
+	{
+		Vector2D point;
+		Vector2D direction;
+	};
+
+	//2D cross product; positive when b is counterclockwise from a
+	inline Float Det(const Vector2D& a, const Vector2D& b)
+	{
+		return a[0] * b[1] - a[1] * b[0];
+	}
+
+	//Solves on line lineNo, inside the circle of radius and the lines before it.
+	//Returns false if the constraints leave nothing on the line
+	Bool Solve_On_Line(const std::vector<OrcaLine>& lines, uInt lineNo, Float radius,
+					   const Vector2D& optimal, Bool directionOnly, Vector2D& result)
+	{
+		const OrcaLine& line = lines[lineNo];
+		Float dotProduct = line.point * line.direction;
+		Float discriminant = dotProduct * dotProduct + radius * radius - line.point.LengthSquared();
+
+		//the line misses the circle of speeds
+		if(discriminant < 0)
+			return false;
+
+		Float root = sqrt(discriminant);
+		Float tLeft = -dotProduct - root;
+		Float tRight = -dotProduct + root;
+
+		for(uInt i = 0; i < lineNo; i++)
+		{
+			Float denominator = Det(line.direction, lines[i].direction);
+			Float numerator = Det(lines[i].direction, line.point - lines[i].point);
+
+			if(fabs(denominator) <= orcaEpsilon)
+			{
+				//parallel lines: either all of this line is allowed by line i, or none of it
+				if(numerator < 0)
+					return false;
+				continue;
+			}
+
+			Float t = numerator / denominator;
+			if(denominator >= 0)
+				tRight = t < tRight ? t : tRight;
+			else
+				tLeft = t > tLeft ? t : tLeft;
+
+			if(tLeft > tRight)
+				return false;
+		}
+
+		if(directionOnly)
+		{
+			//as far as possible along optimal
+			if(optimal * line.direction > 0)
+				result = line.point + tRight * line.direction;
+			else
+				result = line.point + tLeft * line.direction;
+		}
+		else
+		{
+			//the point of the line nearest to optimal
+			Float t = line.direction * (optimal - line.point);
+			if(t < tLeft)
+				t = tLeft;
+			else if(t > tRight)
+				t = tRight;
+			result = line.point + t * line.direction;
+		}
+
+		return true;
+	}
+
+	//Finds the velocity nearest to optimal (or furthest along it, when directionOnly) inside
+	//the circle of radius and every line. Returns lines.size() on success, otherwise the line
+	//that could not be met; result then meets the lines before it
+	uInt Solve_Lines(const std::vector<OrcaLine>& lines, Float radius, const Vector2D& optimal,
+					 Bool directionOnly, Vector2D& result)
+	{
+		if(directionOnly)
+			result = optimal * radius;
+		else if(optimal.LengthSquared() > radius * radius)
+			result = optimal * (radius / optimal.Length());
+		else
+			result = optimal;
+
+		for(uInt i = 0; i < lines.size(); i++)
+		{
+			//only lines the current result breaks need to move it
+			if(Det(lines[i].direction, lines[i].point - result) > 0)
+			{
+				Vector2D previous = result;
+				if(!Solve_On_Line(lines, i, radius, optimal, directionOnly, result))
+				{
+					result = previous;
+					return i;
+				}
+			}
+		}
+
+		return (uInt)lines.size();
+	}
+
+	//When the lines leave no velocity, finds the one that breaks them by the least distance,
+	//starting from the result of Solve_Lines that failed at firstFailed
+	Void Solve_Least_Broken(const std::vector<OrcaLine>& lines, uInt firstFailed, Float radius,
+							std::vector<OrcaLine>& projected, Vector2D& result)
+	{
+		Float distance = 0;
+
+		for(uInt i = firstFailed; i < lines.size(); i++)
+		{
+			if(Det(lines[i].direction, lines[i].point - result) <= distance)
+				continue;
+
+			//the lines before i, as seen from line i moved out by distance
+			projected.clear();
+			for(uInt j = 0; j < i; j++)
+			{
+				OrcaLine line;
+				Float determinant = Det(lines[i].direction, lines[j].direction);
+
+				if(fabs(determinant) <= orcaEpsilon)
+				{
+					//same direction: line j adds nothing; opposite: half way between them
+					if(lines[i].direction * lines[j].direction > 0)
+						continue;
+					line.point = 0.5f * (lines[i].point + lines[j].point);
+				}
+				else
+				{
+					line.point = lines[i].point + (Det(lines[j].direction, lines[i].point - lines[j].point) / determinant) * lines[i].direction;
+				}
+
+				line.direction = lines[j].direction - lines[i].direction;
+				line.direction.Normalize();
+				projected.push_back(line);
+			}
+
+			Vector2D previous = result;
+			if(Solve_Lines(projected, radius, Vector2D(-lines[i].direction[1], lines[i].direction[0]), true, result) < projected.size())
+			{
+				//can only fail through rounding; the previous result is still the best known
+				result = previous;
+			}
+
+			distance = Det(lines[i].direction, lines[i].point - result);
+		}
+	}
+}
+
+
+OrcaSettings::OrcaSettings()
+{
+	radius = 0.5f;
+	neighbourDistance = 5;
+	maxNeighbours = 10;
+	timeHorizon = 2;
+	timeStep = 1.0f / 60.0f;
+}
+
+
+OrcaAvoidance::OrcaAvoidance()
+{
+}
+
+OrcaSettings& OrcaAvoidance::Settings()
+{
+	return settings;
+}
+
+Void OrcaAvoidance::Resize(uInt count)
+{
+	linearX.resize(count);
+	linearY.resize(count);
+}
+
+Void OrcaAvoidance::Update(const KinematicBatch& batch, const SpatialGrid& grid,
+						   const Float* velocityX, const Float* velocityY,
+						   const Float* preferredX, const Float* preferredY, ThreadPool* pool)
+{
+	Resize(batch.Count());
+
+	if(pool == NULL)
+		UpdateRange(batch, grid, velocityX, velocityY, preferredX, preferredY, 0, batch.Count());
+	else
+		pool->ParallelFor(batch.Count(), orcaGrain, [&](uInt begin, uInt end)
+		{
+			UpdateRange(batch, grid, velocityX, velocityY, preferredX, preferredY, begin, end);
+		});
+}
+
+Void OrcaAvoidance::UpdateRange(const KinematicBatch& batch, const SpatialGrid& grid,
+								const Float* velocityX, const Float* velocityY,
+								const Float* preferredX, const Float* preferredY, uInt begin, uInt end)
+{
+	assert(grid.Count() == batch.Count());
+	assert(begin <= end && end <= batch.Count() && end <= linearX.size());
+	assert(settings.timeHorizon > 0 && settings.timeStep > 0);
+
+	//scratch space of the calling thread, so threads share nothing they write
+	static thread_local std::vector<uInt> neighbours;
+	static thread_local std::vector<OrcaLine> lines;
+	static thread_local std::vector<OrcaLine> projected;
+	neighbours.resize(settings.maxNeighbours);
+
+	const Float* positionX = batch.PositionX();
+	const Float* positionY = batch.PositionY();
+	const Float* maxSpeed = batch.MaxSpeeds();
+
+	Float inverseTimeHorizon = 1.0f / settings.timeHorizon;
+	Float inverseTimeStep = 1.0f / settings.timeStep;
+	Float combinedRadius = 2 * settings.radius;
+	Float combinedRadiusSquared = combinedRadius * combinedRadius;
+
+	for(uInt agent = begin; agent < end; agent++)
+	{
+		Vector2D position(positionX[agent], positionY[agent]);
+		Vector2D velocity(velocityX[agent], velocityY[agent]);
+
+		uInt found = grid.QueryNearest(position, settings.maxNeighbours, neighbours.data(), settings.neighbourDistance, agent);
+
+		lines.clear();
+		for(uInt n = 0; n < found; n++)
+		{
+			uInt other = neighbours[n];
+			Vector2D relativePosition(positionX[other] - position[0], positionY[other] - position[1]);
+			Vector2D relativeVelocity(velocity[0] - velocityX[other], velocity[1] - velocityY[other]);
+			Float distanceSquared = relativePosition.LengthSquared();
+
+			OrcaLine line;
+			Vector2D u;
+
+			if(distanceSquared > combinedRadiusSquared)
+			{
+				//no collision yet: the velocity obstacle is a cone truncated by a circle at timeHorizon
+				Vector2D w = relativeVelocity - inverseTimeHorizon * relativePosition;
+				Float wLengthSquared = w.LengthSquared();
+				Float dotProduct = w * relativePosition;
+
+				if(dotProduct < 0 && dotProduct * dotProduct > combinedRadiusSquared * wLengthSquared)
+				{
+					//nearest to the circle at the end of the cone
+					Float wLength = sqrt(wLengthSquared);
+					Vector2D unitW = w * (1.0f / wLength);
+					line.direction = Vector2D(unitW[1], -unitW[0]);
+					u = (combinedRadius * inverseTimeHorizon - wLength) * unitW;
+				}
+				else
+				{
+					//nearest to one of the legs of the cone
+					Float leg = sqrt(distanceSquared - combinedRadiusSquared);
+					Float inverseDistanceSquared = 1.0f / distanceSquared;
+
+					if(Det(relativePosition, w) > 0)
+						line.direction = Vector2D(relativePosition[0] * leg - relativePosition[1] * combinedRadius,
+												  relativePosition[0] * combinedRadius + relativePosition[1] * leg) * inverseDistanceSquared;
+					else
+						line.direction = Vector2D(-(relativePosition[0] * leg + relativePosition[1] * combinedRadius),
+												  -(-relativePosition[0] * combinedRadius + relativePosition[1] * leg)) * inverseDistanceSquared;
+
+					u = (relativeVelocity * line.direction) * line.direction - relativeVelocity;
+				}
+			}
+			else
+			{
+				//already overlapping: get apart within one time step
+				Vector2D w = relativeVelocity - inverseTimeStep * relativePosition;
+				Float wLength = w.Length();
+				Vector2D unitW = wLength > 0 ? w * (1.0f / wLength) : Vector2D(agent < other ? -1.0f : 1.0f, 0);
+				line.direction = Vector2D(unitW[1], -unitW[0]);
+				u = (combinedRadius * inverseTimeStep - wLength) * unitW;
+			}
+
+			//each agent takes half of the change
+			line.point = velocity + 0.5f * u;
+			lines.push_back(line);
+		}
+
+		Vector2D preferred(preferredX[agent], preferredY[agent]);
+		Vector2D result;
+		uInt failed = Solve_Lines(lines, maxSpeed[agent], preferred, false, result);
+		if(failed < lines.size())
+			Solve_Least_Broken(lines, failed, maxSpeed[agent], projected, result);
+
+		linearX[agent] = result[0];
+		linearY[agent] = result[1];
+	}
+}
+
+Vector2D OrcaAvoidance::Velocity(uInt slot) const
+{
+	assert(slot < linearX.size());
+	return Vector2D(linearX[slot], linearY[slot]);
+}
@@ -0,0 +1,100 @@
+#ifndef _ORCAAVOIDANCE_H_
+#define _ORCAAVOIDANCE_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "KinematicBatch.h"
+#include "SpatialGrid.h"
+
+class ThreadPool;
+
+
+//Structure holding the settings of OrcaAvoidance
+struct OrcaSettings
+{
+public:
+	//radius of every agent
+	Float radius;
+	//agents further apart than this are ignored
+	Float neighbourDistance;
+	//at most this many of the nearest agents are avoided
+	uInt maxNeighbours;
+	//how far ahead, in seconds, collisions are avoided; longer is safer but makes agents
+	//give way earlier
+	Float timeHorizon;
+	//the time between updates, in seconds, used to push apart agents that already overlap
+	Float timeStep;
+
+	//Constructor
+	//sets settings that suit agents 1 unit across updated at 60 Hz
+	OrcaSettings();
+};
+
+
+//Class OrcaAvoidance
+//Local collision avoidance with optimal reciprocal collision avoidance (ORCA).
+//Each agent has a preferred velocity, usually from its steering (Seek, Flocking ...), and this
+//finds the velocity closest to it that does not collide with any neighbour within timeHorizon,
+//assuming each neighbour takes half of the effort to avoid it. Each neighbour limits the
+//velocities to a half plane, and a small linear program finds the best velocity inside all of
+//them; when they leave nothing, the velocity that breaks them the least is used.
+//The cost per agent depends on maxNeighbours, not on the size of the crowd, because
+//neighbours come from a SpatialGrid. Every agent reads the shared state and writes only its
+//own result, so Update can be split across a ThreadPool.
+class OrcaAvoidance
+{
+public:
+	//Constructor
+	//creates a solver with default settings
+	OrcaAvoidance();
+
+	//Settings()
+	//return type: OrcaSettings&
+	//parameters : none
+	//returns the settings, to read or change
+	OrcaSettings& Settings();
+
+	//Update()
+	//return type: Void
+	//parameters : const KinematicBatch&, const SpatialGrid&, const Float*, const Float*,
+	//			   const Float*, const Float*, ThreadPool*
+	//finds the new velocity of every agent of the batch. velocityX/Y are the velocities the
+	//agents move with now (e.g. the result of the last update), preferredX/Y the velocities they
+	//want (e.g. batch.LinearX() after Seek). Speeds are limited to the agents' maxSpeed, and grid
+	//must hold the positions of the batch
+	Void Update(const KinematicBatch& batch, const SpatialGrid& grid,
+				const Float* velocityX, const Float* velocityY,
+				const Float* preferredX, const Float* preferredY, ThreadPool* pool = NULL);
+
+	//UpdateRange()
+	//the same for the agents in the slots [begin, end); call Update or Resize first so the
+	//results have room for every agent
+	Void UpdateRange(const KinematicBatch& batch, const SpatialGrid& grid,
+					 const Float* velocityX, const Float* velocityY,
+					 const Float* preferredX, const Float* preferredY, uInt begin, uInt end);
+
+	//Resize()
+	//return type: Void
+	//parameters : uInt
+	//makes room for the results of count agents
+	Void Resize(uInt count);
+
+	//Velocity()
+	//return type: Vector2D
+	//parameters : uInt
+	//returns the new velocity of an agent
+	Vector2D Velocity(uInt slot) const;
+
+	//the new velocities of all agents
+	const Float* LinearX() const { return linearX.data(); }
+	const Float* LinearY() const { return linearY.data(); }
+
+private:
+	OrcaSettings settings;
+
+	std::vector<Float> linearX;
+	std::vector<Float> linearY;
+};
+
+
+#endif
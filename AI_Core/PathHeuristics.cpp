@@ -0,0 +1,32 @@
+#include "PathHeuristics.h"
+#include <math.h>
+
+
+Heuristic EuclideanHeuristic(Float costPerUnit)
+{
+	return [costPerUnit](const Vector3D& from, const Vector3D& goal)
+	{
+		Float dx = goal[0] - from[0], dy = goal[1] - from[1], dz = goal[2] - from[2];
+		return sqrt(dx * dx + dy * dy + dz * dz) * costPerUnit;
+	};
+}
+
+Heuristic ManhattanHeuristic(Float costPerUnit)
+{
+	return [costPerUnit](const Vector3D& from, const Vector3D& goal)
+	{
+		return (fabs(goal[0] - from[0]) + fabs(goal[1] - from[1]) + fabs(goal[2] - from[2])) * costPerUnit;
+	};
+}
+
+Heuristic OctileHeuristic(Float straightCost, Float diagonalCost)
+{
+	return [straightCost, diagonalCost](const Vector3D& from, const Vector3D& goal)
+	{
+		Float dx = fabs(goal[0] - from[0]), dy = fabs(goal[1] - from[1]);
+		Float shorter = dx < dy ? dx : dy;
+		Float longer = dx < dy ? dy : dx;
+		//diagonal steps over the shorter distance, straight ones for the rest
+		return shorter * diagonalCost + (longer - shorter) * straightCost;
+	};
+}
@@ -0,0 +1,46 @@
+#ifndef _PATHHEURISTICS_H_
+#define _PATHHEURISTICS_H_
+
+#include "Typedefs.h"
+#include <functional>
+#include "CoreMathPhysics.h"
+
+
+//Heuristic
+//estimates the cost of the cheapest route from a node at one position to the goal at another.
+//A* returns paths of lowest cost as long as the estimate is never more than the real cost.
+//An empty Heuristic estimates 0 everywhere, which makes A* search like Dijkstra
+typedef std::function<Float(const Vector3D& from, const Vector3D& goal)> Heuristic;
+
+//Which of the nodes with the same estimated total cost A* looks at first
+enum PathTieBreak
+{
+	TIE_FIRST_FOUND,	//the node queued first with that total
+	TIE_NEAR_GOAL,		//the node with the highest cost so far, which is the nearest to the goal;
+						//expands far fewer nodes when many share a total, e.g. open grids
+	TIE_NEAR_START,		//the node with the lowest cost so far
+};
+
+
+//EuclideanHeuristic()
+//return type: Heuristic
+//parameters : Float
+//straight line distance times costPerUnit, the lowest cost of moving one unit; for graphs whose
+//connections can go in any direction
+Heuristic EuclideanHeuristic(Float costPerUnit = 1);
+
+//ManhattanHeuristic()
+//return type: Heuristic
+//parameters : Float
+//the sum of the distances along x, y and z times costPerUnit; for grids with 4 (or 6) neighbours
+Heuristic ManhattanHeuristic(Float costPerUnit = 1);
+
+//OctileHeuristic()
+//return type: Heuristic
+//parameters : Float, Float
+//the cost of moving in x and y over a grid with 8 neighbours, where a straight step costs
+//straightCost and a diagonal one diagonalCost; z is ignored
+Heuristic OctileHeuristic(Float straightCost = 1, Float diagonalCost = 1.41421356f);
+
+
+#endif
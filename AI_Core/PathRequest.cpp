@@ -0,0 +1,104 @@
+#include "PathRequest.h"
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+
+//nodes expanded between looks at the clock, when Advance has a time limit
+static const uInt clockInterval = 64;
+
+
+PathRequest::PathRequest()
+{
+	graph = NULL;
+	start = goal = 0;
+	tieBreak = TIE_NEAR_GOAL;
+	state = PATH_WAITING;
+	context = NULL;
+}
+
+Void PathRequest::Set(const Graph& graph, uInt start, uInt goal, const Heuristic& heuristic, PathTieBreak tieBreak)
+{
+	this->graph = &graph;
+	this->start = start;
+	this->goal = goal;
+	this->heuristic = heuristic;
+	this->tieBreak = tieBreak;
+
+	state = PATH_WAITING;
+	context = NULL;
+	result.nodes.clear();
+	result.cost = 0;
+	result.nodesExpanded = 0;
+	result.found = false;
+}
+
+Void PathRequest::Begin(SearchContext& context)
+{
+	assert(graph != NULL && state == PATH_WAITING);
+
+	this->context = &context;
+	AStarBegin(graph->getAdjacency(), start, goal, heuristic, context);
+	state = PATH_SEARCHING;
+}
+
+PathRequestState PathRequest::Advance(uInt maxExpansions, uInt maxMicroseconds)
+{
+	if(state != PATH_SEARCHING)
+		return state;
+
+	GraphAdjacency adjacency = graph->getAdjacency();
+	std::chrono::steady_clock::time_point began;
+	if(maxMicroseconds != 0)
+		began = std::chrono::steady_clock::now();
+
+	uInt left = maxExpansions != 0 ? maxExpansions : 0xFFFFFFFF;
+	SearchProgress progress = SEARCH_RUNNING;
+	while(left > 0)
+	{
+		//with a time limit, in short runs so the clock can be looked at between them
+		uInt run = maxMicroseconds != 0 && left > clockInterval ? clockInterval : left;
+		uInt expanded = 0;
+		progress = AStarContinue(adjacency, goal, heuristic, tieBreak, *context, run, &expanded);
+		result.nodesExpanded += expanded;
+		left -= expanded;
+
+		if(progress != SEARCH_RUNNING)
+			break;
+
+		if(maxMicroseconds != 0 &&
+		   std::chrono::steady_clock::now() - began >= std::chrono::microseconds(maxMicroseconds))
+			break;
+	}
+
+	if(progress == SEARCH_RUNNING)
+		return state;
+
+	if(progress == SEARCH_FOUND)
+	{
+		result.cost = context->Record(goal).costSoFar;
+
+		//follow the parents back to the start
+		for(uInt node = goal; node != noPathNode; node = context->Record(node).parent)
+			result.nodes.push_back(node);
+		std::reverse(result.nodes.begin(), result.nodes.end());
+
+		result.found = true;
+		state = PATH_FOUND;
+	}
+	else
+	{
+		state = PATH_NOT_FOUND;
+	}
+
+	context = NULL;
+	return state;
+}
+
+Void PathRequest::Cancel()
+{
+	if(Done())
+		return;
+
+	state = PATH_CANCELLED;
+	context = NULL;
+}
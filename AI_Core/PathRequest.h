@@ -0,0 +1,91 @@
+#ifndef _PATHREQUEST_H_
+#define _PATHREQUEST_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "Graph.h"
+
+
+//Where a PathRequest is
+enum PathRequestState
+{
+	//set up, but not searching yet
+	PATH_WAITING,
+	//searching; Advance carries on
+	PATH_SEARCHING,
+	//done, and the result holds the path
+	PATH_FOUND,
+	//done, and there is no path
+	PATH_NOT_FOUND,
+	//given up on before it was done
+	PATH_CANCELLED
+};
+
+
+//Class PathRequest
+//A search over a Graph that is done a little at a time, so a long one does not hold up a frame.
+//Set describes it, Begin gives it a SearchContext to work in, and each Advance expands at most a
+//given number of nodes or runs for at most a given time, picking up where the last one stopped.
+//The search is the same A* as Graph::findPath and finds the same path.
+//The graph must not change while the request is searching; the context is used until the request
+//is done or cancelled. A PathScheduler can do the Begin and Advance calls for many requests.
+class PathRequest
+{
+public:
+	//Constructor
+	//creates a request with nothing to search for
+	PathRequest();
+
+	//Set()
+	//return type: Void
+	//parameters : const Graph&, uInt, uInt, const Heuristic&, PathTieBreak
+	//sets the request up to search graph from the node start to the node goal; it is then waiting
+	Void Set(const Graph& graph, uInt start, uInt goal, const Heuristic& heuristic = Heuristic(),
+			 PathTieBreak tieBreak = TIE_NEAR_GOAL);
+
+	//Begin()
+	//return type: Void
+	//parameters : SearchContext&
+	//starts the search of a waiting request in context, without expanding anything yet
+	Void Begin(SearchContext& context);
+
+	//Advance()
+	//return type: PathRequestState
+	//parameters : uInt, uInt
+	//carries on searching until the request is done, maxExpansions nodes have been expanded or
+	//maxMicroseconds have gone by, whichever comes first; 0 leaves either unlimited. The time is
+	//checked every few nodes, so it may be passed by the time they take. Returns the state after
+	PathRequestState Advance(uInt maxExpansions, uInt maxMicroseconds = 0);
+
+	//Cancel()
+	//return type: Void
+	//parameters : none
+	//gives up on the request; a scheduler drops it the next time it comes to it
+	Void Cancel();
+
+	PathRequestState State() const	{ return state; }
+	Bool Done() const				{ return state != PATH_WAITING && state != PATH_SEARCHING; }
+	uInt Start() const				{ return start; }
+	uInt Goal() const				{ return goal; }
+
+	//Result()
+	//return type: const NodePathResult&
+	//parameters : none
+	//the path once the request is PATH_FOUND; nodesExpanded counts every node expanded so far
+	const NodePathResult& Result() const	{ return result; }
+
+private:
+	const Graph* graph;
+	uInt start;
+	uInt goal;
+	Heuristic heuristic;
+	PathTieBreak tieBreak;
+
+	PathRequestState state;
+	//the context the search is in while it is searching
+	SearchContext* context;
+	NodePathResult result;
+};
+
+
+#endif
@@ -0,0 +1,127 @@
+#include "PathScheduler.h"
+#include <assert.h>
+#include <chrono>
+
+
+PathScheduler::PathScheduler(uInt maxSearching)
+{
+	assert(maxSearching > 0);
+
+	contexts.resize(maxSearching);
+	for(uInt i = maxSearching; i > 0; i--)
+		freeContexts.push_back(i - 1);
+
+	next = 0;
+	slice = 128;
+	submitted = 0;
+}
+
+Void PathScheduler::SetSlice(uInt expansions)
+{
+	assert(expansions > 0);
+	slice = expansions;
+}
+
+Void PathScheduler::Submit(PathRequest* request, Int priority)
+{
+	assert(request->State() == PATH_WAITING);
+
+	Waiting entry = { request, priority, submitted++ };
+	waiting.push_back(entry);
+}
+
+Void PathScheduler::Cancel(PathRequest* request)
+{
+	for(uInt i = 0; i < waiting.size(); i++)
+	{
+		if(waiting[i].request == request)
+		{
+			waiting.erase(waiting.begin() + i);
+			break;
+		}
+	}
+
+	for(uInt i = 0; i < searching.size(); i++)
+	{
+		if(searching[i].request == request)
+		{
+			stopSearching(i);
+			break;
+		}
+	}
+
+	request->Cancel();
+}
+
+Void PathScheduler::Update(uInt maxExpansions, uInt maxMicroseconds)
+{
+	std::chrono::steady_clock::time_point began = std::chrono::steady_clock::now();
+	uInt left = maxExpansions != 0 ? maxExpansions : 0xFFFFFFFF;
+
+	startWaiting();
+
+	while(!searching.empty() && left > 0)
+	{
+		if(next >= searching.size())
+			next = 0;
+
+		//a request cancelled by itself expands nothing and is dropped here
+		PathRequest* request = searching[next].request;
+		uInt before = request->Result().nodesExpanded;
+		request->Advance(slice < left ? slice : left);
+		uInt expanded = request->Result().nodesExpanded - before;
+		left -= expanded < left ? expanded : left;
+
+		if(request->Done())
+		{
+			//the request after it moves into its place, and has the next turn
+			stopSearching(next);
+			startWaiting();
+		}
+		else
+		{
+			next++;
+		}
+
+		if(maxMicroseconds != 0 &&
+		   std::chrono::steady_clock::now() - began >= std::chrono::microseconds(maxMicroseconds))
+			break;
+	}
+}
+
+Void PathScheduler::startWaiting()
+{
+	while(!freeContexts.empty() && !waiting.empty())
+	{
+		//the highest priority, then the first submitted
+		uInt best = 0;
+		for(uInt i = 1; i < waiting.size(); i++)
+		{
+			if(waiting[i].priority > waiting[best].priority ||
+			   (waiting[i].priority == waiting[best].priority && waiting[i].order < waiting[best].order))
+				best = i;
+		}
+
+		PathRequest* request = waiting[best].request;
+		waiting.erase(waiting.begin() + best);
+
+		//cancelled while it waited
+		if(request->State() != PATH_WAITING)
+			continue;
+
+		Searching entry = { request, freeContexts.back() };
+		freeContexts.pop_back();
+		request->Begin(contexts[entry.context]);
+		searching.push_back(entry);
+	}
+}
+
+Void PathScheduler::stopSearching(uInt index)
+{
+	freeContexts.push_back(searching[index].context);
+	searching.erase(searching.begin() + index);
+
+	//keep the turn with the same request
+	if(index < next)
+		next--;
+}
@@ -0,0 +1,89 @@
+#ifndef _PATHSCHEDULER_H_
+#define _PATHSCHEDULER_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include "PathRequest.h"
+
+
+//Class PathScheduler
+//Shares a frame's budget of pathfinding between many PathRequests.
+//Submitted requests wait until one of a fixed number of search contexts is free, the highest
+//priority first and, of equal priorities, the first submitted. Each Update then goes round the
+//requests that are searching, advancing each by a slice of nodes in turn, until the budget for the
+//frame is spent; the next Update carries on from the request after the last one served, so long
+//searches share the time with short ones instead of holding up the frame.
+//Requests are not owned; a submitted request must stay alive until it is done or cancelled through
+//the scheduler. Agents see their request finish through its state.
+class PathScheduler
+{
+public:
+	//Constructor
+	//creates a scheduler that runs up to maxSearching searches at once, each in a context of its own
+	explicit PathScheduler(uInt maxSearching = 8);
+
+	//SetSlice()
+	//return type: Void
+	//parameters : uInt
+	//sets how many nodes a request is advanced by each time its turn comes round
+	Void SetSlice(uInt expansions);
+
+	//Submit()
+	//return type: Void
+	//parameters : PathRequest*, Int
+	//queues a waiting request with priority; higher priorities start searching first
+	Void Submit(PathRequest* request, Int priority = 0);
+
+	//Cancel()
+	//return type: Void
+	//parameters : PathRequest*
+	//cancels request and drops it at once, so it may be destroyed or set up again
+	Void Cancel(PathRequest* request);
+
+	//Update()
+	//return type: Void
+	//parameters : uInt, uInt
+	//advances the requests in turn until they are all done, maxExpansions nodes have been expanded
+	//in all or maxMicroseconds have gone by; 0 leaves either unlimited. The time is checked after
+	//each slice
+	Void Update(uInt maxExpansions, uInt maxMicroseconds = 0);
+
+	uInt WaitingCount() const	{ return (uInt)waiting.size(); }
+	uInt SearchingCount() const	{ return (uInt)searching.size(); }
+
+private:
+	struct Waiting
+	{
+		PathRequest* request;
+		Int priority;
+		//when it was submitted, to keep requests of equal priority in order
+		uInt order;
+	};
+
+	struct Searching
+	{
+		PathRequest* request;
+		//the context it searches in
+		uInt context;
+	};
+
+	//starts waiting requests while there are free contexts
+	Void startWaiting();
+	//drops the searching request at index and frees its context
+	Void stopSearching(uInt index);
+
+	std::vector<Waiting> waiting;
+	//in the order they take turns
+	std::vector<Searching> searching;
+	//the request whose turn is next
+	uInt next;
+
+	std::vector<SearchContext> contexts;
+	std::vector<uInt> freeContexts;
+
+	uInt slice;
+	uInt submitted;
+};
+
+
+#endif
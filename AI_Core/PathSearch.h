@@ -0,0 +1,264 @@
+#ifndef _PATHSEARCH_H_
+#define _PATHSEARCH_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include <cfloat>
+#include <assert.h>
+#include "IndexedHeap.h"
+#include "PathHeuristics.h"
+
+//parent of the start node, and of nodes no search has reached
+const uInt noPathNode = 0xFFFFFFFF;
+
+
+//What a search knows about one node
+struct NodeRecord
+{
+	//node the best route so far arrives from, noPathNode for the start node
+	uInt parent;
+	//cost of the best route so far
+	Float costSoFar;
+	//estimated cost from the node to the goal
+	Float estimate;
+	//true once the node has been expanded, and not reached by a cheaper route since
+	Bool closed;
+	//the search of its SearchContext that last wrote the record
+	uInt generation;
+};
+
+
+//Class SearchContext
+//Everything one search writes: a record per node and the open set. Graphs are only read while
+//searching, so any number of threads can search the same graph at once, each with a context of its own.
+//Starting a search does not reset every record: each record remembers which search wrote it, and
+//records left by an earlier search read as unvisited. After the first search sized the context,
+//a search costs only the nodes it reaches and allocates nothing.
+class SearchContext
+{
+public:
+	//Constructor
+	//creates a context for graphs of no nodes; Begin makes room
+	SearchContext()
+	{
+		generation = 0;
+	}
+
+	//Begin()
+	//return type: Void
+	//parameters : uInt
+	//starts a new search over a graph of nodeCount nodes: every record reads as unvisited and the
+	//open set is empty
+	Void Begin(uInt nodeCount)
+	{
+		if(records.size() != nodeCount)
+		{
+			NodeRecord unwritten = { noPathNode, FLT_MAX, 0, false, 0 };
+			records.assign(nodeCount, unwritten);
+			open.Resize(nodeCount);
+			generation = 0;
+		}
+		else
+		{
+			open.Clear();
+		}
+
+		//once in 4 billion searches the counter wraps and the records have to be cleared for real
+		generation++;
+		if(generation == 0)
+		{
+			for(uInt i = 0; i < records.size(); i++)
+				records[i].generation = 0;
+			generation = 1;
+		}
+	}
+
+	//Record()
+	//return type: NodeRecord&
+	//parameters : uInt
+	//returns the record of node in this search, an unvisited one if the search has not reached it
+	NodeRecord& Record(uInt node)
+	{
+		NodeRecord& record = records[node];
+		if(record.generation != generation)
+		{
+			NodeRecord unvisited = { noPathNode, FLT_MAX, 0, false, generation };
+			record = unvisited;
+		}
+		return record;
+	}
+
+	//Reached()
+	//return type: Bool
+	//parameters : uInt
+	//returns true if this search has found a route to node
+	Bool Reached(uInt node) const
+	{
+		return records[node].generation == generation && records[node].costSoFar != FLT_MAX;
+	}
+
+	//Open()
+	//return type: IndexedHeap&
+	//parameters : none
+	//returns the open set of this search
+	IndexedHeap& Open()
+	{
+		return open;
+	}
+
+private:
+	std::vector<NodeRecord> records;
+	IndexedHeap open;
+	uInt generation;
+};
+
+
+//Structure holding a path found over node ids
+struct NodePathResult
+{
+public:
+	//the nodes from start to goal, both included; empty if no path was found
+	std::vector<uInt> nodes;
+	//the total cost of the path
+	Float cost;
+	//how many nodes were taken off the open set and had their connections looked at
+	uInt nodesExpanded;
+	//true if a path was found
+	Bool found;
+
+	//Constructor
+	//an empty result
+	NodePathResult() { cost = 0; nodesExpanded = 0; found = false; }
+};
+
+
+//How far a search has got
+enum SearchProgress
+{
+	//the open set still holds nodes to look at
+	SEARCH_RUNNING,
+	//the goal was reached
+	SEARCH_FOUND,
+	//everything reachable was looked at without reaching the goal
+	SEARCH_FAILED
+};
+
+
+//AStarBegin()
+//return type: Void
+//parameters : const Adjacency&, uInt, uInt, const Heuristic&, SearchContext&
+//starts a search from start to goal in context: the open set holds just the start node.
+//AStarContinue then does the work
+template <class Adjacency>
+Void AStarBegin(const Adjacency& graph, uInt start, uInt goal, const Heuristic& heuristic, SearchContext& context)
+{
+	assert(start < graph.NodeCount() && goal < graph.NodeCount());
+	context.Begin(graph.NodeCount());
+
+	//Put the start node in the open set, a heap ordered by estimated total cost
+	NodeRecord& startRecord = context.Record(start);
+	startRecord.costSoFar = 0;
+	if(heuristic)
+		startRecord.estimate = heuristic(graph.Position(start), graph.Position(goal));
+	context.Open().Push(start, startRecord.estimate);
+}
+
+//AStarContinue()
+//return type: SearchProgress
+//parameters : const Adjacency&, uInt, const Heuristic&, PathTieBreak, SearchContext&, uInt, uInt*
+//carries on the search AStarBegin started in context, expanding at most maxExpansions nodes, and adds
+//the number it expanded to nodesExpanded. Returns SEARCH_RUNNING if it stopped for the limit; calling
+//it again picks up where it stopped, as long as the graph has not changed meanwhile
+template <class Adjacency>
+SearchProgress AStarContinue(const Adjacency& graph, uInt goal, const Heuristic& heuristic, PathTieBreak tieBreak,
+							 SearchContext& context, uInt maxExpansions, uInt* nodesExpanded)
+{
+	IndexedHeap& open = context.Open();
+	const Vector3D& goalPosition = graph.Position(goal);
+
+	SearchProgress progress = SEARCH_FAILED;
+	uInt expanded = 0;
+	while(!open.Empty())
+	{
+		if(expanded == maxExpansions)
+		{
+			progress = SEARCH_RUNNING;
+			break;
+		}
+
+		//the lowest estimated total in the open set of nodes; close it
+		uInt current = open.Pop();
+		NodeRecord& currentRecord = context.Record(current);
+		currentRecord.closed = true;
+
+		if(current == goal)
+		{
+			progress = SEARCH_FOUND;
+			break;
+		}
+
+		expanded++;
+		Float currentCost = currentRecord.costSoFar;
+
+		graph.ForEachEdge(current, [&](uInt to, Float cost)
+		{
+			NodeRecord& record = context.Record(to);
+
+			//keep the first route found of equal cost. Closed nodes already have their lowest
+			//cost, unless the heuristic is not consistent
+			Float costSoFar = currentCost + cost;
+			if(costSoFar >= record.costSoFar)
+				return;
+
+			//the first route to this node: estimate the rest of the way once
+			if(heuristic && record.costSoFar == FLT_MAX)
+				record.estimate = heuristic(graph.Position(to), goalPosition);
+
+			//a better route: add the node to the open set, or move it up if it is already there
+			record.parent = current;
+			record.costSoFar = costSoFar;
+			record.closed = false;
+
+			Float tie = 0;
+			if(tieBreak == TIE_NEAR_GOAL)
+				tie = -costSoFar;
+			else if(tieBreak == TIE_NEAR_START)
+				tie = costSoFar;
+			open.Push(to, costSoFar + record.estimate, tie);
+		});
+	}
+
+	*nodesExpanded += expanded;
+	return progress;
+}
+
+//AStarSearch()
+//return type: Bool
+//parameters : const Adjacency&, uInt, uInt, const Heuristic&, PathTieBreak, SearchContext&, uInt*
+//The search behind Graph and CsrGraph: A* from start to goal, or Dijkstra when heuristic is empty.
+//Returns true if goal was reached; the records of context then hold the route back from goal
+//through the parents, and its costSoFar is the cost of the path. nodesExpanded, if not NULL, is
+//filled out either way. The graph is only read.
+//Adjacency needs:
+//	uInt NodeCount() const
+//	const Vector3D& Position(uInt node) const
+//	ForEachEdge(uInt node, f) const, calling f(uInt to, Float cost) for each connection of node
+//Connections are looked at in the order ForEachEdge gives them, and of routes with equal cost
+//the first one found is kept, so the result only depends on the graph and the settings
+template <class Adjacency>
+Bool AStarSearch(const Adjacency& graph, uInt start, uInt goal, const Heuristic& heuristic, PathTieBreak tieBreak,
+				 SearchContext& context, uInt* nodesExpanded)
+{
+	AStarBegin(graph, start, goal, heuristic, context);
+
+	uInt expanded = 0;
+	SearchProgress progress = AStarContinue(graph, goal, heuristic, tieBreak, context, 0xFFFFFFFF, &expanded);
+
+	if(nodesExpanded != NULL)
+		*nodesExpanded = expanded;
+
+	return progress == SEARCH_FOUND;
+}
+
+
+#endif
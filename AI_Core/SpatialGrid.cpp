@@ -0,0 +1,348 @@
+#include "SpatialGrid.h"
+#include <assert.h>
+#include <algorithm>
+#include <mutex>
+#include "ThreadPool.h"
+
+const uInt SpatialGrid::none;
+
+//runs of items smaller than this are not worth splitting across threads
+static const uInt buildGrain = 4096;
+
+//runs task over [0, count), on the pool if there is one
+static Void Run_Range(ThreadPool* pool, uInt count, const ThreadPool::RangeTask& task)
+{
+	if(pool == NULL)
+		task(0, count);
+	else
+		pool->ParallelFor(count, buildGrain, task);
+}
+
+
+SpatialGrid::SpatialGrid(Float cellSize)
+{
+	assert(cellSize > 0);
+
+	this->cellSize = cellSize;
+	inverseCellSize = 1.0f / cellSize;
+	bucketBits = 6;
+	columnBits = 3;
+	bucketStart.assign(((uInt)1 << bucketBits) + 1, 0);
+	movedHead.assign((uInt)1 << bucketBits, none);
+	movedCount = 0;
+	minCellX = minCellY = 0;
+	maxCellX = maxCellY = -1;
+}
+
+Void SpatialGrid::Build(const Float* x, const Float* y, uInt count, ThreadPool* pool)
+{
+	//about two buckets per item keeps the buckets short
+	bucketBits = 6;
+	while(bucketBits < 31 && ((uInt)1 << bucketBits) < count * 2)
+		bucketBits++;
+	columnBits = (bucketBits + 1) / 2;
+	uInt buckets = (uInt)1 << bucketBits;
+
+	itemX.resize(count);
+	itemY.resize(count);
+	itemCellX.resize(count);
+	itemCellY.resize(count);
+	itemEntry.resize(count);
+	entryItem.resize(count);
+	entryX.resize(count);
+	entryY.resize(count);
+	entryCellX.resize(count);
+	entryCellY.resize(count);
+	bucketStart.resize(buckets + 1);
+	movedHead.assign(buckets, none);
+	movedNext.assign(count, none);
+	movedCount = 0;
+	if(bucketCursor.size() != buckets)
+		std::vector<std::atomic<uInt> >(buckets).swap(bucketCursor);
+
+	//on one thread the bucket counts need no locked adds
+	Bool serial = pool == NULL || pool->WorkerCount() == 0;
+	auto takeSlot = [this, serial](uInt bucket)
+	{
+		if(!serial)
+			return bucketCursor[bucket].fetch_add(1, std::memory_order_relaxed);
+		uInt slot = bucketCursor[bucket].load(std::memory_order_relaxed);
+		bucketCursor[bucket].store(slot + 1, std::memory_order_relaxed);
+		return slot;
+	};
+
+	Run_Range(pool, buckets, [this](uInt begin, uInt end)
+	{
+		for(uInt bucket = begin; bucket < end; bucket++)
+			bucketCursor[bucket].store(0, std::memory_order_relaxed);
+	});
+
+	//the cell of every item, and how many items each bucket gets; itemEntry holds the bucket for now
+	std::mutex boundsMutex;
+	minCellX = minCellY = 0x7FFFFFFF;
+	maxCellX = maxCellY = -0x7FFFFFFF;
+
+	Run_Range(pool, count, [&](uInt begin, uInt end)
+	{
+		Int lowX = 0x7FFFFFFF, lowY = 0x7FFFFFFF, highX = -0x7FFFFFFF, highY = -0x7FFFFFFF;
+
+		for(uInt item = begin; item < end; item++)
+		{
+			Int cellX = cellOf(x[item]);
+			Int cellY = cellOf(y[item]);
+			uInt bucket = bucketOf(cellX, cellY);
+
+			itemX[item] = x[item];
+			itemY[item] = y[item];
+			itemCellX[item] = cellX;
+			itemCellY[item] = cellY;
+			itemEntry[item] = bucket;
+			takeSlot(bucket);
+
+			lowX = std::min(lowX, cellX);
+			lowY = std::min(lowY, cellY);
+			highX = std::max(highX, cellX);
+			highY = std::max(highY, cellY);
+		}
+
+		std::lock_guard<std::mutex> lock(boundsMutex);
+		minCellX = std::min(minCellX, lowX);
+		minCellY = std::min(minCellY, lowY);
+		maxCellX = std::max(maxCellX, highX);
+		maxCellY = std::max(maxCellY, highY);
+	});
+
+	if(count == 0)
+	{
+		minCellX = minCellY = 0;
+		maxCellX = maxCellY = -1;
+	}
+
+	//where each bucket starts
+	uInt start = 0;
+	for(uInt bucket = 0; bucket < buckets; bucket++)
+	{
+		bucketStart[bucket] = start;
+		start += bucketCursor[bucket].load(std::memory_order_relaxed);
+		bucketCursor[bucket].store(bucketStart[bucket], std::memory_order_relaxed);
+	}
+	bucketStart[buckets] = start;
+
+	//place the items in their buckets
+	Run_Range(pool, count, [&](uInt begin, uInt end)
+	{
+		for(uInt item = begin; item < end; item++)
+			entryItem[takeSlot(itemEntry[item])] = item;
+	});
+
+	//threads place the items of a bucket in any order; sorting each bucket by item makes the grid,
+	//and so the order of query results, the same whatever the threads did. The buckets are a few
+	//items long and already sorted when built on one thread
+	Run_Range(pool, buckets, [this](uInt begin, uInt end)
+	{
+		for(uInt bucket = begin; bucket < end; bucket++)
+		{
+			uInt first = bucketStart[bucket];
+			for(uInt entry = first + 1; entry < bucketStart[bucket + 1]; entry++)
+			{
+				uInt item = entryItem[entry];
+				uInt slot = entry;
+				for(; slot > first && entryItem[slot - 1] > item; slot--)
+					entryItem[slot] = entryItem[slot - 1];
+				entryItem[slot] = item;
+			}
+		}
+	});
+
+	Run_Range(pool, count, [this](uInt begin, uInt end)
+	{
+		for(uInt entry = begin; entry < end; entry++)
+		{
+			uInt item = entryItem[entry];
+			entryX[entry] = itemX[item];
+			entryY[entry] = itemY[item];
+			entryCellX[entry] = itemCellX[item];
+			entryCellY[entry] = itemCellY[item];
+			itemEntry[item] = entry;
+		}
+	});
+}
+
+Void SpatialGrid::Move(uInt item, const Vector2D& position)
+{
+	assert(item < Count());
+
+	Int cellX = cellOf(position[0]);
+	Int cellY = cellOf(position[1]);
+
+	itemX[item] = position[0];
+	itemY[item] = position[1];
+
+	if(cellX == itemCellX[item] && cellY == itemCellY[item])
+	{
+		//same cell, so the same bucket: only the copy of the position changes
+		uInt entry = itemEntry[item];
+		if(entry != none)
+		{
+			entryX[entry] = position[0];
+			entryY[entry] = position[1];
+		}
+		return;
+	}
+
+	//leave the old bucket
+	if(itemEntry[item] != none)
+	{
+		entryItem[itemEntry[item]] = none;
+		itemEntry[item] = none;
+	}
+	else
+	{
+		unlinkMoved(item);
+		movedCount--;
+	}
+
+	//and join the side list of the new one
+	uInt bucket = bucketOf(cellX, cellY);
+	itemCellX[item] = cellX;
+	itemCellY[item] = cellY;
+	movedNext[item] = movedHead[bucket];
+	movedHead[bucket] = item;
+	movedCount++;
+
+	minCellX = std::min(minCellX, cellX);
+	minCellY = std::min(minCellY, cellY);
+	maxCellX = std::max(maxCellX, cellX);
+	maxCellY = std::max(maxCellY, cellY);
+}
+
+Void SpatialGrid::unlinkMoved(uInt item)
+{
+	uInt* link = &movedHead[bucketOf(itemCellX[item], itemCellY[item])];
+	while(*link != item)
+	{
+		assert(*link != none);
+		link = &movedNext[*link];
+	}
+	*link = movedNext[item];
+	movedNext[item] = none;
+}
+
+uInt SpatialGrid::Count() const
+{
+	return (uInt)itemX.size();
+}
+
+Float SpatialGrid::CellSize() const
+{
+	return cellSize;
+}
+
+Vector2D SpatialGrid::Position(uInt item) const
+{
+	assert(item < Count());
+	return Vector2D(itemX[item], itemY[item]);
+}
+
+
+uInt SpatialGrid::QueryRadius(const Vector2D& center, Float radius, std::vector<uInt>& result) const
+{
+	size_t before = result.size();
+	ForEachInRadius(center, radius, [&result](uInt item, Float, Float, Float)
+	{
+		result.push_back(item);
+	});
+	return (uInt)(result.size() - before);
+}
+
+uInt SpatialGrid::QueryRadius(const Vector2D& center, Float radius, uInt* result, uInt maxCount) const
+{
+	uInt found = 0;
+	ForEachInRadius(center, radius, [&](uInt item, Float, Float, Float)
+	{
+		if(found < maxCount)
+			result[found++] = item;
+	});
+	return found;
+}
+
+uInt SpatialGrid::QueryNearest(const Vector2D& center, uInt k, uInt* result, Float maxRadius, uInt exclude) const
+{
+	if(k == 0 || Count() == 0 || maxRadius < 0)
+		return 0;
+
+	//the k nearest so far, as a heap with the furthest on top; ties go to the lower item
+	//so the result does not depend on the order the cells are searched in
+	static thread_local std::vector<std::pair<Float, uInt> > nearest;
+	nearest.clear();
+
+	Float centerX = center[0], centerY = center[1];
+	Float maxSquared = maxRadius < FLT_MAX ? maxRadius * maxRadius : FLT_MAX;
+	Int centerCellX = cellOf(centerX);
+	Int centerCellY = cellOf(centerY);
+
+	auto consider = [&](uInt item, Float x, Float y)
+	{
+		Float dx = x - centerX;
+		Float dy = y - centerY;
+		std::pair<Float, uInt> candidate(dx * dx + dy * dy, item);
+
+		if(item == exclude || candidate.first > maxSquared)
+			return;
+
+		if(nearest.size() < k)
+		{
+			nearest.push_back(candidate);
+			std::push_heap(nearest.begin(), nearest.end());
+		}
+		else if(candidate < nearest.front())
+		{
+			std::pop_heap(nearest.begin(), nearest.end());
+			nearest.back() = candidate;
+			std::push_heap(nearest.begin(), nearest.end());
+		}
+	};
+
+	//search rings of cells around the center cell, starting with the first ring that reaches the items.
+	//Items in ring r + 1 are at least r * cellSize away, so once k items closer than that are found
+	//the search is over
+	Int ring = 0;
+	ring = std::max(ring, minCellX - centerCellX);
+	ring = std::max(ring, centerCellX - maxCellX);
+	ring = std::max(ring, minCellY - centerCellY);
+	ring = std::max(ring, centerCellY - maxCellY);
+
+	for(;; ring++)
+	{
+		Int firstX = std::max(centerCellX - ring, minCellX), lastX = std::min(centerCellX + ring, maxCellX);
+
+		//top and bottom rows of the ring, then the sides between them
+		if(centerCellY - ring >= minCellY && firstX <= lastX)
+			forEachInRow(centerCellY - ring, firstX, lastX, consider);
+		if(ring > 0 && centerCellY + ring <= maxCellY && firstX <= lastX)
+			forEachInRow(centerCellY + ring, firstX, lastX, consider);
+
+		Int sideFirst = std::max(centerCellY - ring + 1, minCellY), sideLast = std::min(centerCellY + ring - 1, maxCellY);
+		if(ring > 0 && centerCellX - ring >= minCellX)
+			for(Int cellY = sideFirst; cellY <= sideLast; cellY++)
+				forEachInRow(cellY, centerCellX - ring, centerCellX - ring, consider);
+		if(ring > 0 && centerCellX + ring <= maxCellX)
+			for(Int cellY = sideFirst; cellY <= sideLast; cellY++)
+				forEachInRow(cellY, centerCellX + ring, centerCellX + ring, consider);
+
+		Float reached = ring * cellSize;
+		if(nearest.size() == k && nearest.front().first < reached * reached)
+			break;
+		if(reached > maxRadius)
+			break;
+		//every cell with items has been searched
+		if(centerCellX - ring <= minCellX && centerCellX + ring >= maxCellX &&
+		   centerCellY - ring <= minCellY && centerCellY + ring >= maxCellY)
+			break;
+	}
+
+	std::sort_heap(nearest.begin(), nearest.end());
+	for(uInt i = 0; i < nearest.size(); i++)
+		result[i] = nearest[i].second;
+	return (uInt)nearest.size();
+}
@@ -0,0 +1,420 @@
+#ifndef _SPATIALGRID_H_
+#define _SPATIALGRID_H_
+
+#include "Typedefs.h"
+#include <vector>
+#include <atomic>
+#include <cfloat>
+#include <algorithm>
+#include "CoreMathPhysics.h"
+#include "ThreadPool.h"
+
+
+//Class SpatialGrid
+//Answers "which agents are near this point" without looking at every agent.
+//The plane is divided into square cells of cellSize, and the cells are wrapped onto a table of
+//buckets, so the world needs no bounds and the memory used depends only on the number of items. The items of each bucket
+//are stored next to each other with a copy of their positions, so a query reads a few short
+//runs of memory.
+//Items are numbered 0 to Count() - 1, normally the slots of a KinematicBatch. Rebuild the grid
+//with Build once per tick, or Move the few items that changed. Queries may run on many threads
+//at once, but not while the grid is being built or moved.
+//A cellSize close to the usual query radius works best.
+class SpatialGrid
+{
+public:
+	//returned by the queries for "no item"
+	static const uInt none = 0xFFFFFFFF;
+
+	//Constructor
+	//parameters : Float
+	//creates an empty grid with cells of cellSize
+	explicit SpatialGrid(Float cellSize);
+
+	//Build()
+	//return type: Void
+	//parameters : const Float*, const Float*, uInt, ThreadPool*
+	//replaces the contents of the grid with count items, item i at (x[i], y[i]).
+	//If a pool is given the work is split across its threads; the result is the same either way
+	Void Build(const Float* x, const Float* y, uInt count, ThreadPool* pool = NULL);
+
+	//Move()
+	//return type: Void
+	//parameters : uInt, Vector2D
+	//moves one item. Cheap when the item stays in its cell; otherwise the item is kept in a
+	//side list of its new bucket until the next Build
+	Void Move(uInt item, const Vector2D& position);
+
+	//Count()
+	//return type: uInt
+	//parameters : none
+	//returns the number of items
+	uInt Count() const;
+
+	//CellSize()
+	//return type: Float
+	//parameters : none
+	//returns the size of the cells
+	Float CellSize() const;
+
+	//Position()
+	//return type: Vector2D
+	//parameters : uInt
+	//returns the position the grid has for item
+	Vector2D Position(uInt item) const;
+
+
+	/////////////////////////////////////////////////////////////////////
+	//QueryRadius()
+	//return type: uInt
+	//parameters : Vector2D, Float, std::vector<uInt>&
+	//appends to result the items at most radius from center, and returns how many were added.
+	//The items come in no particular order
+	uInt QueryRadius(const Vector2D& center, Float radius, std::vector<uInt>& result) const;
+
+	//QueryRadius()
+	//return type: uInt
+	//parameters : Vector2D, Float, uInt*, uInt
+	//the same, without allocating: writes at most maxCount items to result and returns how many
+	//were written
+	uInt QueryRadius(const Vector2D& center, Float radius, uInt* result, uInt maxCount) const;
+
+	//ForEachInRadius()
+	//return type: Void
+	//parameters : Vector2D, Float, F
+	//calls visit(item, x, y, distanceSquared) for every item at most radius from center
+	template<class F>
+	Void ForEachInRadius(const Vector2D& center, Float radius, F visit) const;
+
+	//ForEachNeighbour()
+	//return type: Void
+	//parameters : Float, F, ThreadPool*
+	//calls visit(item, neighbour, x, y, distanceSquared) for every two different items at most radius
+	//apart, with (x, y) where neighbour is; each pair comes both ways. It finds what ForEachInRadius
+	//around every item would, but goes through the items in the order the grid stores them, and the
+	//items of a bucket share one look at the cells around them.
+	//If a pool is given the items are split across its threads; all the calls for one item are made
+	//by one thread, so visit may write to what belongs to item without locking
+	template<class F>
+	Void ForEachNeighbour(Float radius, F visit, ThreadPool* pool = NULL) const;
+
+	//QueryNearest()
+	//return type: uInt
+	//parameters : Vector2D, uInt, uInt*, Float, uInt
+	//writes the k items nearest to center to result, nearest first, and returns how many were
+	//found. Items further than maxRadius, and the item exclude (e.g. the agent asking), are skipped
+	uInt QueryNearest(const Vector2D& center, uInt k, uInt* result,
+					  Float maxRadius = FLT_MAX, uInt exclude = none) const;
+
+private:
+	//the cell containing a coordinate
+	Int cellOf(Float coordinate) const;
+	//the bucket of a cell
+	uInt bucketOf(Int cellX, Int cellY) const;
+	//the runs of entries of the buckets of the cells firstX to lastX of row cellY, as [first, last)
+	//pairs in runs; returns how many there are, 1 or 2. Other cells can share the buckets
+	uInt rowRuns(Int cellY, Int firstX, Int lastX, uInt runs[2][2]) const;
+	//calls visit(item, x, y) for every item in the cells firstX to lastX of row cellY
+	template<class F>
+	Void forEachInRow(Int cellY, Int firstX, Int lastX, F visit) const;
+	//calls visit(item, x, y, distanceSquared) for every entry of [first, last) at most the square root of
+	//radiusSquared from center, other than the item exclude. The entries are read from items, xs and ys
+	template<class F>
+	static Void visitInRadius(const uInt* items, const Float* xs, const Float* ys, uInt first, uInt last,
+							  Float centerX, Float centerY, Float radiusSquared, uInt exclude, F visit);
+	//ForEachNeighbour for the items of one bucket
+	template<class F>
+	Void neighboursInBucket(uInt bucket, Float radius, F visit) const;
+	//removes item from the side list of its bucket
+	Void unlinkMoved(uInt item);
+
+	Float cellSize;
+	Float inverseCellSize;
+	//there are 2^bucketBits buckets, in rows of 2^columnBits
+	uInt bucketBits;
+	uInt columnBits;
+
+	//items sorted by bucket: the items of bucket b are entries [bucketStart[b], bucketStart[b + 1]),
+	//with copies of their positions and cells; entryItem is none for items that were moved elsewhere
+	std::vector<uInt> bucketStart;
+	std::vector<uInt> entryItem;
+	std::vector<Float> entryX;
+	std::vector<Float> entryY;
+	std::vector<Int> entryCellX;
+	std::vector<Int> entryCellY;
+
+	//items moved to another bucket since the last Build: a list per bucket, through movedNext
+	std::vector<uInt> movedHead;
+	std::vector<uInt> movedNext;
+	uInt movedCount;
+
+	//per item
+	std::vector<Float> itemX;
+	std::vector<Float> itemY;
+	std::vector<Int> itemCellX;
+	std::vector<Int> itemCellY;
+	std::vector<uInt> itemEntry;	//index into the entries, or none if the item was moved
+
+	//cells spanned by the items, to know when a nearest search can stop
+	Int minCellX, minCellY, maxCellX, maxCellY;
+
+	//counters for the parallel Build
+	std::vector<std::atomic<uInt> > bucketCursor;
+};
+
+
+inline Int SpatialGrid::cellOf(Float coordinate) const
+{
+	//clamped so that far away or infinite coordinates still give a valid cell;
+	//rounds down without calling floor, which is a library call on most compilers
+	Float cell = coordinate * inverseCellSize;
+	if(cell < -1073741824.0f) return -1073741824;
+	if(cell > 1073741824.0f) return 1073741824;
+	Int truncated = (Int)cell;
+	return cell < (Float)truncated ? truncated - 1 : truncated;
+}
+
+inline uInt SpatialGrid::bucketOf(Int cellX, Int cellY) const
+{
+	//the buckets are a grid of 2^columnBits columns that repeats over the plane, so the cells
+	//of a query sit in a few runs of neighbouring buckets
+	uInt column = (uInt)cellX & ((1u << columnBits) - 1);
+	uInt row = (uInt)cellY & ((1u << (bucketBits - columnBits)) - 1);
+	return (row << columnBits) | column;
+}
+
+inline uInt SpatialGrid::rowRuns(Int cellY, Int firstX, Int lastX, uInt runs[2][2]) const
+{
+	//the buckets of neighbouring cells in a row are next to each other, so the whole row is one
+	//run of entries, or two if it wraps around the end of a row of buckets
+	uInt columns = 1u << columnBits;
+	uInt rowStart = bucketOf(0, cellY);
+	uInt firstColumn = bucketOf(firstX, cellY) - rowStart;
+	uInt span = (uInt)(lastX - firstX);
+
+	if(span >= columns - 1)
+	{
+		runs[0][0] = bucketStart[rowStart];
+		runs[0][1] = bucketStart[rowStart + columns];
+		return 1;
+	}
+	if(firstColumn + span < columns)
+	{
+		runs[0][0] = bucketStart[rowStart + firstColumn];
+		runs[0][1] = bucketStart[rowStart + firstColumn + span + 1];
+		return 1;
+	}
+	runs[0][0] = bucketStart[rowStart + firstColumn];
+	runs[0][1] = bucketStart[rowStart + columns];
+	runs[1][0] = bucketStart[rowStart];
+	runs[1][1] = bucketStart[rowStart + firstColumn + span - columns + 1];
+	return 2;
+}
+
+template<class F>
+Void SpatialGrid::forEachInRow(Int cellY, Int firstX, Int lastX, F visit) const
+{
+	//other cells can share the buckets, so only the items of the row's cells are visited
+	uInt runs[2][2];
+	uInt runCount = rowRuns(cellY, firstX, lastX, runs);
+	for(uInt run = 0; run < runCount; run++)
+	{
+		for(uInt entry = runs[run][0]; entry < runs[run][1]; entry++)
+		{
+			if(entryCellY[entry] == cellY && entryCellX[entry] >= firstX && entryCellX[entry] <= lastX && entryItem[entry] != none)
+				visit(entryItem[entry], entryX[entry], entryY[entry]);
+		}
+	}
+
+	if(movedCount == 0)
+		return;
+
+	//and the items moved into them since the last Build
+	uInt columns = 1u << columnBits;
+	uInt span = std::min((uInt)(lastX - firstX), columns - 1);
+	for(uInt column = 0; column <= span; column++)
+	{
+		for(uInt item = movedHead[bucketOf(firstX + (Int)column, cellY)]; item != none; item = movedNext[item])
+		{
+			if(itemCellY[item] == cellY && itemCellX[item] >= firstX && itemCellX[item] <= lastX)
+				visit(item, itemX[item], itemY[item]);
+		}
+	}
+}
+
+template<class F>
+Void SpatialGrid::visitInRadius(const uInt* items, const Float* xs, const Float* ys, uInt first, uInt last,
+								Float centerX, Float centerY, Float radiusSquared, uInt exclude, F visit)
+{
+	//whether an entry is in radius is hard to guess, so the entries in radius are found first without
+	//branching on it, a batch at a time, and only then visited
+	const uInt batch = 32;
+	for(; first < last; first += batch)
+	{
+		uInt end = std::min(first + batch, last);
+		uInt hits[batch];
+		Float hitDistance[batch];
+		uInt found = 0;
+		for(uInt entry = first; entry < end; entry++)
+		{
+			Float dx = xs[entry] - centerX;
+			Float dy = ys[entry] - centerY;
+			Float distanceSquared = dx * dx + dy * dy;
+			hits[found] = entry;
+			hitDistance[found] = distanceSquared;
+			found += (distanceSquared <= radiusSquared) & (items[entry] != exclude);
+		}
+
+		for(uInt hit = 0; hit < found; hit++)
+			visit(items[hits[hit]], xs[hits[hit]], ys[hits[hit]], hitDistance[hit]);
+	}
+}
+
+template<class F>
+Void SpatialGrid::ForEachInRadius(const Vector2D& center, Float radius, F visit) const
+{
+	if(Count() == 0 || radius < 0)
+		return;
+
+	Float centerX = center[0], centerY = center[1];
+	Float radiusSquared = radius * radius;
+	Int firstX = cellOf(centerX - radius), lastX = cellOf(centerX + radius);
+	Int firstY = cellOf(centerY - radius), lastY = cellOf(centerY + radius);
+
+	//only the cells that hold items can have any
+	if(firstX < minCellX) firstX = minCellX;
+	if(firstY < minCellY) firstY = minCellY;
+	if(lastX > maxCellX) lastX = maxCellX;
+	if(lastY > maxCellY) lastY = maxCellY;
+
+	if(firstX > lastX)
+		return;
+
+	//an item in radius is in one of the cells searched. Unless two of those cells share a bucket or
+	//items have been moved out of their entries, the distance alone tells which entries to visit
+	if(movedCount > 0 || (uInt)(lastX - firstX) >= (1u << columnBits) - 1 ||
+	   (uInt)(lastY - firstY) >= (1u << (bucketBits - columnBits)))
+	{
+		for(Int cellY = firstY; cellY <= lastY; cellY++)
+		{
+			forEachInRow(cellY, firstX, lastX, [&](uInt item, Float x, Float y)
+			{
+				Float dx = x - centerX;
+				Float dy = y - centerY;
+				Float distanceSquared = dx * dx + dy * dy;
+				if(distanceSquared <= radiusSquared)
+					visit(item, x, y, distanceSquared);
+			});
+		}
+		return;
+	}
+
+	for(Int cellY = firstY; cellY <= lastY; cellY++)
+	{
+		uInt runs[2][2];
+		uInt runCount = rowRuns(cellY, firstX, lastX, runs);
+		for(uInt run = 0; run < runCount; run++)
+			visitInRadius(entryItem.data(), entryX.data(), entryY.data(), runs[run][0], runs[run][1],
+						  centerX, centerY, radiusSquared, none, visit);
+	}
+}
+
+template<class F>
+Void SpatialGrid::neighboursInBucket(uInt bucket, Float radius, F visit) const
+{
+	uInt first = bucketStart[bucket], last = bucketStart[bucket + 1];
+	if(first == last)
+		return;
+
+	//the cells around every item of the bucket
+	Float lowX = entryX[first], highX = lowX, lowY = entryY[first], highY = lowY;
+	for(uInt entry = first + 1; entry < last; entry++)
+	{
+		lowX = std::min(lowX, entryX[entry]);
+		highX = std::max(highX, entryX[entry]);
+		lowY = std::min(lowY, entryY[entry]);
+		highY = std::max(highY, entryY[entry]);
+	}
+	Int firstX = std::max(cellOf(lowX - radius), minCellX), lastX = std::min(cellOf(highX + radius), maxCellX);
+	Int firstY = std::max(cellOf(lowY - radius), minCellY), lastY = std::min(cellOf(highY + radius), maxCellY);
+
+	//a bucket can hold cells far apart, and then each item looks for itself
+	if((uInt)(lastX - firstX) >= (1u << columnBits) - 1 || (uInt)(lastY - firstY) >= (1u << (bucketBits - columnBits)))
+	{
+		for(uInt entry = first; entry < last; entry++)
+		{
+			uInt item = entryItem[entry];
+			ForEachInRadius(Vector2D(entryX[entry], entryY[entry]), radius, [&](uInt neighbour, Float x, Float y, Float distanceSquared)
+			{
+				if(neighbour != item)
+					visit(item, neighbour, x, y, distanceSquared);
+			});
+		}
+		return;
+	}
+
+	//the runs of entries of those cells, found once for all the items
+	static thread_local std::vector<uInt> runs;
+	runs.clear();
+	for(Int cellY = firstY; cellY <= lastY; cellY++)
+	{
+		uInt rowRun[2][2];
+		uInt runCount = rowRuns(cellY, firstX, lastX, rowRun);
+		for(uInt run = 0; run < runCount; run++)
+		{
+			runs.push_back(rowRun[run][0]);
+			runs.push_back(rowRun[run][1]);
+		}
+	}
+
+	Float radiusSquared = radius * radius;
+	for(uInt entry = first; entry < last; entry++)
+	{
+		uInt item = entryItem[entry];
+		auto visitItem = [&](uInt neighbour, Float x, Float y, Float distanceSquared) { visit(item, neighbour, x, y, distanceSquared); };
+		for(uInt run = 0; run < runs.size(); run += 2)
+			visitInRadius(entryItem.data(), entryX.data(), entryY.data(), runs[run], runs[run + 1],
+						  entryX[entry], entryY[entry], radiusSquared, item, visitItem);
+	}
+}
+
+template<class F>
+Void SpatialGrid::ForEachNeighbour(Float radius, F visit, ThreadPool* pool) const
+{
+	if(Count() == 0 || radius < 0)
+		return;
+
+	//items moved since the last Build are not in the buckets' entries, so each item looks for itself
+	if(movedCount > 0)
+	{
+		auto visitItems = [&](uInt begin, uInt end)
+		{
+			for(uInt item = begin; item < end; item++)
+			{
+				ForEachInRadius(Position(item), radius, [&](uInt neighbour, Float x, Float y, Float distanceSquared)
+				{
+					if(neighbour != item)
+						visit(item, neighbour, x, y, distanceSquared);
+				});
+			}
+		};
+		if(pool == NULL)
+			visitItems(0, Count());
+		else
+			pool->ParallelFor(Count(), 1024, visitItems);
+		return;
+	}
+
+	auto visitBuckets = [&](uInt begin, uInt end)
+	{
+		for(uInt bucket = begin; bucket < end; bucket++)
+			neighboursInBucket(bucket, radius, visit);
+	};
+	if(pool == NULL)
+		visitBuckets(0, 1u << bucketBits);
+	else
+		pool->ParallelFor(1u << bucketBits, 2048, visitBuckets);
+}
+
+
+#endif
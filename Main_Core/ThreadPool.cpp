@@ -0,0 +1,138 @@
+#include "ThreadPool.h"
+
+
+ThreadPool::ThreadPool( uInt workerCount )
+{
+	generation = 0;
+	activeWorkers = 0;
+	stop = false;
+
+	task = NULL;
+	count = 0;
+	chunkSize = 1;
+	nextChunk = 0;
+
+	for( uInt i = 0; i < workerCount; i++ )
+	{
+		workers.push_back( std::thread( &ThreadPool::WorkerLoop, this ) );
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( stateMutex );
+		stop = true;
+	}
+	wake.notify_all();
+
+	for( uInt i = 0; i < workers.size(); i++ )
+	{
+		workers[i].join();
+	}
+}
+
+uInt ThreadPool::WorkerCount() const
+{
+	return (uInt)workers.size();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+	static ThreadPool pool( std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0 );
+
+	return pool;
+}
+
+Void ThreadPool::ParallelFor( uInt count, uInt grain, const RangeTask& task )
+{
+	if( count == 0 )
+	{
+		return;
+	}
+
+	if( grain == 0 )
+	{
+		grain = 1;
+	}
+
+	//Not worth waking anyone up
+	if( workers.empty() || count <= grain )
+	{
+		task( 0, count );
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock( submitMutex );
+
+	//aim for a few chunks per thread so uneven chunks balance out
+	uInt threads = (uInt)workers.size() + 1;
+	uInt chunk = ( count + threads * 4 - 1 ) / ( threads * 4 );
+
+	{
+		std::unique_lock<std::mutex> lock( stateMutex );
+
+		//a worker that woke late for the previous job may still be leaving it
+		idle.wait( lock, [this] { return activeWorkers == 0; } );
+
+		this->task = &task;
+		this->count = count;
+		this->chunkSize = chunk > grain ? chunk : grain;
+		this->nextChunk = 0;
+		generation++;
+	}
+	wake.notify_all();
+
+	RunChunks();
+
+	//every chunk has been claimed; wait for the workers still running theirs
+	std::unique_lock<std::mutex> lock( stateMutex );
+	idle.wait( lock, [this] { return activeWorkers == 0; } );
+	this->task = NULL;
+}
+
+Void ThreadPool::RunChunks()
+{
+	for( ;; )
+	{
+		uInt begin = nextChunk.fetch_add( chunkSize );
+
+		if( begin >= count )
+		{
+			break;
+		}
+
+		uInt end = count - begin > chunkSize ? begin + chunkSize : count;
+
+		( *task )( begin, end );
+	}
+}
+
+Void ThreadPool::WorkerLoop()
+{
+	uInt seen = 0;
+
+	for( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> lock( stateMutex );
+			wake.wait( lock, [this, seen] { return stop || generation != seen; } );
+
+			if( stop )
+			{
+				return;
+			}
+
+			seen = generation;
+			activeWorkers++;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock( stateMutex );
+			activeWorkers--;
+		}
+		idle.notify_all();
+	}
+}
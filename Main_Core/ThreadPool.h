@@ -0,0 +1,90 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include "Typedefs.h"
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+//Class ThreadPool
+//A fixed set of worker threads used to split data-parallel loops (batch transforms, AI updates, ...)
+//The calling thread takes part in the work, so a pool with 0 workers simply runs everything inline
+class ThreadPool
+{
+public:
+	//type of the work passed to ParallelFor; processes the items [begin, end)
+	typedef std::function<Void( uInt begin, uInt end )> RangeTask;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ThreadPool
+	// Parameters:	uInt
+	// Return:		None
+	// Description:	Starts workerCount worker threads
+	//////////////////////////////////////////////////////////////////////////
+	explicit ThreadPool( uInt workerCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		~ThreadPool
+	// Parameters:	None
+	// Return:		None
+	// Description:	Stops and joins all workers
+	//////////////////////////////////////////////////////////////////////////
+	~ThreadPool();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		WorkerCount
+	// Parameters:	None
+	// Return:		uInt
+	// Description:	Number of worker threads, not counting the caller
+	//////////////////////////////////////////////////////////////////////////
+	uInt WorkerCount() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ParallelFor
+	// Parameters:	(uInt, uInt, const RangeTask&)
+	// Return:		Void
+	// Description:	Splits [0, count) into chunks of at least grain items and runs task on
+	//				every chunk, blocking until all chunks are done.
+	//				Calls from different threads are serialized. A task must not call
+	//				ParallelFor on the same pool.
+	//////////////////////////////////////////////////////////////////////////
+	Void ParallelFor( uInt count, uInt grain, const RangeTask& task );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Shared
+	// Parameters:	None
+	// Return:		ThreadPool&
+	// Description:	Process wide pool with one worker per extra hardware thread
+	//////////////////////////////////////////////////////////////////////////
+	static ThreadPool& Shared();
+
+private:
+	ThreadPool( const ThreadPool& );
+	ThreadPool& operator=( const ThreadPool& );
+
+	Void WorkerLoop();
+	Void RunChunks();
+
+	std::vector<std::thread> workers;
+
+	std::mutex submitMutex;			// one ParallelFor at a time
+	std::mutex stateMutex;			// guards generation, activeWorkers and stop
+	std::condition_variable wake;	// signalled when a job is posted or the pool stops
+	std::condition_variable idle;	// signalled when the last busy worker leaves a job
+
+	uInt generation;
+	uInt activeWorkers;
+	Bool stop;
+
+	//the job currently being run
+	const RangeTask* task;
+	uInt count;
+	uInt chunkSize;
+	std::atomic<uInt> nextChunk;
+};
+
+#endif
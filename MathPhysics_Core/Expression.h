@@ -0,0 +1,223 @@
+#ifndef __MATHPHYSICS_EXPRESSION_H__
+#define __MATHPHYSICS_EXPRESSION_H__
+
+// Included by CoreMathPhysics.h ; include that header instead of this one.
+
+// Expression templates for the element-wise vector and matrix operators.
+// a*s + b - c does not build a temporary per operator: it builds a small tree of nodes that is only
+// evaluated when it is assigned to (or used to construct) a Vector or Matrix, in a single unrolled pass
+// that computes each element of the result once.
+// Because element i of the result only reads element i of the operands, assigning an expression to one
+// of its own operands ( v = v*s + w ) is safe.
+// Products that mix elements (Matrix * Vector, Matrix * Matrix, Cross_Product) are still evaluated
+// immediately, since doing them lazily would compute their operands more than once.
+
+#include <utility>
+
+template < Int N, class T > class Vector ;
+template < Int N, class T > class Matrix ;
+
+namespace MathDetail
+{
+	// compile time list 0, 1, ... N-1 ; expanding it unrolls a loop over the elements
+	template < Int N >
+	struct Indices
+	{
+		typedef std::make_index_sequence< N > Type ;
+	};
+
+	// a + b + c + ... folded at compile time ; for vectors the result is an expression
+	template < class A >
+	constexpr A Sum( const A& a )
+	{
+		return a ;
+	}
+
+	template < class A, class... Rest >
+	constexpr auto Sum( const A& a, const Rest&... rest )
+	{
+		return a + Sum( rest... ) ;
+	}
+
+	constexpr Bool All()
+	{
+		return true ;
+	}
+
+	template < class... Rest >
+	constexpr Bool All( Bool first, Rest... rest )
+	{
+		return first && All( rest... ) ;
+	}
+
+	// tag for the element-wise constructors
+	struct Elements {} ;
+}
+
+// base of every vector valued expression, including Vector itself
+template < class E >
+class VectorExpression
+{
+public:
+	constexpr const E& Self() const { return static_cast< const E& >( *this ) ; }
+
+	// the result as a Vector ; use this to call Vector members on an expression, e.g. ( a - b ).Eval().Length()
+	constexpr auto Eval() const { return Vector< E::size, typename E::Element >( Self() ) ; }
+
+	auto LengthSquared() const	{ return Eval().LengthSquared() ; }
+	auto Length() const			{ return Eval().Length() ; }
+	auto Normalized() const		{ return Eval().Normalized() ; }
+};
+
+// base of every matrix valued expression, including Matrix itself
+template < class E >
+class MatrixExpression
+{
+public:
+	constexpr const E& Self() const { return static_cast< const E& >( *this ) ; }
+};
+
+namespace MathDetail
+{
+	// Vectors and Matrices are held by reference ; the nodes are a few pointers and a scalar and are
+	// held by value, so an expression can be stored in an auto variable while its operands are alive
+	template < class E > struct Operand							{ typedef E Type ; } ;
+	template < Int N, class T > struct Operand< Vector< N, T > >	{ typedef const Vector< N, T >& Type ; } ;
+	template < Int N, class T > struct Operand< Matrix< N, T > >	{ typedef const Matrix< N, T >& Type ; } ;
+
+	struct Plus		{ template < class T > static constexpr T Apply( T a, T b ) { return a + b ; } } ;
+	struct Minus	{ template < class T > static constexpr T Apply( T a, T b ) { return a - b ; } } ;
+
+	// dot product of two vector expressions, expanded over the elements
+	template < class L, class R, std::size_t... I >
+	constexpr typename L::Element Dot( const L& l, const R& r, std::index_sequence< I... > )
+	{
+		return Sum( ( l.At( I ) * r.At( I ) )... ) ;
+	}
+}
+
+// l op r, element by element
+template < template < class > class Kind, class L, class R, class Op >
+class BinaryExpression : public Kind< BinaryExpression< Kind, L, R, Op > >
+{
+public:
+	typedef typename L::Element Element ;
+	static const Int size = L::size ;
+
+	constexpr BinaryExpression( const L& l, const R& r ) : left( l ), right( r )
+	{
+		static_assert( L::size == R::size, "operands must have the same dimensions" ) ;
+	}
+
+	constexpr Element At( Int i ) const { return Op::Apply( left.At( i ), right.At( i ) ) ; }
+	constexpr Element operator [] ( Int i ) const { return At( i ) ; }
+
+private:
+	typename MathDetail::Operand< L >::Type left ;
+	typename MathDetail::Operand< R >::Type right ;
+};
+
+// e * scalar ; negation and division are scaling by -1 and by the reciprocal
+template < template < class > class Kind, class E >
+class ScaledExpression : public Kind< ScaledExpression< Kind, E > >
+{
+public:
+	typedef typename E::Element Element ;
+	static const Int size = E::size ;
+
+	constexpr ScaledExpression( const E& e, Element s ) : operand( e ), scalar( s ) {}
+
+	constexpr Element At( Int i ) const { return operand.At( i ) * scalar ; }
+	constexpr Element operator [] ( Int i ) const { return At( i ) ; }
+
+private:
+	typename MathDetail::Operand< E >::Type operand ;
+	Element scalar ;
+};
+
+// vector operators
+
+template < class L, class R >
+constexpr BinaryExpression< VectorExpression, L, R, MathDetail::Plus > operator + ( const VectorExpression< L >& l, const VectorExpression< R >& r )
+{
+	return BinaryExpression< VectorExpression, L, R, MathDetail::Plus >( l.Self(), r.Self() ) ;
+}
+
+template < class L, class R >
+constexpr BinaryExpression< VectorExpression, L, R, MathDetail::Minus > operator - ( const VectorExpression< L >& l, const VectorExpression< R >& r )
+{
+	return BinaryExpression< VectorExpression, L, R, MathDetail::Minus >( l.Self(), r.Self() ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< VectorExpression, E > operator * ( const VectorExpression< E >& e, typename E::Element s )
+{
+	return ScaledExpression< VectorExpression, E >( e.Self(), s ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< VectorExpression, E > operator * ( typename E::Element s, const VectorExpression< E >& e )
+{
+	return ScaledExpression< VectorExpression, E >( e.Self(), s ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< VectorExpression, E > operator / ( const VectorExpression< E >& e, typename E::Element s )
+{
+	return ScaledExpression< VectorExpression, E >( e.Self(), typename E::Element( 1.0 ) / s ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< VectorExpression, E > operator - ( const VectorExpression< E >& e )
+{
+	return ScaledExpression< VectorExpression, E >( e.Self(), typename E::Element( -1.0 ) ) ;
+}
+
+// the Dot-Product ; fused with the expressions on either side
+template < class L, class R >
+constexpr typename L::Element operator * ( const VectorExpression< L >& l, const VectorExpression< R >& r )
+{
+	static_assert( L::size == R::size, "operands must have the same dimensions" ) ;
+	return MathDetail::Dot( l.Self(), r.Self(), std::make_index_sequence< L::size >() ) ;
+}
+
+// cross product ; evaluates both operands first
+template < class L, class R >
+constexpr auto operator % ( const VectorExpression< L >& l, const VectorExpression< R >& r )
+{
+	return l.Eval().Cross_Product( r.Eval() ) ;
+}
+
+// matrix operators ; the matrix product is a member of Matrix
+
+template < class L, class R >
+constexpr BinaryExpression< MatrixExpression, L, R, MathDetail::Plus > operator + ( const MatrixExpression< L >& l, const MatrixExpression< R >& r )
+{
+	return BinaryExpression< MatrixExpression, L, R, MathDetail::Plus >( l.Self(), r.Self() ) ;
+}
+
+template < class L, class R >
+constexpr BinaryExpression< MatrixExpression, L, R, MathDetail::Minus > operator - ( const MatrixExpression< L >& l, const MatrixExpression< R >& r )
+{
+	return BinaryExpression< MatrixExpression, L, R, MathDetail::Minus >( l.Self(), r.Self() ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< MatrixExpression, E > operator * ( const MatrixExpression< E >& e, typename E::Element s )
+{
+	return ScaledExpression< MatrixExpression, E >( e.Self(), s ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< MatrixExpression, E > operator * ( typename E::Element s, const MatrixExpression< E >& e )
+{
+	return ScaledExpression< MatrixExpression, E >( e.Self(), s ) ;
+}
+
+template < class E >
+constexpr ScaledExpression< MatrixExpression, E > operator - ( const MatrixExpression< E >& e )
+{
+	return ScaledExpression< MatrixExpression, E >( e.Self(), typename E::Element( -1.0 ) ) ;
+}
+
+#endif
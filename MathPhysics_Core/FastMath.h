@@ -0,0 +1,258 @@
+#ifndef __MATHPHYSICS_FASTMATH_H__
+#define __MATHPHYSICS_FASTMATH_H__
+
+#include "Typedefs.h"
+#include "SIMD.h"
+
+// Polynomial approximations of sin, cos and atan2 in single precision, for code that calls them per
+// object per frame (rotation builders, steering). They are opt-in: nothing uses them unless asked to.
+// Each function comes as a scalar version, 4-wide SSE and 8-wide AVX versions when SIMD.h enables
+// them, and a batch version over arrays. All widths run the same kernel and give the same results.
+//
+// Measured against double precision libm (tests/FastMathTest.cpp checks these bounds):
+//   SinCos    max absolute error 8e-8 for |angle| <= 8192, 1e-6 for |angle| <= 65536
+//   Atan2     max absolute error 2.75e-7 radians, for any finite x and y ; Atan2( 0, 0 ) == 0
+// NaN and infinite inputs give unspecified results.
+
+namespace FastMath
+{
+	// the operations each kernel needs, for one lane type ; code outside FastMath may use them to write
+	// one kernel for every width. Loads and stores are unaligned.
+	// width is the number of floats in V
+
+	struct ScalarLanes
+	{
+		typedef Float V ;
+		typedef Bool  Mask ;
+		static const uInt width = 1 ;
+
+		static V    Splat( Float a )				{ return a ; }
+		static V    Load( const Float* p )			{ return *p ; }
+		static Void Store( Float* p, V a )			{ *p = a ; }
+		static V    Sqrt( V a )						{ return sqrtf( a ) ; }
+		static V    Add( V a, V b )					{ return a + b ; }
+		static V    Sub( V a, V b )					{ return a - b ; }
+		static V    Mul( V a, V b )					{ return a * b ; }
+		static V    Div( V a, V b )					{ return a / b ; }
+		static V    Min( V a, V b )					{ return a < b ? a : b ; }
+		static V    Max( V a, V b )					{ return a > b ? a : b ; }
+		static V    Abs( V a )						{ return fabsf( a ) ; }
+		static Mask Less( V a, V b )				{ return a < b ; }
+		static Mask Equal( V a, V b )				{ return a == b ; }
+		static Mask Or( Mask a, Mask b )			{ return a || b ; }
+		static V    Select( Mask m, V a, V b )		{ return m ? a : b ; }
+	};
+
+#if defined( MATHPHYSICS_SSE )
+	struct SSELanes
+	{
+		typedef __m128 V ;
+		typedef __m128 Mask ;
+		static const uInt width = 4 ;
+
+		static V    Splat( Float a )				{ return _mm_set1_ps( a ) ; }
+		static V    Load( const Float* p )			{ return _mm_loadu_ps( p ) ; }
+		static Void Store( Float* p, V a )			{ _mm_storeu_ps( p, a ) ; }
+		static V    Sqrt( V a )						{ return _mm_sqrt_ps( a ) ; }
+		static V    Add( V a, V b )					{ return _mm_add_ps( a, b ) ; }
+		static V    Sub( V a, V b )					{ return _mm_sub_ps( a, b ) ; }
+		static V    Mul( V a, V b )					{ return _mm_mul_ps( a, b ) ; }
+		static V    Div( V a, V b )					{ return _mm_div_ps( a, b ) ; }
+		static V    Min( V a, V b )					{ return _mm_min_ps( a, b ) ; }
+		static V    Max( V a, V b )					{ return _mm_max_ps( a, b ) ; }
+		static V    Abs( V a )						{ return _mm_andnot_ps( _mm_set1_ps( -0.0f ), a ) ; }
+		static Mask Less( V a, V b )				{ return _mm_cmplt_ps( a, b ) ; }
+		static Mask Equal( V a, V b )				{ return _mm_cmpeq_ps( a, b ) ; }
+		static Mask Or( Mask a, Mask b )			{ return _mm_or_ps( a, b ) ; }
+		static V    Select( Mask m, V a, V b )		{ return _mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) ) ; }
+	};
+#endif
+
+#if defined( MATHPHYSICS_AVX )
+	struct AVXLanes
+	{
+		typedef __m256 V ;
+		typedef __m256 Mask ;
+		static const uInt width = 8 ;
+
+		static V    Splat( Float a )				{ return _mm256_set1_ps( a ) ; }
+		static V    Load( const Float* p )			{ return _mm256_loadu_ps( p ) ; }
+		static Void Store( Float* p, V a )			{ _mm256_storeu_ps( p, a ) ; }
+		static V    Sqrt( V a )						{ return _mm256_sqrt_ps( a ) ; }
+		static V    Add( V a, V b )					{ return _mm256_add_ps( a, b ) ; }
+		static V    Sub( V a, V b )					{ return _mm256_sub_ps( a, b ) ; }
+		static V    Mul( V a, V b )					{ return _mm256_mul_ps( a, b ) ; }
+		static V    Div( V a, V b )					{ return _mm256_div_ps( a, b ) ; }
+		static V    Min( V a, V b )					{ return _mm256_min_ps( a, b ) ; }
+		static V    Max( V a, V b )					{ return _mm256_max_ps( a, b ) ; }
+		static V    Abs( V a )						{ return _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), a ) ; }
+		static Mask Less( V a, V b )				{ return _mm256_cmp_ps( a, b, _CMP_LT_OQ ) ; }
+		static Mask Equal( V a, V b )				{ return _mm256_cmp_ps( a, b, _CMP_EQ_OQ ) ; }
+		static Mask Or( Mask a, Mask b )			{ return _mm256_or_ps( a, b ) ; }
+		static V    Select( Mask m, V a, V b )		{ return _mm256_blendv_ps( b, a, m ) ; }
+	};
+#endif
+
+	// round to the nearest integer without leaving floating point ; exact for |a| < 2^22
+	template < class L >
+	inline typename L::V Round( typename L::V a )
+	{
+		const typename L::V magic = L::Splat( 12582912.0f ) ;	// 1.5 * 2^23
+		return L::Sub( L::Add( a, magic ), magic ) ;
+	}
+
+	template < class L >
+	inline Void SinCosKernel( typename L::V angle, typename L::V& sin, typename L::V& cos )
+	{
+		typedef typename L::V V ;
+
+		// angle = quadrant * pi/2 + r with |r| <= pi/4 ; pi/2 is split in 3 parts so the reduction stays exact
+		V quadrant = Round< L >( L::Mul( angle, L::Splat( 0.63661977236758134f ) ) ) ;
+		V r = L::Sub( angle, L::Mul( quadrant, L::Splat( 1.5703125f ) ) ) ;
+		r = L::Sub( r, L::Mul( quadrant, L::Splat( 4.837512969970703125e-4f ) ) ) ;
+		r = L::Sub( r, L::Mul( quadrant, L::Splat( 7.54978995489188216e-8f ) ) ) ;
+
+		// minimax polynomials on [ -pi/4, pi/4 ]
+		V z = L::Mul( r, r ) ;
+		V s = L::Add( L::Mul( L::Splat( -1.9515295891e-4f ), z ), L::Splat( 8.3321608736e-3f ) ) ;
+		s = L::Add( L::Mul( s, z ), L::Splat( -1.6666654611e-1f ) ) ;
+		s = L::Add( L::Mul( L::Mul( s, z ), r ), r ) ;
+
+		V c = L::Add( L::Mul( L::Splat( 2.443315711809948e-5f ), z ), L::Splat( -1.388731625493765e-3f ) ) ;
+		c = L::Add( L::Mul( c, z ), L::Splat( 4.166664568298827e-2f ) ) ;
+		c = L::Add( L::Sub( L::Mul( L::Mul( c, z ), z ), L::Mul( L::Splat( 0.5f ), z ) ), L::Splat( 1.0f ) ) ;
+
+		// quadrant mod 4, as 0, 1, 2 or 3
+		V quarter = L::Mul( quadrant, L::Splat( 0.25f ) ) ;
+		V whole = Round< L >( quarter ) ;
+		whole = L::Sub( whole, L::Select( L::Less( quarter, whole ), L::Splat( 1.0f ), L::Splat( 0.0f ) ) ) ;
+		V q = L::Sub( quadrant, L::Mul( whole, L::Splat( 4.0f ) ) ) ;
+
+		typename L::Mask q1 = L::Equal( q, L::Splat( 1.0f ) ) ;
+		typename L::Mask q2 = L::Equal( q, L::Splat( 2.0f ) ) ;
+		typename L::Mask q3 = L::Equal( q, L::Splat( 3.0f ) ) ;
+
+		// quadrants 1 and 3 swap sin and cos ; sin is negative in 2 and 3, cos in 1 and 2
+		typename L::Mask swap = L::Or( q1, q3 ) ;
+		V sin_abs = L::Select( swap, c, s ) ;
+		V cos_abs = L::Select( swap, s, c ) ;
+		V zero = L::Splat( 0.0f ) ;
+
+		sin = L::Select( L::Or( q2, q3 ), L::Sub( zero, sin_abs ), sin_abs ) ;
+		cos = L::Select( L::Or( q1, q2 ), L::Sub( zero, cos_abs ), cos_abs ) ;
+	}
+
+	template < class L >
+	inline typename L::V Atan2Kernel( typename L::V y, typename L::V x )
+	{
+		typedef typename L::V V ;
+
+		// atan of the ratio of the smaller to the larger magnitude, in [ 0, 1 ]
+		V ax = L::Abs( x ) ;
+		V ay = L::Abs( y ) ;
+		V large = L::Max( ax, ay ) ;
+		V small = L::Min( ax, ay ) ;
+		V zero = L::Splat( 0.0f ) ;
+		V one = L::Splat( 1.0f ) ;
+		V t = L::Div( small, L::Select( L::Equal( large, zero ), one, large ) ) ;
+
+		// above tan( pi/8 ) use atan( t ) = pi/4 + atan( ( t - 1 ) / ( t + 1 ) )
+		typename L::Mask upper = L::Less( L::Splat( 0.41421356237309505f ), t ) ;
+		t = L::Select( upper, L::Div( L::Sub( t, one ), L::Add( t, one ) ), t ) ;
+		V offset = L::Select( upper, L::Splat( 0.78539816339744831f ), zero ) ;
+
+		// minimax polynomial on [ -tan( pi/8 ), tan( pi/8 ) ]
+		V z = L::Mul( t, t ) ;
+		V p = L::Add( L::Mul( L::Splat( 8.05374449538e-2f ), z ), L::Splat( -1.38776856032e-1f ) ) ;
+		p = L::Add( L::Mul( p, z ), L::Splat( 1.99777106478e-1f ) ) ;
+		p = L::Add( L::Mul( p, z ), L::Splat( -3.33329491539e-1f ) ) ;
+		V result = L::Add( L::Add( L::Mul( L::Mul( p, z ), t ), t ), offset ) ;
+
+		// back to the full circle
+		result = L::Select( L::Less( ax, ay ), L::Sub( L::Splat( 1.57079632679489662f ), result ), result ) ;
+		result = L::Select( L::Less( x, zero ), L::Sub( L::Splat( 3.14159265358979324f ), result ), result ) ;
+		return L::Select( L::Less( y, zero ), L::Sub( zero, result ), result ) ;
+	}
+
+	// scalar versions
+
+	inline Void SinCos( Float angle, Float& sin, Float& cos )
+	{
+		SinCosKernel< ScalarLanes >( angle, sin, cos ) ;
+	}
+
+	inline Float Sin( Float angle )
+	{
+		Float sin, cos ;
+		SinCos( angle, sin, cos ) ;
+		return sin ;
+	}
+
+	inline Float Cos( Float angle )
+	{
+		Float sin, cos ;
+		SinCos( angle, sin, cos ) ;
+		return cos ;
+	}
+
+	inline Float Atan2( Float y, Float x )
+	{
+		return Atan2Kernel< ScalarLanes >( y, x ) ;
+	}
+
+	// 4 and 8 wide versions
+
+#if defined( MATHPHYSICS_SSE )
+	inline Void   SinCos4( __m128 angle, __m128& sin, __m128& cos )	{ SinCosKernel< SSELanes >( angle, sin, cos ) ; }
+	inline __m128 Atan2_4( __m128 y, __m128 x )						{ return Atan2Kernel< SSELanes >( y, x ) ; }
+#endif
+
+#if defined( MATHPHYSICS_AVX )
+	inline Void   SinCos8( __m256 angle, __m256& sin, __m256& cos )	{ SinCosKernel< AVXLanes >( angle, sin, cos ) ; }
+	inline __m256 Atan2_8( __m256 y, __m256 x )						{ return Atan2Kernel< AVXLanes >( y, x ) ; }
+#endif
+
+	// batch versions ; the arrays need no particular alignment and the outputs may be the inputs
+
+	inline Void SinCos( const Float* angles, Float* sin, Float* cos, uInt count )
+	{
+		uInt i = 0 ;
+#if defined( MATHPHYSICS_AVX )
+		for ( ; i + 8 <= count ; i += 8 )
+		{
+			__m256 s, c ;
+			SinCos8( _mm256_loadu_ps( angles + i ), s, c ) ;
+			_mm256_storeu_ps( sin + i, s ) ;
+			_mm256_storeu_ps( cos + i, c ) ;
+		}
+#endif
+#if defined( MATHPHYSICS_SSE )
+		for ( ; i + 4 <= count ; i += 4 )
+		{
+			__m128 s, c ;
+			SinCos4( _mm_loadu_ps( angles + i ), s, c ) ;
+			_mm_storeu_ps( sin + i, s ) ;
+			_mm_storeu_ps( cos + i, c ) ;
+		}
+#endif
+		for ( ; i < count ; i++ )
+			SinCos( angles[i], sin[i], cos[i] ) ;
+	}
+
+	inline Void Atan2( const Float* y, const Float* x, Float* out, uInt count )
+	{
+		uInt i = 0 ;
+#if defined( MATHPHYSICS_AVX )
+		for ( ; i + 8 <= count ; i += 8 )
+			_mm256_storeu_ps( out + i, Atan2_8( _mm256_loadu_ps( y + i ), _mm256_loadu_ps( x + i ) ) ) ;
+#endif
+#if defined( MATHPHYSICS_SSE )
+		for ( ; i + 4 <= count ; i += 4 )
+			_mm_storeu_ps( out + i, Atan2_4( _mm_loadu_ps( y + i ), _mm_loadu_ps( x + i ) ) ) ;
+#endif
+		for ( ; i < count ; i++ )
+			out[i] = Atan2( y[i], x[i] ) ;
+	}
+}
+
+#endif
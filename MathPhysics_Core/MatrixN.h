@@ -0,0 +1,554 @@
+#ifndef __MATHPHYSICS_MATRIXN_H__
+#define __MATHPHYSICS_MATRIXN_H__
+
+// Included by CoreMathPhysics.h ; include that header instead of this one.
+
+#include <float.h>
+
+class ThreadPool ;
+
+namespace MathDetail
+{
+	// determinant and inverse for each size; the inverse is only written when the matrix is not singular
+	template < Int N, class T > struct Inversion ;
+
+	template < class T >
+	struct Inversion< 2, T >
+	{
+		static T Determinant( const Vector< 2, T >* m )
+		{
+			return m[X][X] * m[Y][Y] - m[X][Y] * m[Y][X] ;
+		}
+
+		static Bool Inverse( const Vector< 2, T >* m, Vector< 2, T >* result )
+		{
+			T determinant = Determinant( m ) ;
+			if ( fabs( determinant ) < FLT_MIN )
+				return false ;
+
+			T d = T( 1.0 ) / determinant ;
+			T a = m[X][X], b = m[X][Y], c = m[Y][X], e = m[Y][Y] ;
+
+			result[X][X] =  e * d ;
+			result[X][Y] = -b * d ;
+			result[Y][X] = -c * d ;
+			result[Y][Y] =  a * d ;
+			return true ;
+		}
+	};
+
+	template < class T >
+	struct Inversion< 3, T >
+	{
+		// the cyclic row/column order already gives the cofactor signs
+		static T Cofactor( const Vector< 3, T >* m, Int row, Int col )
+		{
+			Int row1 = ( row + 1 ) % 3, row2 = ( row + 2 ) % 3 ;
+			Int col1 = ( col + 1 ) % 3, col2 = ( col + 2 ) % 3 ;
+
+			return m[row1][col1] * m[row2][col2] - m[row1][col2] * m[row2][col1] ;
+		}
+
+		static T Determinant( const Vector< 3, T >* m )
+		{
+			return m[0][0] * Cofactor( m, 0, 0 ) + m[0][1] * Cofactor( m, 0, 1 ) + m[0][2] * Cofactor( m, 0, 2 ) ;
+		}
+
+		static Bool Inverse( const Vector< 3, T >* m, Vector< 3, T >* result )
+		{
+			T cofactor[3][3] ;
+
+			for ( Int row = 0 ; row < 3 ; row++ )
+				for ( Int col = 0 ; col < 3 ; col++ )
+					cofactor[row][col] = Cofactor( m, row, col ) ;
+
+			// reuse the first row of cofactors instead of calling Determinant()
+			T determinant = m[0][0] * cofactor[0][0] + m[0][1] * cofactor[0][1] + m[0][2] * cofactor[0][2] ;
+			if ( fabs( determinant ) < FLT_MIN )
+				return false ;
+
+			T d = T( 1.0 ) / determinant ;
+
+			for ( Int row = 0 ; row < 3 ; row++ )
+				for ( Int col = 0 ; col < 3 ; col++ )
+					result[col][row] = cofactor[row][col] * d ;
+
+			return true ;
+		}
+	};
+
+	template < class T >
+	struct Inversion< 4, T >
+	{
+		// Laplace expansion over the 2x2 minors of the top two (s) and bottom two (c) rows
+		struct Minors
+		{
+			T s[6], c[6] ;
+
+			explicit Minors( const Vector< 4, T >* m )
+			{
+				s[0] = m[0][0] * m[1][1] - m[1][0] * m[0][1] ;
+				s[1] = m[0][0] * m[1][2] - m[1][0] * m[0][2] ;
+				s[2] = m[0][0] * m[1][3] - m[1][0] * m[0][3] ;
+				s[3] = m[0][1] * m[1][2] - m[1][1] * m[0][2] ;
+				s[4] = m[0][1] * m[1][3] - m[1][1] * m[0][3] ;
+				s[5] = m[0][2] * m[1][3] - m[1][2] * m[0][3] ;
+
+				c[5] = m[2][2] * m[3][3] - m[3][2] * m[2][3] ;
+				c[4] = m[2][1] * m[3][3] - m[3][1] * m[2][3] ;
+				c[3] = m[2][1] * m[3][2] - m[3][1] * m[2][2] ;
+				c[2] = m[2][0] * m[3][3] - m[3][0] * m[2][3] ;
+				c[1] = m[2][0] * m[3][2] - m[3][0] * m[2][2] ;
+				c[0] = m[2][0] * m[3][1] - m[3][0] * m[2][1] ;
+			}
+
+			T Determinant() const
+			{
+				return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0] ;
+			}
+		};
+
+		static T Determinant( const Vector< 4, T >* m )
+		{
+			return Minors( m ).Determinant() ;
+		}
+
+		static Bool Inverse( const Vector< 4, T >* m, Vector< 4, T >* result )
+		{
+			Minors minors( m ) ;
+			const T* s = minors.s ;
+			const T* c = minors.c ;
+
+			T determinant = minors.Determinant() ;
+			if ( fabs( determinant ) < FLT_MIN )
+				return false ;
+
+			T d = T( 1.0 ) / determinant ;
+			Vector< 4, T > r[4] ;
+
+			r[0][0] = (  m[1][1] * c[5] - m[1][2] * c[4] + m[1][3] * c[3] ) * d ;
+			r[0][1] = ( -m[0][1] * c[5] + m[0][2] * c[4] - m[0][3] * c[3] ) * d ;
+			r[0][2] = (  m[3][1] * s[5] - m[3][2] * s[4] + m[3][3] * s[3] ) * d ;
+			r[0][3] = ( -m[2][1] * s[5] + m[2][2] * s[4] - m[2][3] * s[3] ) * d ;
+
+			r[1][0] = ( -m[1][0] * c[5] + m[1][2] * c[2] - m[1][3] * c[1] ) * d ;
+			r[1][1] = (  m[0][0] * c[5] - m[0][2] * c[2] + m[0][3] * c[1] ) * d ;
+			r[1][2] = ( -m[3][0] * s[5] + m[3][2] * s[2] - m[3][3] * s[1] ) * d ;
+			r[1][3] = (  m[2][0] * s[5] - m[2][2] * s[2] + m[2][3] * s[1] ) * d ;
+
+			r[2][0] = (  m[1][0] * c[4] - m[1][1] * c[2] + m[1][3] * c[0] ) * d ;
+			r[2][1] = ( -m[0][0] * c[4] + m[0][1] * c[2] - m[0][3] * c[0] ) * d ;
+			r[2][2] = (  m[3][0] * s[4] - m[3][1] * s[2] + m[3][3] * s[0] ) * d ;
+			r[2][3] = ( -m[2][0] * s[4] + m[2][1] * s[2] - m[2][3] * s[0] ) * d ;
+
+			r[3][0] = ( -m[1][0] * c[3] + m[1][1] * c[1] - m[1][2] * c[0] ) * d ;
+			r[3][1] = (  m[0][0] * c[3] - m[0][1] * c[1] + m[0][2] * c[0] ) * d ;
+			r[3][2] = ( -m[3][0] * s[3] + m[3][1] * s[1] - m[3][2] * s[0] ) * d ;
+			r[3][3] = (  m[2][0] * s[3] - m[2][1] * s[1] + m[2][2] * s[0] ) * d ;
+
+			for ( Int row = 0 ; row < 4 ; row++ ) result[row] = r[row] ;
+
+			return true ;
+		}
+	};
+}
+
+// N x N matrix of T, stored as N row vectors. Matrix2D, Matrix3D and Matrix4D are typedefs of this template.
+// Matrices transform column vectors: transformed = matrix * vector.
+// Like Vector, every operation is inline and unrolled over the rows and columns at compile time, and
+// functions that only make sense for one size (Translation, InverseAffine, ...) fail to compile for another.
+template < Int N, class T >
+class Matrix : public MatrixExpression< Matrix< N, T > >
+{
+public:
+	typedef T Element ;
+	typedef Vector< N, T > Row ;
+	typedef Vector< ( N == 4 ? 3 : N ), T > Spatial ;	// scaling vectors: a Vector2D for Matrix2D, a Vector3D for Matrix3D and Matrix4D
+
+	static const Int dimension = N ;
+	static const Int size = N * N ;
+	static const Int spatial_dimension = N == 4 ? 3 : N ;
+
+	constexpr Matrix() : m{} {}		// set to the zero matrix
+	explicit Matrix( UninitializedTag tag ) : Matrix( tag, Sequence() ) {}	// elements are left uninitialized
+
+	// set matrix columns to these 2 basis vectors
+	Matrix( const Vector< 2, T >& Bx, const Vector< 2, T >& By )
+	{
+		static_assert( N == 2, "this constructor is for Matrix2D" ) ;
+		for ( Int row = 0 ; row < N ; row++ ) { m[row][X] = Bx[row] ; m[row][Y] = By[row] ; }
+	}
+
+	// set matrix columns to these 3 basis vectors; for a Matrix4D the 4th column will be [0 0 0 1]
+	Matrix( const Vector< 3, T >& Bx, const Vector< 3, T >& By, const Vector< 3, T >& Bz )
+	{
+		static_assert( N == 3 || N == 4, "this constructor is for Matrix3D and Matrix4D" ) ;
+		Identity() ;
+		for ( Int row = 0 ; row < 3 ; row++ ) { m[row][X] = Bx[row] ; m[row][Y] = By[row] ; m[row][Z] = Bz[row] ; }
+	}
+
+	// set matrix columns to these basis vectors
+	Matrix( const Vector< 4, T >& Bx, const Vector< 4, T >& By, const Vector< 4, T >& Bz, const Vector< 4, T >& Bw )
+	{
+		static_assert( N == 4, "this constructor is for Matrix4D" ) ;
+		for ( Int row = 0 ; row < N ; row++ ) { m[row][X] = Bx[row] ; m[row][Y] = By[row] ; m[row][Z] = Bz[row] ; m[row][W] = Bw[row] ; }
+	}
+
+	// evaluate an element-wise expression such as a*s + b - c in one pass
+	template < class E >
+	constexpr Matrix( const MatrixExpression< E >& expression ) : Matrix( expression.Self(), Sequence() ) {}
+
+	template < class E >
+	constexpr Matrix& operator = ( const MatrixExpression< E >& expression )
+	{
+		return *this = Matrix( expression ) ;
+	}
+
+	// element access for the expression templates ; row-major
+	constexpr T At( Int index ) const { return m[index / N].v[index % N] ; }
+
+	// the N x N elements as a plain row-major array
+	T*       Data()       { return m[0].Data() ; }
+	const T* Data() const { return m[0].Data() ; }
+
+	// get a basis vector (column)
+	Row Basis( Int column ) const
+	{
+		Row result ;
+		for ( Int row = 0 ; row < N ; row++ ) result[row] = m[row][column] ;
+		return result ;
+	}
+
+	// set to the identity matrix
+	Void Identity()
+	{
+		for ( Int row = 0 ; row < N ; row++ )
+		{
+			m[row] = Row() ;
+			m[row][row] = T( 1.0 ) ;
+		}
+	}
+
+	// set to a scaling matrix ; a Matrix4D only scales x, y and z
+	Void Scaling( T uniform_scale )
+	{
+		Identity() ;
+		for ( Int i = 0 ; i < spatial_dimension ; i++ ) m[i][i] = uniform_scale ;
+	}
+
+	Void Scaling( const Spatial& scaling )
+	{
+		Identity() ;
+		for ( Int i = 0 ; i < spatial_dimension ; i++ ) m[i][i] = scaling[i] ;
+	}
+
+	// set to a rotation matrix about X, Y or Z ; a Matrix2D can only rotate about Z
+	Void Rotation( Double radians, Int axis = Z )
+	{
+		T cos = (T) std::cos( radians ) ;
+		T sin = (T) std::sin( radians ) ;
+
+		Identity() ;
+		Set_Rotation( cos, sin, axis ) ;
+	}
+
+	// Rotation() using FastMath::SinCos instead of the double precision library ; each element is within 8e-8 of the exact one
+	Void FastRotation( Scalar radians, Int axis = Z )
+	{
+		Float sin, cos ;
+		FastMath::SinCos( radians, sin, cos ) ;
+
+		Identity() ;
+		Set_Rotation( T( cos ), T( sin ), axis ) ;
+	}
+
+	// set to a 2D shear matrix
+	Void Shearing( const Vector< 2, T >& shearing )
+	{
+		static_assert( N == 2, "use Shearing( shearing, axis ) for Matrix3D and Matrix4D" ) ;
+		Identity() ;
+		m[0][1] = shearing[0] ;
+		m[1][0] = shearing[1] ;
+	}
+
+	// set to a shear matrix along the given axis
+	Void Shearing( const Vector< 2, T >& shearing, Int axis )
+	{
+		static_assert( N == 3 || N == 4, "use Shearing( shearing ) for Matrix2D" ) ;
+		Identity() ;
+		switch ( axis )
+		{
+			case Z:
+				m[X][Z] = shearing[0] ;
+				m[Y][Z] = shearing[1] ;
+				break ;
+			case Y:
+				m[Z][Y] = shearing[0] ;
+				m[X][Y] = shearing[1] ;
+				break ;
+			case X:
+				m[Y][X] = shearing[0] ;
+				m[Z][X] = shearing[1] ;
+				break ;
+			default:
+				assert( false ) ;
+				break ;
+		}
+	}
+
+	// set to a 3D translation matrix
+	Void Translation( const Vector< 3, T >& translation )
+	{
+		static_assert( N == 4, "Translation is for Matrix4D" ) ;
+		Identity() ;
+		for ( Int i = 0 ; i < N-1 ; i++ ) m[i][W] = translation[i] ;
+	}
+
+	// multiply by a new scaling, rotation, shearing or translation matrix
+	Void Scale( T uniform_scale )								{ Matrix s ; s.Scaling( uniform_scale ) ; *this *= s ; }
+	Void Scale( const Spatial& scale )							{ Matrix s ; s.Scaling( scale ) ; *this *= s ; }
+	Void Rotate( Double angle, Int axis = Z )					{ Matrix r ; r.Rotation( angle, axis ) ; *this *= r ; }
+	Void FastRotate( Scalar angle, Int axis = Z )				{ Matrix r ; r.FastRotation( angle, axis ) ; *this *= r ; }
+	Void Shear( const Vector< 2, T >& shear )					{ Matrix s ; s.Shearing( shear ) ; *this *= s ; }
+	Void Shear( const Vector< 2, T >& shear, Int axis )		{ Matrix s ; s.Shearing( shear, axis ) ; *this *= s ; }
+	Void Translate( const Vector< 3, T >& translation )		{ Matrix t ; t.Translation( translation ) ; *this *= t ; }
+	Void Translate( const Vector< 4, T >& translation )		{ Translate( translation.ToVector3D() ) ; }
+
+	// matrix addition, subtraction and scaling are in Expression.h
+	template < class E > constexpr Void operator += ( const MatrixExpression< E >& other )	{ *this = *this + other ; }
+	template < class E > constexpr Void operator -= ( const MatrixExpression< E >& other )	{ *this = *this - other ; }
+
+	constexpr Matrix operator * ( const Matrix& other ) const	{ return Multiply( other, Sequence() ) ; }	// matrix multiplication
+	constexpr Void operator *= ( const Matrix& other )			{ *this = other * *this ; }	// pre-multiply: this = other * this
+
+	// matrix * vector. Used to transform vertices
+	constexpr Row operator * ( const Row& vector ) const		{ return Transform( vector, Sequence() ) ; }
+
+	// vector * matrix ; e.g transforming a plane
+	friend constexpr Row operator * ( const Row& vector, const Matrix& matrix )	{ return matrix.Combine( vector ) ; }
+
+	// vector = matrix * vector
+	friend constexpr Void operator *= ( Row& vector, const Matrix& matrix )	{ vector = matrix * vector ; }
+
+	// batch transforms over contiguous arrays; in and out may be the same array.
+	// If a pool is given the array is split across its worker threads.
+	// The 3D forms treat the matrix as affine: the bottom row is ignored and no perspective divide is done.
+	// These are only implemented for Matrix4D (Matrix4D.cpp).
+	Void TransformPoints    ( const Vector< 3, T >* in, Vector< 3, T >* out, uInt count, ThreadPool* pool = NULL ) const ;	// w == 1
+	Void TransformDirections( const Vector< 3, T >* in, Vector< 3, T >* out, uInt count, ThreadPool* pool = NULL ) const ;	// w == 0
+	Void TransformPoints    ( const T* x, const T* y, const T* z,
+							  T* outX, T* outY, T* outZ, uInt count, ThreadPool* pool = NULL ) const ;	// structure-of-arrays, w == 1
+	Void TransformDirections( const T* x, const T* y, const T* z,
+							  T* outX, T* outY, T* outZ, uInt count, ThreadPool* pool = NULL ) const ;	// structure-of-arrays, w == 0
+	Void Transform          ( const Vector< 4, T >* in, Vector< 4, T >* out, uInt count, ThreadPool* pool = NULL ) const ;	// matrix * vector
+	Void TransformPlanes    ( const Vector< 4, T >* in, Vector< 4, T >* out, uInt count, ThreadPool* pool = NULL ) const ;	// plane * matrix ; use the inverse of the point transform
+
+	// the inverses are reentrant and safe to call from several threads at once
+	T Determinant() const
+	{
+		return MathDetail::Inversion< N, T >::Determinant( m ) ;
+	}
+
+	// returns false and leaves result untouched if the matrix is singular
+	Bool Inverse( Matrix& result ) const
+	{
+		return MathDetail::Inversion< N, T >::Inverse( m, result.m ) ;
+	}
+
+	// returns a new matrix that is the inverse of this matrix ; asserts if singular
+	Matrix Inverse() const
+	{
+		Matrix result ;
+		if ( !Inverse( result ) )
+		{
+			assert( false ) ;	// singular matrix; use Inverse( result ) to test for this
+			result.Identity() ;
+		}
+		return result ;
+	}
+
+	// faster inverse when the bottom row is [0 0 0 1] ; returns false and leaves result untouched if singular
+	Bool InverseAffine( Matrix& result ) const
+	{
+		static_assert( N == 4, "InverseAffine is for Matrix4D" ) ;
+
+		// the inverse of [ L t ; 0 1 ] is [ L^-1  -L^-1*t ; 0 1 ]
+		Vector< 3, T > linear[3] = { m[X].ToVector3D(), m[Y].ToVector3D(), m[Z].ToVector3D() } ;
+		Vector< 3, T > inverse[3] ;
+		if ( !MathDetail::Inversion< 3, T >::Inverse( linear, inverse ) )
+			return false ;
+
+		for ( Int row = 0 ; row < 3 ; row++ )
+			result.m[row] = Row( inverse[row], -( inverse[row][X] * m[X][W] + inverse[row][Y] * m[Y][W] + inverse[row][Z] * m[Z][W] ) ) ;
+		result.m[W] = Row( 0.0, 0.0, 0.0, 1.0 ) ;
+
+		return true ;
+	}
+
+	// asserts if singular
+	Matrix InverseAffine() const
+	{
+		Matrix result ;
+		if ( !InverseAffine( result ) )
+		{
+			assert( false ) ;	// singular matrix; use InverseAffine( result ) to test for this
+			result.Identity() ;
+		}
+		return result ;
+	}
+
+	// fastest inverse when the matrix is only a rotation and a translation
+	Matrix InverseRigid() const
+	{
+		static_assert( N == 4, "InverseRigid is for Matrix4D" ) ;
+
+		// the inverse of [ R t ; 0 1 ] is [ R^T  -R^T*t ; 0 1 ]
+		Matrix result ;
+		for ( Int row = 0 ; row < 3 ; row++ )
+		{
+			for ( Int col = 0 ; col < 3 ; col++ )
+				result.m[row][col] = m[col][row] ;
+
+			result.m[row][W] = -( m[X][row] * m[X][W] + m[Y][row] * m[Y][W] + m[Z][row] * m[Z][W] ) ;
+		}
+		result.m[W][W] = T( 1.0 ) ;
+		return result ;
+	}
+
+	// inverts this matrix in place
+	Void Invert()
+	{
+		*this = Inverse() ;
+	}
+
+	constexpr Matrix Transpose() const	{ return Transposed( Sequence() ) ; }
+
+	// sum of diagonal elements
+	constexpr T Trace() const			{ return DiagonalSum( Sequence() ) ; }
+
+	constexpr Bool operator == ( const Matrix& other ) const	{ return Equal( other, Sequence() ) ; }
+	constexpr Bool operator != ( const Matrix& other ) const	{ return ! (*this == other) ; }
+
+	// return an identity matrix to be used in comparisions with other matrices
+	static const Matrix& Identity_Matrix()
+	{
+		static const Matrix identity_matrix = Make_Identity() ;
+		return identity_matrix ;
+	}
+
+private:
+	friend class Quaternion ;
+
+	typedef typename MathDetail::Indices< N >::Type Sequence ;
+
+	static Matrix Make_Identity()
+	{
+		Matrix identity ;
+		identity.Identity() ;
+		return identity ;
+	}
+
+	Void Set_Rotation( T cos, T sin, Int axis )
+	{
+		assert( N != 2 || axis == Z ) ;	// 2D rotations are about Z
+
+		switch ( axis )
+		{
+			case X:
+				m[Y][Y] =  cos ;
+				m[Y][Z] = -sin ;
+				m[Z][Y] =  sin ;
+				m[Z][Z] =  cos ;
+				break ;
+
+			case Y:
+				m[Z][Z] =  cos ;
+				m[Z][X] = -sin ;
+				m[X][Z] =  sin ;
+				m[X][X] =  cos ;
+				break ;
+
+			case Z:
+				m[X][X] =  cos ;
+				m[X][Y] = -sin ;
+				m[Y][X] =  sin ;
+				m[Y][Y] =  cos ;
+				break ;
+			default:
+				assert( false ) ;
+				break ;
+		}
+	}
+
+	// row-wise constructor used by the unrolled operations
+	template < class... R >
+	constexpr Matrix( MathDetail::Elements, const R&... rows ) : m{ rows... } {}
+
+	template < std::size_t... I >
+	Matrix( UninitializedTag tag, std::index_sequence< I... > ) : m{ ( (Void) I, Row( tag ) )... } {}
+
+	template < class E, std::size_t... I >
+	constexpr Matrix( const E& expression, std::index_sequence< I... > ) : m{ Expression_Row( expression, I, Sequence() )... } {}
+
+	template < class E, std::size_t... J >
+	static constexpr Row Expression_Row( const E& expression, Int row, std::index_sequence< J... > )	{ return Row( MathDetail::Elements(), expression.At( row * N + J )... ) ; }
+
+	// sum of the rows weighted by the elements of vector ( vector * this )
+	constexpr Row Combine( const Row& vector ) const	{ return Combine( vector, Sequence() ) ; }
+
+	// sum of the rows of other weighted by the elements of vector ( vector * other )
+	template < std::size_t... K > constexpr Row Combine( const Row& vector, std::index_sequence< K... > ) const	{ return Row( MathDetail::Sum( ( m[K] * vector.v[K] )... ) ) ; }
+
+	template < std::size_t... I > constexpr Matrix Multiply( const Matrix& o, std::index_sequence< I... > ) const	{ return Matrix( MathDetail::Elements(), o.Combine( m[I], Sequence() )... ) ; }
+	template < std::size_t... I > constexpr Row    Transform( const Row& v, std::index_sequence< I... > ) const		{ return Row( MathDetail::Elements(), ( m[I] * v )... ) ; }
+	template < std::size_t... I > constexpr Row    Column( Int c, std::index_sequence< I... > ) const				{ return Row( MathDetail::Elements(), m[I].v[c]... ) ; }
+	template < std::size_t... I > constexpr Matrix Transposed( std::index_sequence< I... > ) const				{ return Matrix( MathDetail::Elements(), Column( I, Sequence() )... ) ; }
+	template < std::size_t... I > constexpr T      DiagonalSum( std::index_sequence< I... > ) const				{ return MathDetail::Sum( m[I].v[I]... ) ; }
+	template < std::size_t... I > constexpr Bool   Equal( const Matrix& o, std::index_sequence< I... > ) const		{ return MathDetail::All( ( m[I] == o.m[I] )... ) ; }
+
+	Row m[N] ;	// rows ; for Matrix4D they are 16-byte aligned and contiguous, so Data() is a row-major 4x4 array
+};
+
+// SIMD versions for Matrix4D ; these are not constexpr
+
+template <> inline Matrix< 4, Float > Matrix< 4, Float >::operator * ( const Matrix< 4, Float >& other ) const
+{
+	Matrix result ;
+	SIMD::MatrixMultiply4( Data(), other.Data(), result.Data() ) ;
+	return result ;
+}
+
+template <> inline Void Matrix< 4, Float >::operator *= ( const Matrix< 4, Float >& other )
+{
+	// pre-multiplies: this = other * this
+	SIMD::MatrixMultiply4( other.Data(), Data(), Data() ) ;
+}
+
+template <> inline Vector< 4, Float > Matrix< 4, Float >::operator * ( const Vector< 4, Float >& vector ) const
+{
+	Vector< 4, Float > result ;
+	SIMD::MatrixVector4( Data(), vector.Data(), result.Data() ) ;
+	return result ;
+}
+
+template <> inline Vector< 4, Float > Matrix< 4, Float >::Combine( const Vector< 4, Float >& vector ) const
+{
+	// vector * matrix
+	Vector< 4, Float > result ;
+	SIMD::VectorMatrix4( vector.Data(), Data(), result.Data() ) ;
+	return result ;
+}
+
+template <> inline Bool Matrix< 4, Float >::Inverse( Matrix< 4, Float >& result ) const
+{
+	return !( fabs( SIMD::Inverse4( Data(), result.Data() ) ) < FLT_MIN ) ;
+}
+
+template <> Void Matrix< 4, Float >::TransformPoints( const Vector< 3, Float >* in, Vector< 3, Float >* out, uInt count, ThreadPool* pool ) const ;
+template <> Void Matrix< 4, Float >::TransformDirections( const Vector< 3, Float >* in, Vector< 3, Float >* out, uInt count, ThreadPool* pool ) const ;
+template <> Void Matrix< 4, Float >::TransformPoints( const Float* x, const Float* y, const Float* z, Float* outX, Float* outY, Float* outZ, uInt count, ThreadPool* pool ) const ;
+template <> Void Matrix< 4, Float >::TransformDirections( const Float* x, const Float* y, const Float* z, Float* outX, Float* outY, Float* outZ, uInt count, ThreadPool* pool ) const ;
+template <> Void Matrix< 4, Float >::Transform( const Vector< 4, Float >* in, Vector< 4, Float >* out, uInt count, ThreadPool* pool ) const ;
+template <> Void Matrix< 4, Float >::TransformPlanes( const Vector< 4, Float >* in, Vector< 4, Float >* out, uInt count, ThreadPool* pool ) const ;
+
+#endif
@@ -0,0 +1,324 @@
+#include "Typedefs.h"
+#include <assert.h>
+#include "CoreMathPhysics.h"
+#include "ThreadPool.h"
+
+Quaternion:: Quaternion()
+{
+	Identity() ;
+}
+
+Quaternion:: Quaternion( Double x, Double y, Double z, Double w )
+{
+	q[X] = (Scalar) x ;
+	q[Y] = (Scalar) y ;
+	q[Z] = (Scalar) z ;
+	q[W] = (Scalar) w ;
+}
+
+Quaternion:: Quaternion( const Vector3D& axis, Double angle )
+{
+	Scalar sin = (Scalar) std::sin( angle * 0.5 ) ;
+
+	q[X] = axis[X] * sin ;
+	q[Y] = axis[Y] * sin ;
+	q[Z] = axis[Z] * sin ;
+	q[W] = (Scalar) std::cos( angle * 0.5 ) ;
+}
+
+// Shepperd's method: divide by the largest of w, x, y, z to keep the result accurate
+template < class Rows >
+static Void From_Rotation( const Rows& m, Scalar* q )
+{
+	Scalar trace = m[X][X] + m[Y][Y] + m[Z][Z] ;
+
+	if ( trace > 0.0f )
+	{
+		Scalar s = 0.5f / std::sqrt( trace + 1.0f ) ;
+		q[W] = 0.25f / s ;
+		q[X] = ( m[Z][Y] - m[Y][Z] ) * s ;
+		q[Y] = ( m[X][Z] - m[Z][X] ) * s ;
+		q[Z] = ( m[Y][X] - m[X][Y] ) * s ;
+	}
+	else if ( m[X][X] > m[Y][Y] && m[X][X] > m[Z][Z] )
+	{
+		Scalar s = 2.0f * std::sqrt( 1.0f + m[X][X] - m[Y][Y] - m[Z][Z] ) ;
+		q[W] = ( m[Z][Y] - m[Y][Z] ) / s ;
+		q[X] = 0.25f * s ;
+		q[Y] = ( m[X][Y] + m[Y][X] ) / s ;
+		q[Z] = ( m[X][Z] + m[Z][X] ) / s ;
+	}
+	else if ( m[Y][Y] > m[Z][Z] )
+	{
+		Scalar s = 2.0f * std::sqrt( 1.0f + m[Y][Y] - m[X][X] - m[Z][Z] ) ;
+		q[W] = ( m[X][Z] - m[Z][X] ) / s ;
+		q[X] = ( m[X][Y] + m[Y][X] ) / s ;
+		q[Y] = 0.25f * s ;
+		q[Z] = ( m[Y][Z] + m[Z][Y] ) / s ;
+	}
+	else
+	{
+		Scalar s = 2.0f * std::sqrt( 1.0f + m[Z][Z] - m[X][X] - m[Y][Y] ) ;
+		q[W] = ( m[Y][X] - m[X][Y] ) / s ;
+		q[X] = ( m[X][Z] + m[Z][X] ) / s ;
+		q[Y] = ( m[Y][Z] + m[Z][Y] ) / s ;
+		q[Z] = 0.25f * s ;
+	}
+}
+
+Quaternion:: Quaternion( const Matrix3D& rotation )
+{
+	From_Rotation( rotation.m, q ) ;
+}
+
+Quaternion:: Quaternion( const Matrix4D& rotation )
+{
+	From_Rotation( rotation.m, q ) ;
+}
+
+Scalar& Quaternion::operator []( Int index )
+{
+	assert( index >= 0 && index < 4 ) ;
+	return q[index] ;
+}
+
+Scalar Quaternion::operator []( Int index ) const
+{
+	assert( index >= 0 && index < 4 ) ;
+	return q[index] ;
+}
+
+Void Quaternion::Identity()
+{
+	q[X] = q[Y] = q[Z] = 0.0f ;
+	q[W] = 1.0f ;
+}
+
+Void Quaternion::Rotation( Double radians, Int axis )
+{
+	assert( axis >= X && axis <= Z ) ;
+
+	Identity() ;
+	q[axis] = (Scalar) std::sin( radians * 0.5 ) ;
+	q[W]    = (Scalar) std::cos( radians * 0.5 ) ;
+}
+
+Void Quaternion::Rotate( Double angle, Int axis )
+{
+	Quaternion rotation ;
+	rotation.Rotation( angle, axis ) ;
+	*this = rotation * *this ;
+}
+
+Scalar Quaternion::Length() const
+{
+	return std::sqrt( SIMD::Dot4( q, q ) ) ;
+}
+
+Void Quaternion::Normalize()
+{
+	Scalar length = Length() ;
+	if ( length > epsilon )	// do not divide is length is really small
+		SIMD::Scale4( q, Scalar( 1.0 ) / length, q ) ;
+}
+
+Quaternion Quaternion::Normalized() const
+{
+	Quaternion result( *this ) ;
+	result.Normalize() ;
+	return result ;
+}
+
+Quaternion Quaternion::Conjugate() const
+{
+	return Quaternion( -q[X], -q[Y], -q[Z], q[W] ) ;
+}
+
+Quaternion Quaternion::Inverse() const
+{
+	Quaternion result = Conjugate() ;
+	SIMD::Scale4( result.q, Scalar( 1.0 ) / SIMD::Dot4( q, q ), result.q ) ;
+	return result ;
+}
+
+Quaternion Quaternion::operator * ( const Quaternion& other ) const
+{
+	const Scalar* a = q ;
+	const Scalar* b = other.q ;
+	Quaternion result ;
+
+	result.q[X] = a[W] * b[X] + a[X] * b[W] + a[Y] * b[Z] - a[Z] * b[Y] ;
+	result.q[Y] = a[W] * b[Y] - a[X] * b[Z] + a[Y] * b[W] + a[Z] * b[X] ;
+	result.q[Z] = a[W] * b[Z] + a[X] * b[Y] - a[Y] * b[X] + a[Z] * b[W] ;
+	result.q[W] = a[W] * b[W] - a[X] * b[X] - a[Y] * b[Y] - a[Z] * b[Z] ;
+
+	return result ;
+}
+
+Void Quaternion::operator *= ( const Quaternion& other )
+{
+	*this = *this * other ;
+}
+
+Vector3D Quaternion::operator * ( const Vector3D& vector ) const
+{
+	// v' = v + 2w( u x v ) + 2u x ( u x v ) where u is the vector part
+	Scalar tx = 2.0f * ( q[Y] * vector[Z] - q[Z] * vector[Y] ) ;
+	Scalar ty = 2.0f * ( q[Z] * vector[X] - q[X] * vector[Z] ) ;
+	Scalar tz = 2.0f * ( q[X] * vector[Y] - q[Y] * vector[X] ) ;
+
+	return Vector3D( vector[X] + q[W] * tx + q[Y] * tz - q[Z] * ty,
+					 vector[Y] + q[W] * ty + q[Z] * tx - q[X] * tz,
+					 vector[Z] + q[W] * tz + q[X] * ty - q[Y] * tx ) ;
+}
+
+Quaternion Quaternion::operator + ( const Quaternion& other ) const
+{
+	Quaternion result ;
+	SIMD::Add4( q, other.q, result.q ) ;
+	return result ;
+}
+
+Quaternion Quaternion::operator - ( const Quaternion& other ) const
+{
+	Quaternion result ;
+	SIMD::Sub4( q, other.q, result.q ) ;
+	return result ;
+}
+
+Quaternion Quaternion::operator * ( Scalar scalar ) const
+{
+	Quaternion result ;
+	SIMD::Scale4( q, scalar, result.q ) ;
+	return result ;
+}
+
+Quaternion Quaternion::operator - ( Void ) const
+{
+	return Quaternion( -q[X], -q[Y], -q[Z], -q[W] ) ;
+}
+
+Scalar Quaternion::Dot( const Quaternion& other ) const
+{
+	return SIMD::Dot4( q, other.q ) ;
+}
+
+Matrix3D Quaternion::ToMatrix3D() const
+{
+	Matrix3D result ;
+
+	Scalar xx = q[X] * q[X], yy = q[Y] * q[Y], zz = q[Z] * q[Z] ;
+	Scalar xy = q[X] * q[Y], xz = q[X] * q[Z], yz = q[Y] * q[Z] ;
+	Scalar wx = q[W] * q[X], wy = q[W] * q[Y], wz = q[W] * q[Z] ;
+
+	result.m[X][X] = 1.0f - 2.0f * ( yy + zz ) ;
+	result.m[X][Y] = 2.0f * ( xy - wz ) ;
+	result.m[X][Z] = 2.0f * ( xz + wy ) ;
+
+	result.m[Y][X] = 2.0f * ( xy + wz ) ;
+	result.m[Y][Y] = 1.0f - 2.0f * ( xx + zz ) ;
+	result.m[Y][Z] = 2.0f * ( yz - wx ) ;
+
+	result.m[Z][X] = 2.0f * ( xz - wy ) ;
+	result.m[Z][Y] = 2.0f * ( yz + wx ) ;
+	result.m[Z][Z] = 1.0f - 2.0f * ( xx + yy ) ;
+
+	return result ;
+}
+
+Matrix4D Quaternion::ToMatrix4D() const
+{
+	Matrix4D result ;
+	Matrix3D rotation = ToMatrix3D() ;
+
+	for ( Int row = 0 ; row < 3 ; row++ )
+		for ( Int col = 0 ; col < 3 ; col++ )
+			result.m[row][col] = rotation.m[row][col] ;
+	result.m[W][W] = 1.0f ;
+
+	return result ;
+}
+
+Quaternion Quaternion::Nlerp( const Quaternion& a, const Quaternion& b, Scalar t )
+{
+	// flip b if needed so the blend takes the shortest arc
+	Scalar weight_b = a.Dot( b ) < 0.0f ? -t : t ;
+
+	Quaternion result = a * ( 1.0f - t ) + b * weight_b ;
+	result.Normalize() ;
+	return result ;
+}
+
+Quaternion Quaternion::Slerp( const Quaternion& a, const Quaternion& b, Scalar t )
+{
+	Scalar cos = a.Dot( b ) ;
+	Scalar sign = 1.0f ;
+	if ( cos < 0.0f ) { cos = -cos ; sign = -1.0f ; }
+
+	// nearly the same rotation: sin( angle ) is too small to divide by
+	if ( cos > 1.0f - epsilon )
+		return Nlerp( a, b, t ) ;
+
+	Scalar angle = std::acos( cos ) ;
+	Scalar one_over_sin = 1.0f / std::sin( angle ) ;
+	Scalar weight_a = std::sin( ( 1.0f - t ) * angle ) * one_over_sin ;
+	Scalar weight_b = std::sin( t * angle ) * one_over_sin * sign ;
+
+	return a * weight_a + b * weight_b ;
+}
+
+// arrays shorter than this are not worth splitting across threads
+static const uInt slerp_grain = 2048 ;
+
+Void Quaternion::Slerp( const Quaternion* a, const Quaternion* b, const Scalar* t, Quaternion* out, uInt count, ThreadPool* pool )
+{
+	if ( count == 0 )
+		return ;
+
+	if ( pool == NULL )
+	{
+		SIMD::SlerpArray4( a[0].q, b[0].q, t, 1, out[0].q, count ) ;
+		return ;
+	}
+
+	pool->ParallelFor( count, slerp_grain, [=]( uInt begin, uInt end ) {
+		SIMD::SlerpArray4( a[begin].q, b[begin].q, t + begin, 1, out[begin].q, end - begin ) ;
+	} ) ;
+}
+
+Void Quaternion::Slerp( const Quaternion* a, const Quaternion* b, Scalar t, Quaternion* out, uInt count, ThreadPool* pool )
+{
+	if ( count == 0 )
+		return ;
+
+	if ( pool == NULL )
+	{
+		SIMD::SlerpArray4( a[0].q, b[0].q, &t, 0, out[0].q, count ) ;
+		return ;
+	}
+
+	pool->ParallelFor( count, slerp_grain, [=, &t]( uInt begin, uInt end ) {
+		SIMD::SlerpArray4( a[begin].q, b[begin].q, &t, 0, out[begin].q, end - begin ) ;
+	} ) ;
+}
+
+Bool Quaternion:: operator == ( const Quaternion& other ) const
+{
+	Bool result = true ;
+
+	for ( Int i = 0 ; i < dimension ; i++ )
+		result &= q[i] == other.q[i] ;
+	return result ;
+}
+
+Bool Quaternion:: operator != ( const Quaternion& other ) const
+{
+	return ! (*this == other) ;
+}
+
+const Quaternion& Quaternion:: Identity_Quaternion()
+{
+	static Quaternion identity_quaternion ;
+
+	return identity_quaternion ;
+}
@@ -0,0 +1,178 @@
+#include "Typedefs.h"
+#include <assert.h>
+#include <atomic>
+#include "Random.h"
+
+// splitmix64 ; spreads a seed over the state so that similar seeds give unrelated sequences
+static uInt64 Split_Mix( uInt64& x )
+{
+	uInt64 z = ( x += 0x9E3779B97F4A7C15ULL ) ;
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL ;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL ;
+	return z ^ ( z >> 31 ) ;
+}
+
+static inline uInt Rotate_Left( uInt x, Int k )
+{
+	return ( x << k ) | ( x >> ( 32 - k ) ) ;
+}
+
+// the top 24 bits as a float in [ 0, 1 )
+static inline Float To_Float01( uInt x )
+{
+	return ( x >> 8 ) * ( 1.0f / 16777216.0f ) ;
+}
+
+// the state words of one generator, taken from the splitmix sequence x
+static Void Fill_State( uInt64& x, uInt* s0, uInt* s1, uInt* s2, uInt* s3 )
+{
+	uInt64 a = Split_Mix( x ) ;
+	uInt64 b = Split_Mix( x ) ;
+
+	*s0 = (uInt) a ;
+	*s1 = (uInt) ( a >> 32 ) ;
+	*s2 = (uInt) b ;
+	*s3 = (uInt) ( b >> 32 ) ;
+
+	// xoshiro must not start from an all zero state
+	if ( ( *s0 | *s1 | *s2 | *s3 ) == 0 ) *s0 = 1 ;
+}
+
+Random:: Random( uInt64 seed, uInt64 stream )
+{
+	Seed( seed, stream ) ;
+}
+
+Void Random::Seed( uInt64 seed, uInt64 stream )
+{
+	uInt64 x = seed ^ Split_Mix( stream ) ;
+
+	Fill_State( x, &s[0], &s[1], &s[2], &s[3] ) ;
+	for ( Int lane = 0 ; lane < 4 ; lane++ )
+		Fill_State( x, &lanes[0][lane], &lanes[1][lane], &lanes[2][lane], &lanes[3][lane] ) ;
+}
+
+Void Random::Seed_State( uInt64 seed, uInt64 stream, uInt state[4] )
+{
+	uInt64 x = seed ^ Split_Mix( stream ) ;
+
+	Fill_State( x, &state[0], &state[1], &state[2], &state[3] ) ;
+}
+
+// one xoshiro128+ step
+static inline uInt Next_Bits( uInt& s0, uInt& s1, uInt& s2, uInt& s3 )
+{
+	uInt result = s0 + s3 ;
+	uInt t = s1 << 9 ;
+
+	s2 ^= s0 ;
+	s3 ^= s1 ;
+	s1 ^= s2 ;
+	s0 ^= s3 ;
+	s2 ^= t ;
+	s3 = Rotate_Left( s3, 11 ) ;
+
+	return result ;
+}
+
+uInt Random::Next()
+{
+	return Next_Bits( s[0], s[1], s[2], s[3] ) ;
+}
+
+Float Random::Next01()
+{
+	return To_Float01( Next() ) ;
+}
+
+Float Random::NextBinomial()
+{
+	// the draws are taken in order; the operands of - may be evaluated either way round
+	Float first = Next01() ;
+	Float second = Next01() ;
+	return first - second ;
+}
+
+Float Random::Range( Float min, Float max )
+{
+	return min + ( max - min ) * Next01() ;
+}
+
+Float Random::Step( uInt& s0, uInt& s1, uInt& s2, uInt& s3 )
+{
+	return To_Float01( Next_Bits( s0, s1, s2, s3 ) ) ;
+}
+
+Void Random::Step4( uInt* s0, uInt* s1, uInt* s2, uInt* s3, Float* out )
+{
+#if defined( MATHPHYSICS_SSE2 )
+	__m128i w0 = _mm_loadu_si128( (const __m128i*) s0 ) ;
+	__m128i w1 = _mm_loadu_si128( (const __m128i*) s1 ) ;
+	__m128i w2 = _mm_loadu_si128( (const __m128i*) s2 ) ;
+	__m128i w3 = _mm_loadu_si128( (const __m128i*) s3 ) ;
+
+	__m128i result = _mm_add_epi32( w0, w3 ) ;
+	__m128i t = _mm_slli_epi32( w1, 9 ) ;
+
+	w2 = _mm_xor_si128( w2, w0 ) ;
+	w3 = _mm_xor_si128( w3, w1 ) ;
+	w1 = _mm_xor_si128( w1, w2 ) ;
+	w0 = _mm_xor_si128( w0, w3 ) ;
+	w2 = _mm_xor_si128( w2, t ) ;
+	w3 = _mm_or_si128( _mm_slli_epi32( w3, 11 ), _mm_srli_epi32( w3, 21 ) ) ;
+
+	_mm_storeu_si128( (__m128i*) s0, w0 ) ;
+	_mm_storeu_si128( (__m128i*) s1, w1 ) ;
+	_mm_storeu_si128( (__m128i*) s2, w2 ) ;
+	_mm_storeu_si128( (__m128i*) s3, w3 ) ;
+
+	// the top 24 bits fit in a signed int, so the signed conversion is exact
+	__m128 floats = _mm_cvtepi32_ps( _mm_srli_epi32( result, 8 ) ) ;
+	_mm_storeu_ps( out, _mm_mul_ps( floats, _mm_set1_ps( 1.0f / 16777216.0f ) ) ) ;
+#else
+	for ( Int i = 0 ; i < 4 ; i++ )
+		out[i] = Step( s0[i], s1[i], s2[i], s3[i] ) ;
+#endif
+}
+
+Void Random::Next4( Float* out )
+{
+	Step4( lanes[0], lanes[1], lanes[2], lanes[3], out ) ;
+}
+
+Void Random::Fill01( Float* out, uInt count )
+{
+	uInt i = 0 ;
+	for ( ; i + 4 <= count ; i += 4 )
+		Next4( out + i ) ;
+
+	if ( i < count )
+	{
+		Float last[4] ;
+		Next4( last ) ;
+		for ( uInt j = 0 ; i + j < count ; j++ )
+			out[i + j] = last[j] ;
+	}
+}
+
+Void Random::FillBinomial( Float* out, uInt count )
+{
+	Float a[4], b[4] ;
+
+	for ( uInt i = 0 ; i < count ; i += 4 )
+	{
+		Next4( a ) ;
+		Next4( b ) ;
+
+		for ( uInt j = 0 ; j < 4 && i + j < count ; j++ )
+			out[i + j] = a[j] - b[j] ;
+	}
+}
+
+Random& Random::ThreadLocal()
+{
+	static std::atomic< uInt64 > next_stream( 0 ) ;
+	thread_local Random generator( default_seed, next_stream++ ) ;
+
+	return generator ;
+}
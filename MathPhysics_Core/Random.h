@@ -0,0 +1,53 @@
+#ifndef __MATHPHYSICS_RANDOM_H__
+#define __MATHPHYSICS_RANDOM_H__
+
+#include "Typedefs.h"
+#include "SIMD.h"
+
+// Small, fast pseudo random number generator (xoshiro128+) with its state in the object.
+// Give each agent, or each thread, its own Random: there is no shared state and no locking.
+// The same seed and stream always give the same sequence, on every platform and with or without SIMD,
+// so a parallel update that draws from per-agent generators is reproducible.
+// Not suitable for cryptography.
+class Random
+{
+public:
+	// different streams of the same seed are independent sequences ; e.g. use the agent's id as the stream
+	explicit Random( uInt64 seed = default_seed, uInt64 stream = 0 ) ;
+
+	Void Seed( uInt64 seed, uInt64 stream = 0 ) ;
+
+	uInt  Next() ;							// uniform over all 32 bit values
+	Float Next01() ;						// uniform in [ 0, 1 )
+	Float NextBinomial() ;					// in ( -1, 1 ), more likely near 0
+	Float Range( Float min, Float max ) ;	// uniform in [ min, max )
+
+	// fill an array with uniform floats in [ 0, 1 ) or binomial floats in ( -1, 1 ), 4 at a time.
+	// These draw from 4 separate lanes, not from the sequence of Next(), and always use a multiple of 4
+	// numbers from each lane, so the result only depends on the seed and the counts requested.
+	Void Fill01( Float* out, uInt count ) ;
+	Void FillBinomial( Float* out, uInt count ) ;
+
+	// a generator for the calling thread ; each thread gets the next stream of default_seed the first time
+	// it calls this, so the numbers depend on which thread gets there first.
+	// Use per-agent generators when the results must be reproducible.
+	static Random& ThreadLocal() ;
+
+	static const uInt64 default_seed = 0x853C49E6748FEA9BULL ;
+
+	// The generator without the object, for systems that keep the state of many generators in arrays.
+	// Seed_State gives the same state as Random( seed, stream ) ; Step gives the same numbers as Next01().
+	// Step4 advances 4 generators whose state words are stored in 4 arrays (s0[0..3] is word 0 of each),
+	// and writes one number in [ 0, 1 ) per generator.
+	static Void  Seed_State( uInt64 seed, uInt64 stream, uInt state[4] ) ;
+	static Float Step( uInt& s0, uInt& s1, uInt& s2, uInt& s3 ) ;
+	static Void  Step4( uInt* s0, uInt* s1, uInt* s2, uInt* s3, Float* out ) ;
+
+private:
+	Void Next4( Float* out ) ;	// one number in [ 0, 1 ) from each lane
+
+	uInt s[4] ;									// state of Next()
+	MATHPHYSICS_ALIGN( 16 ) uInt lanes[4][4] ;	// state of the 4 lanes, word by word: lanes[word][lane]
+};
+
+#endif
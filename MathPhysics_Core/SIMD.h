@@ -0,0 +1,535 @@
+#ifndef __MATHPHYSICS_SIMD_H__
+#define __MATHPHYSICS_SIMD_H__
+
+#include "Typedefs.h"
+#include <math.h>
+
+// 4-wide kernels used by Vector4D and Matrix4D.
+// The instruction set is picked at compile time: AVX when the compiler targets it, SSE on any x86/x64 target,
+// and a plain unrolled scalar fallback everywhere else. Define MATHPHYSICS_NO_SIMD to force the scalar path.
+// All pointers passed to these functions must be 16-byte aligned (Vector4D and Matrix4D guarantee this).
+// Matrices are 16 Scalars stored row by row, the same layout as Matrix4D::m.
+
+#if !defined( MATHPHYSICS_NO_SIMD ) && ( defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) )
+	#define MATHPHYSICS_SSE 1
+	#include <xmmintrin.h>
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#define MATHPHYSICS_SSE2 1	// 4-wide integer operations
+		#include <emmintrin.h>
+	#endif
+	#if defined( __AVX__ )
+		#define MATHPHYSICS_AVX 1
+		#include <immintrin.h>
+	#endif
+#endif
+
+#if defined( _MSC_VER )
+	#define MATHPHYSICS_ALIGN( bytes ) __declspec( align( bytes ) )
+#else
+	#define MATHPHYSICS_ALIGN( bytes ) __attribute__( ( aligned( bytes ) ) )
+#endif
+
+namespace SIMD
+{
+
+#if defined( MATHPHYSICS_SSE )
+
+	// sum of the 4 lanes, broadcast to every lane
+	inline __m128 HorizontalSum( __m128 a )
+	{
+		__m128 shuffled = _mm_shuffle_ps( a, a, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ;
+		__m128 sums     = _mm_add_ps( a, shuffled ) ;
+		shuffled        = _mm_shuffle_ps( sums, sums, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ;
+		return _mm_add_ps( sums, shuffled ) ;
+	}
+
+	// result = a * b, both row-major; 4 broadcasts and 4 multiply-adds per row
+	inline __m128 LinearCombine( __m128 a, const Scalar* b )
+	{
+		__m128 result = _mm_mul_ps( _mm_shuffle_ps( a, a, 0x00 ), _mm_load_ps( b + 0 ) ) ;
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( a, a, 0x55 ), _mm_load_ps( b + 4 ) ) ) ;
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( a, a, 0xAA ), _mm_load_ps( b + 8 ) ) ) ;
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( a, a, 0xFF ), _mm_load_ps( b + 12 ) ) ) ;
+		return result ;
+	}
+
+#endif
+
+	inline Void Add4( const Scalar* a, const Scalar* b, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		_mm_store_ps( result, _mm_add_ps( _mm_load_ps( a ), _mm_load_ps( b ) ) ) ;
+#else
+		result[0] = a[0] + b[0] ; result[1] = a[1] + b[1] ;
+		result[2] = a[2] + b[2] ; result[3] = a[3] + b[3] ;
+#endif
+	}
+
+	inline Void Sub4( const Scalar* a, const Scalar* b, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		_mm_store_ps( result, _mm_sub_ps( _mm_load_ps( a ), _mm_load_ps( b ) ) ) ;
+#else
+		result[0] = a[0] - b[0] ; result[1] = a[1] - b[1] ;
+		result[2] = a[2] - b[2] ; result[3] = a[3] - b[3] ;
+#endif
+	}
+
+	inline Void Scale4( const Scalar* a, Scalar scalar, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		_mm_store_ps( result, _mm_mul_ps( _mm_load_ps( a ), _mm_set1_ps( scalar ) ) ) ;
+#else
+		result[0] = a[0] * scalar ; result[1] = a[1] * scalar ;
+		result[2] = a[2] * scalar ; result[3] = a[3] * scalar ;
+#endif
+	}
+
+	inline Scalar Dot4( const Scalar* a, const Scalar* b )
+	{
+#if defined( MATHPHYSICS_SSE )
+		return _mm_cvtss_f32( HorizontalSum( _mm_mul_ps( _mm_load_ps( a ), _mm_load_ps( b ) ) ) ) ;
+#else
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] ;
+#endif
+	}
+
+	// cross product of the xyz parts; the w of the result is 0
+	inline Void Cross3( const Scalar* a, const Scalar* b, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		__m128 va = _mm_load_ps( a ) ;
+		__m128 vb = _mm_load_ps( b ) ;
+		__m128 a_yzx = _mm_shuffle_ps( va, va, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ;
+		__m128 b_yzx = _mm_shuffle_ps( vb, vb, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ;
+		__m128 c = _mm_sub_ps( _mm_mul_ps( va, b_yzx ), _mm_mul_ps( a_yzx, vb ) ) ;
+		// c holds (z, x, y, w) ; rotate back into place. w is a.w * b.w - a.w * b.w, which is not
+		// exactly 0 when the compiler fuses it into a multiply-add, so it is cleared
+		__m128 r = _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ;
+		__m128 z0 = _mm_unpackhi_ps( r, _mm_setzero_ps() ) ;	// (z, 0, w, 0)
+		_mm_store_ps( result, _mm_shuffle_ps( r, z0, _MM_SHUFFLE( 1, 0, 1, 0 ) ) ) ;
+#else
+		Scalar x = a[1] * b[2] - b[1] * a[2] ;
+		Scalar y = a[2] * b[0] - b[2] * a[0] ;
+		Scalar z = a[0] * b[1] - b[0] * a[1] ;
+		result[0] = x ; result[1] = y ; result[2] = z ; result[3] = 0.0f ;
+#endif
+	}
+
+	// result = a * b ; result may alias a or b
+	inline Void MatrixMultiply4( const Scalar* a, const Scalar* b, Scalar* result )
+	{
+#if defined( MATHPHYSICS_AVX )
+		// two rows of the result per 8-wide register
+		__m256 b0 = _mm256_broadcast_ps( (const __m128*)( b + 0 ) ) ;
+		__m256 b1 = _mm256_broadcast_ps( (const __m128*)( b + 4 ) ) ;
+		__m256 b2 = _mm256_broadcast_ps( (const __m128*)( b + 8 ) ) ;
+		__m256 b3 = _mm256_broadcast_ps( (const __m128*)( b + 12 ) ) ;
+		// matrices are only 16-byte aligned, so the 8-wide loads and stores must be unaligned ones
+		__m256 a01 = _mm256_loadu_ps( a + 0 ) ;
+		__m256 a23 = _mm256_loadu_ps( a + 8 ) ;
+
+		__m256 r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x00 ), b0 ) ;
+		r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x55 ), b1 ) ) ;
+		r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xAA ), b2 ) ) ;
+		r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xFF ), b3 ) ) ;
+
+		__m256 r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x00 ), b0 ) ;
+		r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x55 ), b1 ) ) ;
+		r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xAA ), b2 ) ) ;
+		r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xFF ), b3 ) ) ;
+
+		_mm256_storeu_ps( result + 0, r01 ) ;
+		_mm256_storeu_ps( result + 8, r23 ) ;
+#elif defined( MATHPHYSICS_SSE )
+		__m128 r0 = LinearCombine( _mm_load_ps( a + 0 ), b ) ;
+		__m128 r1 = LinearCombine( _mm_load_ps( a + 4 ), b ) ;
+		__m128 r2 = LinearCombine( _mm_load_ps( a + 8 ), b ) ;
+		__m128 r3 = LinearCombine( _mm_load_ps( a + 12 ), b ) ;
+		_mm_store_ps( result + 0, r0 ) ;
+		_mm_store_ps( result + 4, r1 ) ;
+		_mm_store_ps( result + 8, r2 ) ;
+		_mm_store_ps( result + 12, r3 ) ;
+#else
+		Scalar tmp[16] ;
+		for ( Int row = 0 ; row < 4 ; row++ )
+		{
+			const Scalar* r = a + row * 4 ;
+			tmp[row*4+0] = r[0] * b[0] + r[1] * b[4] + r[2] * b[8]  + r[3] * b[12] ;
+			tmp[row*4+1] = r[0] * b[1] + r[1] * b[5] + r[2] * b[9]  + r[3] * b[13] ;
+			tmp[row*4+2] = r[0] * b[2] + r[1] * b[6] + r[2] * b[10] + r[3] * b[14] ;
+			tmp[row*4+3] = r[0] * b[3] + r[1] * b[7] + r[2] * b[11] + r[3] * b[15] ;
+		}
+		for ( Int i = 0 ; i < 16 ; i++ ) result[i] = tmp[i] ;
+#endif
+	}
+
+	// result = m * v (column vector) ; result may alias v
+	inline Void MatrixVector4( const Scalar* m, const Scalar* v, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		__m128 vv = _mm_load_ps( v ) ;
+		__m128 r0 = _mm_mul_ps( _mm_load_ps( m + 0 ),  vv ) ;
+		__m128 r1 = _mm_mul_ps( _mm_load_ps( m + 4 ),  vv ) ;
+		__m128 r2 = _mm_mul_ps( _mm_load_ps( m + 8 ),  vv ) ;
+		__m128 r3 = _mm_mul_ps( _mm_load_ps( m + 12 ), vv ) ;
+		// transpose the 4 products so that the 4 horizontal sums become 3 vertical adds
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 ) ;
+		_mm_store_ps( result, _mm_add_ps( _mm_add_ps( r0, r1 ), _mm_add_ps( r2, r3 ) ) ) ;
+#else
+		Scalar x = m[0]  * v[0] + m[1]  * v[1] + m[2]  * v[2] + m[3]  * v[3] ;
+		Scalar y = m[4]  * v[0] + m[5]  * v[1] + m[6]  * v[2] + m[7]  * v[3] ;
+		Scalar z = m[8]  * v[0] + m[9]  * v[1] + m[10] * v[2] + m[11] * v[3] ;
+		Scalar w = m[12] * v[0] + m[13] * v[1] + m[14] * v[2] + m[15] * v[3] ;
+		result[0] = x ; result[1] = y ; result[2] = z ; result[3] = w ;
+#endif
+	}
+
+	// result = v * m (row vector) ; result may alias v
+	inline Void VectorMatrix4( const Scalar* v, const Scalar* m, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		_mm_store_ps( result, LinearCombine( _mm_load_ps( v ), m ) ) ;
+#else
+		Scalar x = v[0] * m[0] + v[1] * m[4] + v[2] * m[8]  + v[3] * m[12] ;
+		Scalar y = v[0] * m[1] + v[1] * m[5] + v[2] * m[9]  + v[3] * m[13] ;
+		Scalar z = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + v[3] * m[14] ;
+		Scalar w = v[0] * m[3] + v[1] * m[7] + v[2] * m[11] + v[3] * m[15] ;
+		result[0] = x ; result[1] = y ; result[2] = z ; result[3] = w ;
+#endif
+	}
+
+	// general 4x4 inverse by 2x2 block cofactors.
+	// Returns the determinant; result is only written when the determinant is not 0 (or denormal).
+	// result may alias m.
+	inline Scalar Inverse4( const Scalar* m, Scalar* result )
+	{
+#if defined( MATHPHYSICS_SSE )
+		#define MP_SHUFFLE( a, b, x, y, z, w )	_mm_shuffle_ps( a, b, (x) | ((y) << 2) | ((z) << 4) | ((w) << 6) )
+		#define MP_SWIZZLE( v, x, y, z, w )		MP_SHUFFLE( v, v, x, y, z, w )
+
+		// each __m128 below holds a 2x2 block as (m00, m01, m10, m11)
+		struct Block2
+		{
+			static __m128 Mul( __m128 a, __m128 b )		// a * b
+			{
+				return _mm_add_ps( _mm_mul_ps( a, MP_SWIZZLE( b, 0, 3, 0, 3 ) ), _mm_mul_ps( MP_SWIZZLE( a, 1, 0, 3, 2 ), MP_SWIZZLE( b, 2, 1, 2, 1 ) ) ) ;
+			}
+			static __m128 AdjMul( __m128 a, __m128 b )	// adjugate( a ) * b
+			{
+				return _mm_sub_ps( _mm_mul_ps( MP_SWIZZLE( a, 3, 3, 0, 0 ), b ), _mm_mul_ps( MP_SWIZZLE( a, 1, 1, 2, 2 ), MP_SWIZZLE( b, 2, 3, 0, 1 ) ) ) ;
+			}
+			static __m128 MulAdj( __m128 a, __m128 b )	// a * adjugate( b )
+			{
+				return _mm_sub_ps( _mm_mul_ps( a, MP_SWIZZLE( b, 3, 0, 3, 0 ) ), _mm_mul_ps( MP_SWIZZLE( a, 1, 0, 3, 2 ), MP_SWIZZLE( b, 2, 1, 2, 1 ) ) ) ;
+			}
+		} ;
+
+		__m128 r0 = _mm_load_ps( m + 0 ) ;
+		__m128 r1 = _mm_load_ps( m + 4 ) ;
+		__m128 r2 = _mm_load_ps( m + 8 ) ;
+		__m128 r3 = _mm_load_ps( m + 12 ) ;
+
+		// [ A B ]
+		// [ C D ]
+		__m128 A = _mm_movelh_ps( r0, r1 ) ;
+		__m128 B = _mm_movehl_ps( r1, r0 ) ;
+		__m128 C = _mm_movelh_ps( r2, r3 ) ;
+		__m128 D = _mm_movehl_ps( r3, r2 ) ;
+
+		// determinants of A, B, C and D
+		__m128 det_sub = _mm_sub_ps( _mm_mul_ps( MP_SHUFFLE( r0, r2, 0, 2, 0, 2 ), MP_SHUFFLE( r1, r3, 1, 3, 1, 3 ) ),
+									 _mm_mul_ps( MP_SHUFFLE( r0, r2, 1, 3, 1, 3 ), MP_SHUFFLE( r1, r3, 0, 2, 0, 2 ) ) ) ;
+		__m128 det_A = MP_SWIZZLE( det_sub, 0, 0, 0, 0 ) ;
+		__m128 det_B = MP_SWIZZLE( det_sub, 1, 1, 1, 1 ) ;
+		__m128 det_C = MP_SWIZZLE( det_sub, 2, 2, 2, 2 ) ;
+		__m128 det_D = MP_SWIZZLE( det_sub, 3, 3, 3, 3 ) ;
+
+		__m128 D_C = Block2::AdjMul( D, C ) ;
+		__m128 A_B = Block2::AdjMul( A, B ) ;
+
+		__m128 X_ = _mm_sub_ps( _mm_mul_ps( det_D, A ), Block2::Mul( B, D_C ) ) ;
+		__m128 W_ = _mm_sub_ps( _mm_mul_ps( det_A, D ), Block2::Mul( C, A_B ) ) ;
+		__m128 Y_ = _mm_sub_ps( _mm_mul_ps( det_B, C ), Block2::MulAdj( D, A_B ) ) ;
+		__m128 Z_ = _mm_sub_ps( _mm_mul_ps( det_C, B ), Block2::MulAdj( A, D_C ) ) ;
+
+		__m128 det = _mm_add_ps( _mm_mul_ps( det_A, det_D ), _mm_mul_ps( det_B, det_C ) ) ;
+		det = _mm_sub_ps( det, HorizontalSum( _mm_mul_ps( A_B, MP_SWIZZLE( D_C, 0, 2, 1, 3 ) ) ) ) ;
+
+		Scalar determinant = _mm_cvtss_f32( det ) ;
+		if ( fabs( determinant ) < 1.17549435e-38f )	// FLT_MIN
+			return determinant ;
+
+		__m128 one_over_det = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det ) ;
+		X_ = _mm_mul_ps( X_, one_over_det ) ;
+		Y_ = _mm_mul_ps( Y_, one_over_det ) ;
+		Z_ = _mm_mul_ps( Z_, one_over_det ) ;
+		W_ = _mm_mul_ps( W_, one_over_det ) ;
+
+		_mm_store_ps( result + 0,  MP_SHUFFLE( X_, Y_, 3, 1, 3, 1 ) ) ;
+		_mm_store_ps( result + 4,  MP_SHUFFLE( X_, Y_, 2, 0, 2, 0 ) ) ;
+		_mm_store_ps( result + 8,  MP_SHUFFLE( Z_, W_, 3, 1, 3, 1 ) ) ;
+		_mm_store_ps( result + 12, MP_SHUFFLE( Z_, W_, 2, 0, 2, 0 ) ) ;
+
+		#undef MP_SWIZZLE
+		#undef MP_SHUFFLE
+
+		return determinant ;
+#else
+		// 2x2 determinants of the top two rows (s) and of the bottom two rows (c)
+		Scalar s0 = m[0] * m[5] - m[4] * m[1] ;
+		Scalar s1 = m[0] * m[6] - m[4] * m[2] ;
+		Scalar s2 = m[0] * m[7] - m[4] * m[3] ;
+		Scalar s3 = m[1] * m[6] - m[5] * m[2] ;
+		Scalar s4 = m[1] * m[7] - m[5] * m[3] ;
+		Scalar s5 = m[2] * m[7] - m[6] * m[3] ;
+
+		Scalar c5 = m[10] * m[15] - m[14] * m[11] ;
+		Scalar c4 = m[9]  * m[15] - m[13] * m[11] ;
+		Scalar c3 = m[9]  * m[14] - m[13] * m[10] ;
+		Scalar c2 = m[8]  * m[15] - m[12] * m[11] ;
+		Scalar c1 = m[8]  * m[14] - m[12] * m[10] ;
+		Scalar c0 = m[8]  * m[13] - m[12] * m[9] ;
+
+		Scalar determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0 ;
+		if ( fabs( determinant ) < 1.17549435e-38f )	// FLT_MIN
+			return determinant ;
+
+		Scalar d = 1.0f / determinant ;
+		Scalar tmp[16] ;
+
+		tmp[0]  = (  m[5]  * c5 - m[6]  * c4 + m[7]  * c3 ) * d ;
+		tmp[1]  = ( -m[1]  * c5 + m[2]  * c4 - m[3]  * c3 ) * d ;
+		tmp[2]  = (  m[13] * s5 - m[14] * s4 + m[15] * s3 ) * d ;
+		tmp[3]  = ( -m[9]  * s5 + m[10] * s4 - m[11] * s3 ) * d ;
+
+		tmp[4]  = ( -m[4]  * c5 + m[6]  * c2 - m[7]  * c1 ) * d ;
+		tmp[5]  = (  m[0]  * c5 - m[2]  * c2 + m[3]  * c1 ) * d ;
+		tmp[6]  = ( -m[12] * s5 + m[14] * s2 - m[15] * s1 ) * d ;
+		tmp[7]  = (  m[8]  * s5 - m[10] * s2 + m[11] * s1 ) * d ;
+
+		tmp[8]  = (  m[4]  * c4 - m[5]  * c2 + m[7]  * c0 ) * d ;
+		tmp[9]  = ( -m[0]  * c4 + m[1]  * c2 - m[3]  * c0 ) * d ;
+		tmp[10] = (  m[12] * s4 - m[13] * s2 + m[15] * s0 ) * d ;
+		tmp[11] = ( -m[8]  * s4 + m[9]  * s2 - m[11] * s0 ) * d ;
+
+		tmp[12] = ( -m[4]  * c3 + m[5]  * c1 - m[6]  * c0 ) * d ;
+		tmp[13] = (  m[0]  * c3 - m[1]  * c1 + m[2]  * c0 ) * d ;
+		tmp[14] = ( -m[12] * s3 + m[13] * s1 - m[14] * s0 ) * d ;
+		tmp[15] = (  m[8]  * s3 - m[9]  * s1 + m[10] * s0 ) * d ;
+
+		for ( Int i = 0 ; i < 16 ; i++ ) result[i] = tmp[i] ;
+
+		return determinant ;
+#endif
+	}
+
+	// Slerp without trig (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP").
+	// The slerp weights sin(t*a)/sin(a) and sin((1-t)*a)/sin(a) are evaluated as a polynomial in cos(a);
+	// the last coefficients are tuned to minimize the error. Measured against a double precision slerp the
+	// weights are within 1e-6 for rotations up to 120 degrees apart, and within 2e-5 up to 180 degrees.
+	static const Scalar slerp_mu = 1.85298109240830f ;
+	static const Scalar slerp_u[8] = { 1.0f/(1*3), 1.0f/(2*5), 1.0f/(3*7), 1.0f/(4*9), 1.0f/(5*11), 1.0f/(6*13), 1.0f/(7*15), slerp_mu/(8*17) } ;
+	static const Scalar slerp_v[8] = { 1.0f/3, 2.0f/5, 3.0f/7, 4.0f/9, 5.0f/11, 6.0f/13, 7.0f/15, slerp_mu*8/17 } ;
+
+	// weights of a and b for slerp( a, b, t ) where x is dot( a, b ) ; flips b to take the shortest arc
+	inline Void SlerpWeights( Scalar x, Scalar t, Scalar& weight_a, Scalar& weight_b )
+	{
+		Scalar sign = 1.0f ;
+		if ( x < 0.0f ) { x = -x ; sign = -1.0f ; }
+
+		Scalar x_minus_1 = x - 1.0f ;
+		Scalar d = 1.0f - t ;
+		Scalar sqr_t = t * t ;
+		Scalar sqr_d = d * d ;
+
+		Scalar poly_t = 1.0f, poly_d = 1.0f ;
+		for ( Int i = 7 ; i >= 0 ; i-- )
+		{
+			poly_t = 1.0f + ( slerp_u[i] * sqr_t - slerp_v[i] ) * x_minus_1 * poly_t ;
+			poly_d = 1.0f + ( slerp_u[i] * sqr_d - slerp_v[i] ) * x_minus_1 * poly_d ;
+		}
+
+		weight_a = d * poly_d ;
+		weight_b = sign * t * poly_t ;
+	}
+
+	// out[i] = slerp( a[i], b[i], t[i * t_stride] ) for arrays of 4-Scalar quaternions ; t_stride is 0 for one t for all
+	inline Void SlerpArray4( const Scalar* a, const Scalar* b, const Scalar* t, uInt t_stride, Scalar* out, uInt count )
+	{
+		uInt i = 0 ;
+#if defined( MATHPHYSICS_SSE )
+		const __m128 one = _mm_set1_ps( 1.0f ) ;
+		const __m128 sign_bit = _mm_set1_ps( -0.0f ) ;
+
+		for ( ; i + 4 <= count ; i += 4 )
+		{
+			// 4 quaternions per register set, transposed to one component per register
+			__m128 ax = _mm_load_ps( a + i*4 + 0 ), ay = _mm_load_ps( a + i*4 + 4 ), az = _mm_load_ps( a + i*4 + 8 ), aw = _mm_load_ps( a + i*4 + 12 ) ;
+			__m128 bx = _mm_load_ps( b + i*4 + 0 ), by = _mm_load_ps( b + i*4 + 4 ), bz = _mm_load_ps( b + i*4 + 8 ), bw = _mm_load_ps( b + i*4 + 12 ) ;
+			_MM_TRANSPOSE4_PS( ax, ay, az, aw ) ;
+			_MM_TRANSPOSE4_PS( bx, by, bz, bw ) ;
+
+			__m128 tt = t_stride ? _mm_setr_ps( t[(i+0)*t_stride], t[(i+1)*t_stride], t[(i+2)*t_stride], t[(i+3)*t_stride] ) : _mm_set1_ps( t[0] ) ;
+
+			__m128 x = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ),
+								   _mm_add_ps( _mm_mul_ps( az, bz ), _mm_mul_ps( aw, bw ) ) ) ;
+			__m128 sign = _mm_and_ps( x, sign_bit ) ;
+			x = _mm_xor_ps( x, sign ) ;
+
+			__m128 x_minus_1 = _mm_sub_ps( x, one ) ;
+			__m128 d = _mm_sub_ps( one, tt ) ;
+			__m128 sqr_t = _mm_mul_ps( tt, tt ) ;
+			__m128 sqr_d = _mm_mul_ps( d, d ) ;
+
+			__m128 poly_t = one, poly_d = one ;
+			for ( Int k = 7 ; k >= 0 ; k-- )
+			{
+				__m128 u = _mm_set1_ps( slerp_u[k] ), v = _mm_set1_ps( slerp_v[k] ) ;
+				poly_t = _mm_add_ps( one, _mm_mul_ps( _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( u, sqr_t ), v ), x_minus_1 ), poly_t ) ) ;
+				poly_d = _mm_add_ps( one, _mm_mul_ps( _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( u, sqr_d ), v ), x_minus_1 ), poly_d ) ) ;
+			}
+
+			__m128 weight_a = _mm_mul_ps( d, poly_d ) ;
+			__m128 weight_b = _mm_xor_ps( _mm_mul_ps( tt, poly_t ), sign ) ;
+
+			__m128 rx = _mm_add_ps( _mm_mul_ps( ax, weight_a ), _mm_mul_ps( bx, weight_b ) ) ;
+			__m128 ry = _mm_add_ps( _mm_mul_ps( ay, weight_a ), _mm_mul_ps( by, weight_b ) ) ;
+			__m128 rz = _mm_add_ps( _mm_mul_ps( az, weight_a ), _mm_mul_ps( bz, weight_b ) ) ;
+			__m128 rw = _mm_add_ps( _mm_mul_ps( aw, weight_a ), _mm_mul_ps( bw, weight_b ) ) ;
+			_MM_TRANSPOSE4_PS( rx, ry, rz, rw ) ;
+
+			_mm_store_ps( out + i*4 + 0,  rx ) ;
+			_mm_store_ps( out + i*4 + 4,  ry ) ;
+			_mm_store_ps( out + i*4 + 8,  rz ) ;
+			_mm_store_ps( out + i*4 + 12, rw ) ;
+		}
+#endif
+		for ( ; i < count ; i++ )
+		{
+			const Scalar* qa = a + i*4 ;
+			const Scalar* qb = b + i*4 ;
+			Scalar weight_a, weight_b ;
+			SlerpWeights( Dot4( qa, qb ), t[i * t_stride], weight_a, weight_b ) ;
+
+			Scalar x = qa[0] * weight_a + qb[0] * weight_b ;
+			Scalar y = qa[1] * weight_a + qb[1] * weight_b ;
+			Scalar z = qa[2] * weight_a + qb[2] * weight_b ;
+			Scalar w = qa[3] * weight_a + qb[3] * weight_b ;
+			out[i*4+0] = x ; out[i*4+1] = y ; out[i*4+2] = z ; out[i*4+3] = w ;
+		}
+	}
+
+	// Batch kernels: the matrix is loaded once and kept in registers for the whole array.
+	// The 4-wide arrays must be 16-byte aligned; the 3-wide and SoA arrays need no alignment.
+	// Input and output arrays may be the same array.
+
+	// out[i] = m * in[i] for count 4-vectors
+	inline Void TransformArray4( const Scalar* m, const Scalar* in, Scalar* out, uInt count )
+	{
+#if defined( MATHPHYSICS_SSE )
+		// columns of m, so that m * v = c0*x + c1*y + c2*z + c3*w
+		__m128 c0 = _mm_load_ps( m + 0 ) ;
+		__m128 c1 = _mm_load_ps( m + 4 ) ;
+		__m128 c2 = _mm_load_ps( m + 8 ) ;
+		__m128 c3 = _mm_load_ps( m + 12 ) ;
+		_MM_TRANSPOSE4_PS( c0, c1, c2, c3 ) ;
+
+		for ( uInt i = 0 ; i < count ; i++, in += 4, out += 4 )
+		{
+			__m128 v = _mm_load_ps( in ) ;
+			__m128 r = _mm_mul_ps( _mm_shuffle_ps( v, v, 0x00 ), c0 ) ;
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( v, v, 0x55 ), c1 ) ) ;
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( v, v, 0xAA ), c2 ) ) ;
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( v, v, 0xFF ), c3 ) ) ;
+			_mm_store_ps( out, r ) ;
+		}
+#else
+		for ( uInt i = 0 ; i < count ; i++, in += 4, out += 4 )
+			MatrixVector4( m, in, out ) ;
+#endif
+	}
+
+	// out[i] = m * (in[i], w) for count packed 3-vectors; w is 1 for points and 0 for directions.
+	// The bottom row of m is ignored (affine transform, no perspective divide).
+	inline Void TransformArray3( const Scalar* m, const Scalar* in, Scalar* out, uInt count, Scalar w )
+	{
+#if defined( MATHPHYSICS_SSE )
+		__m128 c0 = _mm_load_ps( m + 0 ) ;
+		__m128 c1 = _mm_load_ps( m + 4 ) ;
+		__m128 c2 = _mm_load_ps( m + 8 ) ;
+		__m128 c3 = _mm_load_ps( m + 12 ) ;
+		_MM_TRANSPOSE4_PS( c0, c1, c2, c3 ) ;
+		c3 = _mm_mul_ps( c3, _mm_set1_ps( w ) ) ;
+
+		for ( uInt i = 0 ; i < count ; i++, in += 3, out += 3 )
+		{
+			__m128 r = _mm_add_ps( c3, _mm_mul_ps( _mm_set1_ps( in[0] ), c0 ) ) ;
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( in[1] ), c1 ) ) ;
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( in[2] ), c2 ) ) ;
+			// write exactly 3 floats so packed arrays are not overrun
+			_mm_storel_pi( (__m64*)out, r ) ;
+			_mm_store_ss( out + 2, _mm_movehl_ps( r, r ) ) ;
+		}
+#else
+		for ( uInt i = 0 ; i < count ; i++, in += 3, out += 3 )
+		{
+			Scalar x = in[0], y = in[1], z = in[2] ;
+			out[0] = m[0] * x + m[1] * y + m[2]  * z + m[3]  * w ;
+			out[1] = m[4] * x + m[5] * y + m[6]  * z + m[7]  * w ;
+			out[2] = m[8] * x + m[9] * y + m[10] * z + m[11] * w ;
+		}
+#endif
+	}
+
+	// structure-of-arrays form of TransformArray3 ; processes 8 (AVX) or 4 (SSE) points per iteration
+	inline Void TransformSoA3( const Scalar* m, const Scalar* x, const Scalar* y, const Scalar* z,
+							   Scalar* outX, Scalar* outY, Scalar* outZ, uInt count, Scalar w )
+	{
+		uInt i = 0 ;
+#if defined( MATHPHYSICS_AVX )
+		{
+			__m256 m00 = _mm256_set1_ps( m[0] ), m01 = _mm256_set1_ps( m[1] ), m02 = _mm256_set1_ps( m[2] ),  m03 = _mm256_set1_ps( m[3]  * w ) ;
+			__m256 m10 = _mm256_set1_ps( m[4] ), m11 = _mm256_set1_ps( m[5] ), m12 = _mm256_set1_ps( m[6] ),  m13 = _mm256_set1_ps( m[7]  * w ) ;
+			__m256 m20 = _mm256_set1_ps( m[8] ), m21 = _mm256_set1_ps( m[9] ), m22 = _mm256_set1_ps( m[10] ), m23 = _mm256_set1_ps( m[11] * w ) ;
+			for ( ; i + 8 <= count ; i += 8 )
+			{
+				__m256 vx = _mm256_loadu_ps( x + i ), vy = _mm256_loadu_ps( y + i ), vz = _mm256_loadu_ps( z + i ) ;
+				__m256 rx = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m00, vx ), _mm256_mul_ps( m01, vy ) ), _mm256_add_ps( _mm256_mul_ps( m02, vz ), m03 ) ) ;
+				__m256 ry = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m10, vx ), _mm256_mul_ps( m11, vy ) ), _mm256_add_ps( _mm256_mul_ps( m12, vz ), m13 ) ) ;
+				__m256 rz = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m20, vx ), _mm256_mul_ps( m21, vy ) ), _mm256_add_ps( _mm256_mul_ps( m22, vz ), m23 ) ) ;
+				_mm256_storeu_ps( outX + i, rx ) ;
+				_mm256_storeu_ps( outY + i, ry ) ;
+				_mm256_storeu_ps( outZ + i, rz ) ;
+			}
+		}
+#endif
+#if defined( MATHPHYSICS_SSE )
+		{
+			__m128 m00 = _mm_set1_ps( m[0] ), m01 = _mm_set1_ps( m[1] ), m02 = _mm_set1_ps( m[2] ),  m03 = _mm_set1_ps( m[3]  * w ) ;
+			__m128 m10 = _mm_set1_ps( m[4] ), m11 = _mm_set1_ps( m[5] ), m12 = _mm_set1_ps( m[6] ),  m13 = _mm_set1_ps( m[7]  * w ) ;
+			__m128 m20 = _mm_set1_ps( m[8] ), m21 = _mm_set1_ps( m[9] ), m22 = _mm_set1_ps( m[10] ), m23 = _mm_set1_ps( m[11] * w ) ;
+			for ( ; i + 4 <= count ; i += 4 )
+			{
+				__m128 vx = _mm_loadu_ps( x + i ), vy = _mm_loadu_ps( y + i ), vz = _mm_loadu_ps( z + i ) ;
+				__m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m00, vx ), _mm_mul_ps( m01, vy ) ), _mm_add_ps( _mm_mul_ps( m02, vz ), m03 ) ) ;
+				__m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m10, vx ), _mm_mul_ps( m11, vy ) ), _mm_add_ps( _mm_mul_ps( m12, vz ), m13 ) ) ;
+				__m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m20, vx ), _mm_mul_ps( m21, vy ) ), _mm_add_ps( _mm_mul_ps( m22, vz ), m23 ) ) ;
+				_mm_storeu_ps( outX + i, rx ) ;
+				_mm_storeu_ps( outY + i, ry ) ;
+				_mm_storeu_ps( outZ + i, rz ) ;
+			}
+		}
+#endif
+		for ( ; i < count ; i++ )
+		{
+			Scalar px = x[i], py = y[i], pz = z[i] ;
+			outX[i] = m[0] * px + m[1] * py + m[2]  * pz + m[3]  * w ;
+			outY[i] = m[4] * px + m[5] * py + m[6]  * pz + m[7]  * w ;
+			outZ[i] = m[8] * px + m[9] * py + m[10] * pz + m[11] * w ;
+		}
+	}
+
+}
+
+#endif
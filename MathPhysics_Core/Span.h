@@ -0,0 +1,82 @@
+#ifndef __MATHPHYSICS_SPAN_H__
+#define __MATHPHYSICS_SPAN_H__
+
+#include "Typedefs.h"
+#include "CoreMathPhysics.h"
+
+// A pointer and a count: a view of an array that it does not own.
+// Use As_Span to look at a raw float buffer (vertex positions, particle state, data read from a file)
+// as an array of math types without copying it, and As_Scalars to go the other way.
+template < class E >
+class Span
+{
+public:
+	Span() : data( NULL ), count( 0 ) {}
+	Span( E* data, uInt count ) : data( data ), count( count ) {}
+
+	// a Span< const E > can be made from a Span< E >
+	template < class Other >
+	Span( const Span< Other >& other ) : data( other.Data() ), count( other.Count() ) {}
+
+	E& operator [] ( uInt index ) const
+	{
+		assert( index < count ) ;
+		return data[index] ;
+	}
+
+	E*   Data() const	{ return data ; }
+	uInt Count() const	{ return count ; }
+	Bool Empty() const	{ return count == 0 ; }
+
+	// elements [ first, first + length )
+	Span Sub_Span( uInt first, uInt length ) const
+	{
+		assert( first <= count && length <= count - first ) ;
+		return Span( data + first, length ) ;
+	}
+
+	// so a Span can be used in range-based for loops
+	E* begin() const	{ return data ; }
+	E* end() const		{ return data + count ; }
+
+private:
+	E*   data ;
+	uInt count ;
+};
+
+// views the first scalars Scalars of buffer as an array of E ; scalars must be a multiple of the number
+// of Scalars in E and buffer must be aligned like E (16 bytes for Vector4D, Matrix4D and Quaternion)
+template < class E >
+inline Span< E > As_Span( Scalar* buffer, uInt scalars )
+{
+	const uInt stride = sizeof( E ) / sizeof( Scalar ) ;
+	assert( scalars % stride == 0 ) ;
+	assert( reinterpret_cast< std::size_t >( buffer ) % alignof( E ) == 0 ) ;
+
+	return Span< E >( reinterpret_cast< E* >( buffer ), scalars / stride ) ;
+}
+
+template < class E >
+inline Span< const E > As_Span( const Scalar* buffer, uInt scalars )
+{
+	const uInt stride = sizeof( E ) / sizeof( Scalar ) ;
+	assert( scalars % stride == 0 ) ;
+	assert( reinterpret_cast< std::size_t >( buffer ) % alignof( E ) == 0 ) ;
+
+	return Span< const E >( reinterpret_cast< const E* >( buffer ), scalars / stride ) ;
+}
+
+// views an array of math types as its Scalars
+template < class E >
+inline Span< Scalar > As_Scalars( const Span< E >& span )
+{
+	return Span< Scalar >( reinterpret_cast< Scalar* >( span.Data() ), span.Count() * ( sizeof( E ) / sizeof( Scalar ) ) ) ;
+}
+
+template < class E >
+inline Span< const Scalar > As_Scalars( const Span< const E >& span )
+{
+	return Span< const Scalar >( reinterpret_cast< const Scalar* >( span.Data() ), span.Count() * ( sizeof( E ) / sizeof( Scalar ) ) ) ;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "Typedefs.h"
+#include <assert.h>
+#include "Transform.h"
+
+Transform:: Transform()
+	: translation( 0.0, 0.0, 0.0 ), scale( 1.0, 1.0, 1.0 )
+{
+	matrix.Identity() ;
+	inverse.Identity() ;
+	matrix_dirty = inverse_dirty = false ;
+}
+
+Transform:: Transform( const Vector3D& translation, const Quaternion& rotation, const Vector3D& scale )
+	: translation( translation ), rotation( rotation ), scale( scale )
+{
+	Invalidate() ;
+}
+
+Void Transform::SetTranslation( const Vector3D& translation )
+{
+	this->translation = translation ;
+	Invalidate() ;
+}
+
+Void Transform::SetRotation( const Quaternion& rotation )
+{
+	this->rotation = rotation ;
+	Invalidate() ;
+}
+
+Void Transform::SetScale( const Vector3D& scale )
+{
+	this->scale = scale ;
+	Invalidate() ;
+}
+
+Void Transform::SetScale( Scalar uniform_scale )
+{
+	SetScale( Vector3D( uniform_scale, uniform_scale, uniform_scale ) ) ;
+}
+
+Void Transform::Translate( const Vector3D& offset )
+{
+	translation += offset ;
+	Invalidate() ;
+}
+
+Void Transform::Rotate( const Quaternion& rotation )
+{
+	// renormalize so orientations integrated over many frames do not drift
+	this->rotation = ( rotation * this->rotation ).Normalized() ;
+	Invalidate() ;
+}
+
+Void Transform::Rotate( Double angle, Int axis )
+{
+	Quaternion rotation ;
+	rotation.Rotation( angle, axis ) ;
+	Rotate( rotation ) ;
+}
+
+const Matrix4D& Transform::ToMatrix4D() const
+{
+	if ( matrix_dirty )
+	{
+		// T * R * S : column c of the rotation is scaled by scale[c], and the translation is the last column
+		Matrix3D r = rotation.ToMatrix3D() ;
+		const Scalar* rm = r.Data() ;
+		Scalar* mm = matrix.Data() ;
+
+		for ( Int row = 0 ; row < 3 ; row++ )
+		{
+			for ( Int col = 0 ; col < 3 ; col++ )
+				mm[row * 4 + col] = rm[row * 3 + col] * scale[col] ;
+
+			mm[row * 4 + W] = translation[row] ;
+		}
+		mm[W * 4 + X] = mm[W * 4 + Y] = mm[W * 4 + Z] = 0.0f ;
+		mm[W * 4 + W] = 1.0f ;
+
+		matrix_dirty = false ;
+	}
+	return matrix ;
+}
+
+const Matrix4D& Transform::InverseMatrix4D() const
+{
+	if ( inverse_dirty )
+	{
+		// ( T * R * S )^-1 = S^-1 * R^T * T^-1 : row r of the transposed rotation is divided by scale[r]
+		Matrix3D r = rotation.ToMatrix3D() ;
+		const Scalar* rm = r.Data() ;
+		Scalar* im = inverse.Data() ;
+
+		for ( Int row = 0 ; row < 3 ; row++ )
+		{
+			assert( scale[row] != 0.0f ) ;	// a zero scale has no inverse
+			Scalar inverse_scale = 1.0f / scale[row] ;
+
+			for ( Int col = 0 ; col < 3 ; col++ )
+				im[row * 4 + col] = rm[col * 3 + row] * inverse_scale ;
+
+			im[row * 4 + W] = -( im[row * 4 + X] * translation[X] + im[row * 4 + Y] * translation[Y] + im[row * 4 + Z] * translation[Z] ) ;
+		}
+		im[W * 4 + X] = im[W * 4 + Y] = im[W * 4 + Z] = 0.0f ;
+		im[W * 4 + W] = 1.0f ;
+
+		inverse_dirty = false ;
+	}
+	return inverse ;
+}
+
+Vector3D Transform::TransformPoint( const Vector3D& point ) const
+{
+	const Matrix4D& m = ToMatrix4D() ;
+	return ( m * Vector4D( point, 1.0f ) ).ToVector3D() ;
+}
+
+Vector3D Transform::TransformDirection( const Vector3D& direction ) const
+{
+	const Matrix4D& m = ToMatrix4D() ;
+	return ( m * Vector4D( direction, 0.0f ) ).ToVector3D() ;
+}
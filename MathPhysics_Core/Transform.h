@@ -0,0 +1,53 @@
+#ifndef __MATHPHYSICS_TRANSFORM_H__
+#define __MATHPHYSICS_TRANSFORM_H__
+
+#include "Typedefs.h"
+#include "CoreMathPhysics.h"
+
+// Position, orientation and scale of an object, with the composed matrix and its inverse cached.
+// The matrix is T * R * S : points are scaled, then rotated, then translated.
+// Setting any part only marks the caches dirty; the matrix is rebuilt the next time it is read and the
+// inverse the next time the inverse is read, so objects that do not move cost nothing per frame.
+// Reading the matrices updates the caches, so a Transform that is being modified must not be read
+// from several threads at once ; once clean it can be.
+class Transform
+{
+public:
+	Transform() ;	// identity
+	Transform( const Vector3D& translation, const Quaternion& rotation, const Vector3D& scale ) ;
+
+	const Vector3D&   Translation() const	{ return translation ; }
+	const Quaternion& Rotation() const		{ return rotation ; }
+	const Vector3D&   Scale() const			{ return scale ; }
+
+	Void SetTranslation( const Vector3D& translation ) ;
+	Void SetRotation( const Quaternion& rotation ) ;
+	Void SetScale( const Vector3D& scale ) ;	// no component may be 0 if the inverse is used
+	Void SetScale( Scalar uniform_scale ) ;
+
+	Void Translate( const Vector3D& offset ) ;		// move by offset, in parent space
+	Void Rotate( const Quaternion& rotation ) ;		// apply a rotation after the current one
+	Void Rotate( Double angle, Int axis ) ;
+
+	const Matrix4D& ToMatrix4D() const ;		// local to parent
+	const Matrix4D& InverseMatrix4D() const ;	// parent to local ; built without a general 4x4 inverse
+
+	Bool IsDirty() const	{ return matrix_dirty ; }	// true if the matrix will be rebuilt when read
+
+	Vector3D TransformPoint( const Vector3D& point ) const ;
+	Vector3D TransformDirection( const Vector3D& direction ) const ;	// no translation
+
+private:
+	Void Invalidate()	{ matrix_dirty = inverse_dirty = true ; }
+
+	Vector3D   translation ;
+	Quaternion rotation ;
+	Vector3D   scale ;
+
+	mutable Matrix4D matrix ;
+	mutable Matrix4D inverse ;
+	mutable Bool     matrix_dirty ;
+	mutable Bool     inverse_dirty ;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "Typedefs.h"
+#include <assert.h>
+#include <atomic>
+#include "TransformHierarchy.h"
+#include "ThreadPool.h"
+
+// levels smaller than this are not worth splitting across threads
+static const uInt level_grain = 1024 ;
+
+TransformHierarchy:: TransformHierarchy()
+{
+	levels_dirty = false ;
+}
+
+uInt TransformHierarchy::Add( const Transform& transform, uInt parent_node )
+{
+	assert( parent_node == no_parent || parent_node < Count() ) ;
+
+	uInt node = Count() ;
+
+	local.push_back( transform ) ;
+	world.push_back( Matrix4D::Identity_Matrix() ) ;
+	parent.push_back( parent_node ) ;
+	depth.push_back( parent_node == no_parent ? 0 : depth[parent_node] + 1 ) ;
+	dirty.push_back( 0 ) ;
+	moved.push_back( 0 ) ;
+
+	levels_dirty = true ;
+	Mark_Dirty( node ) ;
+
+	return node ;
+}
+
+Void TransformHierarchy::SetParent( uInt node, uInt parent_node )
+{
+	assert( node < Count() ) ;
+	assert( parent_node == no_parent || parent_node < Count() ) ;
+
+#ifndef NDEBUG
+	for ( uInt ancestor = parent_node ; ancestor != no_parent ; ancestor = parent[ancestor] )
+		assert( ancestor != node ) ;	// would make a cycle
+#endif
+
+	parent[node] = parent_node ;
+	levels_dirty = true ;
+	Mark_Dirty( node ) ;
+}
+
+Transform& TransformHierarchy::EditLocal( uInt node )
+{
+	Mark_Dirty( node ) ;
+	return local[node] ;
+}
+
+Void TransformHierarchy::SetLocal( uInt node, const Transform& transform )
+{
+	local[node] = transform ;
+	Mark_Dirty( node ) ;
+}
+
+Void TransformHierarchy::Mark_Dirty( uInt node )
+{
+	if ( !dirty[node] )
+	{
+		dirty[node] = 1 ;
+		dirty_nodes.push_back( node ) ;
+	}
+}
+
+Void TransformHierarchy::Rebuild_Levels()
+{
+	uInt count = Count() ;
+
+	// reparenting can move a whole subtree to another depth ; resolve each node's depth by walking up
+	// to the nearest ancestor already resolved in this pass
+	std::vector< Byte > resolved( count, 0 ) ;
+	std::vector< uInt > chain ;
+
+	for ( uInt node = 0 ; node < count ; node++ )
+	{
+		uInt ancestor = node ;
+		while ( ancestor != no_parent && !resolved[ancestor] )
+		{
+			chain.push_back( ancestor ) ;
+			ancestor = parent[ancestor] ;
+		}
+
+		uInt d = ancestor == no_parent ? 0 : depth[ancestor] + 1 ;
+		while ( !chain.empty() )
+		{
+			uInt n = chain.back() ;
+			chain.pop_back() ;
+			depth[n] = d++ ;
+			resolved[n] = 1 ;
+		}
+	}
+
+	// counting sort by depth
+	uInt levels = 0 ;
+	for ( uInt node = 0 ; node < count ; node++ )
+		if ( depth[node] + 1 > levels ) levels = depth[node] + 1 ;
+
+	level_begin.assign( levels + 1, 0 ) ;
+	for ( uInt node = 0 ; node < count ; node++ )
+		level_begin[ depth[node] + 1 ]++ ;
+	for ( uInt level = 0 ; level < levels ; level++ )
+		level_begin[level + 1] += level_begin[level] ;
+
+	std::vector< uInt > next( level_begin.begin(), level_begin.end() - 1 ) ;
+	order.resize( count ) ;
+	for ( uInt node = 0 ; node < count ; node++ )
+		order[ next[ depth[node] ]++ ] = node ;
+
+	levels_dirty = false ;
+}
+
+uInt TransformHierarchy::Update_Level( uInt level, uInt first_level, ThreadPool* pool )
+{
+	std::atomic< uInt > changed( 0 ) ;
+	Bool read_parents = level > first_level ;	// moved[] of the levels above first_level is stale
+
+	auto task = [&]( uInt begin, uInt end ) {
+		uInt count = 0 ;
+
+		for ( uInt k = begin ; k < end ; k++ )
+		{
+			uInt node = order[k] ;
+			uInt p = parent[node] ;
+
+			Bool node_moved = dirty[node] || ( read_parents && p != no_parent && moved[p] ) ;
+			moved[node] = node_moved ;
+			dirty[node] = 0 ;
+
+			if ( node_moved )
+			{
+				if ( p == no_parent )
+					world[node] = local[node].ToMatrix4D() ;
+				else
+					world[node] = world[p] * local[node].ToMatrix4D() ;
+				count++ ;
+			}
+		}
+
+		changed += count ;
+	} ;
+
+	uInt begin = level_begin[level] ;
+	uInt size = level_begin[level + 1] - begin ;
+
+	if ( pool == NULL )
+		task( begin, begin + size ) ;
+	else
+		pool->ParallelFor( size, level_grain, [&]( uInt b, uInt e ) { task( begin + b, begin + e ) ; } ) ;
+
+	return changed ;
+}
+
+Void TransformHierarchy::Update( ThreadPool* pool )
+{
+	if ( dirty_nodes.empty() )
+		return ;
+
+	if ( levels_dirty )
+		Rebuild_Levels() ;
+
+	uInt first_level = 0xFFFFFFFF, last_dirty_level = 0 ;
+	for ( uInt i = 0 ; i < dirty_nodes.size() ; i++ )
+	{
+		uInt d = depth[ dirty_nodes[i] ] ;
+		if ( d < first_level ) first_level = d ;
+		if ( d > last_dirty_level ) last_dirty_level = d ;
+	}
+	dirty_nodes.clear() ;
+
+	uInt levels = (uInt) level_begin.size() - 1 ;
+	for ( uInt level = first_level ; level < levels ; level++ )
+	{
+		uInt changed = Update_Level( level, first_level, pool ) ;
+
+		// below the deepest edit, a level where nothing moved means nothing deeper moves either
+		if ( changed == 0 && level >= last_dirty_level )
+			break ;
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef __MATHPHYSICS_TRANSFORMHIERARCHY_H__
+#define __MATHPHYSICS_TRANSFORMHIERARCHY_H__
+
+#include "Typedefs.h"
+#include <vector>
+#include "Transform.h"
+
+class ThreadPool ;
+
+// A scene graph of transforms stored in flat arrays and indexed by node id.
+// World matrices are computed by Update() one depth level at a time, so every parent is done before its
+// children and all nodes of a level, which never depend on each other, can be split across threads.
+// Only nodes whose local transform was edited, and their descendants, get a new world matrix ; the
+// levels above the shallowest edited node are skipped and the update stops at the first level below
+// the deepest edited node in which nothing moved.
+class TransformHierarchy
+{
+public:
+	static const uInt no_parent = 0xFFFFFFFF ;
+
+	TransformHierarchy() ;
+
+	// adds a node and returns its id ; parent must already exist
+	uInt Add( const Transform& local, uInt parent = no_parent ) ;
+
+	// moves node and its subtree under a new parent ; parent must not be inside the subtree
+	Void SetParent( uInt node, uInt parent ) ;
+
+	uInt Count() const						{ return (uInt) parent.size() ; }
+	uInt Parent( uInt node ) const			{ return parent[node] ; }
+
+	const Transform& Local( uInt node ) const	{ return local[node] ; }
+	Transform&       EditLocal( uInt node ) ;	// marks the node as moved ; the reference is invalidated by Add()
+	Void             SetLocal( uInt node, const Transform& transform ) ;
+
+	// local to world, as of the last Update()
+	const Matrix4D& World( uInt node ) const	{ return world[node] ; }
+
+	// recomputes the world matrices of every moved node and its descendants.
+	// If a pool is given, large levels are split across its worker threads.
+	Void Update( ThreadPool* pool = NULL ) ;
+
+private:
+	Void Mark_Dirty( uInt node ) ;
+	Void Rebuild_Levels() ;
+	uInt Update_Level( uInt level, uInt first_level, ThreadPool* pool ) ;
+
+	// per node, indexed by id
+	std::vector< Transform > local ;
+	std::vector< Matrix4D >  world ;
+	std::vector< uInt >      parent ;
+	std::vector< uInt >      depth ;
+	std::vector< Byte >      dirty ;	// local transform edited since the last Update()
+	std::vector< Byte >      moved ;	// world matrix changed in the last Update() ; only valid for the levels it visited
+
+	// node ids sorted by depth ; level d is order[ level_begin[d] ] up to order[ level_begin[d+1] ]
+	std::vector< uInt > order ;
+	std::vector< uInt > level_begin ;
+	Bool                levels_dirty ;
+
+	std::vector< uInt > dirty_nodes ;
+};
+
+#endif
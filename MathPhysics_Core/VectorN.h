@@ -0,0 +1,220 @@
+#ifndef __MATHPHYSICS_VECTORN_H__
+#define __MATHPHYSICS_VECTORN_H__
+
+// Included by CoreMathPhysics.h ; include that header instead of this one.
+
+#include "Expression.h"
+
+// pass to a constructor to skip zeroing the elements when they are all about to be overwritten:
+// Vector3D v( uninitialized ) ;
+struct UninitializedTag {} ;
+const UninitializedTag uninitialized = UninitializedTag() ;
+
+// N dimensional vector of T. Vector2D, Vector3D and Vector4D are typedefs of this template.
+// Every operation is inline and expanded over the N elements at compile time, and takes its operands by
+// const reference so temporaries can be passed directly.
+// +, -, and scaling return expressions (Expression.h) that are evaluated when assigned to a Vector.
+// Functions that only make sense for one size (Orthogonal, Cross_Product, Length3D, ...) fail to compile
+// when used with another.
+template < Int N, class T >
+class Vector : public VectorExpression< Vector< N, T > >
+{
+public:
+	typedef T Element ;
+	static const Int dimension = N ;
+	static const Int size = N ;
+
+	constexpr Vector() : v{} {}		// the zero vector
+	explicit Vector( UninitializedTag ) {}	// elements are left uninitialized
+	constexpr Vector( const T element[N] ) : v{}	// initialize with an array
+	{
+		for ( Int i = 0 ; i < N ; i++ ) v[i] = element[i] ;
+	}
+	constexpr Vector( Double x, Double y ) : v{ T( x ), T( y ) }
+	{
+		static_assert( N == 2, "this constructor is for Vector2D" ) ;
+	}
+	constexpr Vector( Double x, Double y, Double z ) : v{ T( x ), T( y ), T( z ) }	// for Vector4D, w == 1.0 is implicit
+	{
+		static_assert( N == 3 || N == 4, "this constructor is for Vector3D and Vector4D" ) ;
+		if ( N == 4 ) v[N-1] = T( 1.0 ) ;
+	}
+	constexpr Vector( Double x, Double y, Double z, Double w ) : v{ T( x ), T( y ), T( z ), T( w ) }
+	{
+		static_assert( N == 4, "this constructor is for Vector4D" ) ;
+	}
+	constexpr Vector( const Vector< ( N > 1 ? N-1 : 1 ), T >& head, T last ) : v{}	// e.g. Vector4D( Vector3D, w ) with w == 0.0 or 1.0
+	{
+		for ( Int i = 0 ; i < N-1 ; i++ ) v[i] = head[i] ;
+		v[N-1] = last ;
+	}
+
+	// evaluate an expression such as a*s + b - c in one pass
+	template < class E >
+	constexpr Vector( const VectorExpression< E >& expression ) : Vector( expression.Self(), Sequence() ) {}
+
+	template < class E >
+	constexpr Vector& operator = ( const VectorExpression< E >& expression )
+	{
+		return *this = Vector( expression ) ;
+	}
+
+	// use to both read and write elements, just like a normal array
+	constexpr T& operator [] ( Int index )
+	{
+		assert( index >= 0 && index < N ) ;
+		return v[index] ;
+	}
+
+	// use to read elements from const vectors
+	constexpr T operator [] ( Int index ) const
+	{
+		assert( index >= 0 && index < N ) ;
+		return v[index] ;
+	}
+
+	// element access for the expression templates
+	constexpr T At( Int index ) const { return v[index] ; }
+
+	// the N elements as a plain array
+	T*       Data()       { return v ; }
+	const T* Data() const { return v ; }
+
+	T LengthSquared() const
+	{
+		return *this * *this ;
+	}
+
+	T Length() const
+	{
+		return (T) std::sqrt( LengthSquared() ) ;
+	}
+
+	// modifies the vector to be unit length
+	Void Normalize()
+	{
+		T length = Length() ;
+		if ( length > epsilon )	// do not divide is length is really small
+			*this *= T( 1.0 ) / length ;
+	}
+
+	// returns a new vector that is unit length
+	Vector Normalized() const
+	{
+		Vector result( *this ) ;
+		result.Normalize() ;
+		return result ;
+	}
+
+	// Scalar-Vector product ; v * s, s * v, v / s and -v are in Expression.h
+	constexpr Void operator *= ( T scalar )						{ *this = *this * scalar ; }
+	constexpr Void operator /= ( T scalar )						{ *this = *this / scalar ; }
+
+	// vector addition ; v + w and v - w are in Expression.h, as is the Dot-Product v * w
+	template < class E > constexpr Void operator += ( const VectorExpression< E >& other )	{ *this = *this + other ; }
+	template < class E > constexpr Void operator -= ( const VectorExpression< E >& other )	{ *this = *this - other ; }
+
+	// Construct a vector that is orthogonal (perpendicular) to the given vector
+	constexpr Vector Orthogonal() const
+	{
+		static_assert( N == 2, "Orthogonal is for Vector2D" ) ;
+		Vector result ;
+		result.v[X] = -v[Y] ;
+		result.v[Y] =  v[X] ;
+		return result ;
+	}
+
+	// cross product of the x, y and z parts; for Vector4D the w of the result is 0
+	constexpr Vector Cross_Product( const Vector& other ) const
+	{
+		static_assert( N == 3 || N == 4, "Cross_Product is for Vector3D and Vector4D" ) ;
+		Vector result ;
+		result.v[X] = v[Y] * other.v[Z] - other.v[Y] * v[Z] ;
+		result.v[Y] = v[Z] * other.v[X] - other.v[Z] * v[X] ;
+		result.v[Z] = v[X] * other.v[Y] - other.v[X] * v[Y] ;
+		return result ;
+	}
+
+	// returns the 1st 3 components as a Vector3D
+	constexpr Vector< 3, T > ToVector3D() const
+	{
+		static_assert( N == 4, "ToVector3D is for Vector4D" ) ;
+		return Vector< 3, T >( v[X], v[Y], v[Z] ) ;
+	}
+
+	// length of the x, y and z part ; e.g. the normal of a plane
+	T Length3D() const
+	{
+		return ToVector3D().Length() ;
+	}
+
+	// divides the whole vector by Length3D() ; normalizes a plane
+	Void Normalize3D()
+	{
+		*this *= T( 1.0 ) / Length3D() ;
+	}
+
+	constexpr Bool operator == ( const Vector& other ) const		{ return Equal( other, Sequence() ) ; }
+	constexpr Bool operator != ( const Vector& other ) const		{ return ! (*this == other) ; }
+
+	// use this to test whethere or not a vector == zero vector
+	// it returns a reference to a constant static vector full of 0's
+	static const Vector& Zero_Vector()
+	{
+		static const Vector zero_vector ;
+		return zero_vector ;
+	}
+
+protected:
+	template < Int, class > friend class Vector ;
+	template < Int, class > friend class Matrix ;
+
+	typedef typename MathDetail::Indices< N >::Type Sequence ;
+
+	// element-wise constructor used by the unrolled operations
+	template < class... E >
+	constexpr Vector( MathDetail::Elements, const E&... e ) : v{ T( e )... } {}
+
+	template < class E, std::size_t... I >
+	constexpr Vector( const E& expression, std::index_sequence< I... > ) : v{ expression.At( I )... } {}
+
+	template < std::size_t... I > constexpr Bool   Equal( const Vector& o, std::index_sequence< I... > ) const		{ return MathDetail::All( ( v[I] == o.v[I] )... ) ; }
+
+	// 4 float vectors are aligned so the SIMD kernels can load them directly
+	alignas( N == 4 && sizeof( T ) == 4 ? 16 : alignof( T ) ) T v[N] ;
+};
+
+// overload for cross product
+template < Int N, class T >
+constexpr Vector< N, T > operator % ( const Vector< N, T >& a, const Vector< N, T >& b )
+{
+	return a.Cross_Product( b ) ;
+}
+
+// cross product of the x, y and z part of a Vector4D with a Vector3D
+template < class T >
+inline Vector< 3, T > operator % ( const Vector< 4, T >& a, const Vector< 3, T >& b )
+{
+	return a.ToVector3D().Cross_Product( b ) ;
+}
+
+template < class T >
+inline Vector< 4, T > Cross_Product( const Vector< 4, T >& a, const Vector< 4, T >& b )
+{
+	return a.Cross_Product( b ) ;
+}
+
+// SIMD versions for Vector4D ; these are not constexpr
+inline Float operator * ( const Vector< 4, Float >& a, const Vector< 4, Float >& b )
+{
+	return SIMD::Dot4( a.Data(), b.Data() ) ;
+}
+
+template <> inline Vector< 4, Float > Vector< 4, Float >::Cross_Product( const Vector< 4, Float >& other ) const
+{
+	Vector result ;
+	SIMD::Cross3( v, other.v, result.v ) ;
+	return result ;
+}
+
+#endif
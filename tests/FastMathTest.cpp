@@ -0,0 +1,151 @@
+// Checks the FastMath approximations against double precision <cmath>: the scalar, 4 and 8 wide and
+// batch versions of SinCos and Atan2, and Matrix::FastRotation. The error bounds asserted are the ones
+// documented in FastMath.h, and every width must give exactly the results of the scalar version.
+//
+// sources: none besides this file (see README.txt); build it once per SIMD configuration
+
+#include "CoreMathPhysics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// the bounds documented in FastMath.h
+static const Double sincos_error = 8.0e-8 ;			// |angle| <= 8192
+static const Double sincos_error_far = 1.0e-6 ;		// |angle| <= 65536
+static const Double atan2_error = 2.75e-7 ;
+
+static Int failures = 0 ;
+
+static Void Check( Bool ok, const Char* what, Double value )
+{
+	if ( ok )
+		return ;
+	failures++ ;
+	printf( "FAILED: %s (%g)\n", what, value ) ;
+}
+
+static Double Max( Double a, Double b )
+{
+	return a > b ? a : b ;
+}
+
+// largest error of SinCos over count angles spread evenly over [ -range, range ] ; the batch version
+// does the work, with count odd so every width and the scalar tail are used
+static Double SinCos_Error( Double range, uInt count )
+{
+	std::vector< Float > angles( count ), sin( count ), cos( count ) ;
+	for ( uInt i = 0 ; i < count ; i++ )
+		angles[i] = (Float)( -range + 2.0 * range * i / ( count - 1 ) ) ;
+
+	FastMath::SinCos( &angles[0], &sin[0], &cos[0], count ) ;
+
+	Double error = 0 ;
+	Int differ = 0 ;
+	for ( uInt i = 0 ; i < count ; i++ )
+	{
+		error = Max( error, fabs( sin[i] - std::sin( (Double)angles[i] ) ) ) ;
+		error = Max( error, fabs( cos[i] - std::cos( (Double)angles[i] ) ) ) ;
+
+		Float s, c ;
+		FastMath::SinCos( angles[i], s, c ) ;
+		differ += s != sin[i] || c != cos[i] || FastMath::Sin( angles[i] ) != s || FastMath::Cos( angles[i] ) != c ;
+	}
+	Check( differ == 0, "batch SinCos gives the scalar results", differ ) ;
+	return error ;
+}
+
+int main()
+{
+#if defined( MATHPHYSICS_AVX )
+	printf( "kernels: AVX\n" ) ;
+#elif defined( MATHPHYSICS_SSE )
+	printf( "kernels: SSE\n" ) ;
+#else
+	printf( "kernels: scalar\n" ) ;
+#endif
+
+	// sin and cos
+	Double error = 0 ;
+	error = Max( error, SinCos_Error( 3.5, 1000001 ) ) ;
+	error = Max( error, SinCos_Error( 100.0, 1000001 ) ) ;
+	error = Max( error, SinCos_Error( 8192.0, 4000001 ) ) ;
+	printf( "SinCos    max error %.3g for |angle| <= 8192\n", error ) ;
+	Check( error <= sincos_error, "SinCos error for |angle| <= 8192", error ) ;
+
+	error = SinCos_Error( 65536.0, 4000001 ) ;
+	printf( "SinCos    max error %.3g for |angle| <= 65536\n", error ) ;
+	Check( error <= sincos_error_far, "SinCos error for |angle| <= 65536", error ) ;
+
+	// atan2 over every direction, at magnitudes from 1e-10 to 1e10
+	const uInt count = 2000001 ;
+	std::vector< Float > y( count ), x( count ), angle( count ) ;
+	srand( 3 ) ;
+	for ( uInt i = 0 ; i < count ; i++ )
+	{
+		Double direction = -PI + 2.0 * PI * i / ( count - 1 ) ;
+		Double length = pow( 10.0, ( rand() % 2001 - 1000 ) / 100.0 ) ;
+		y[i] = (Float)( length * std::sin( direction ) ) ;
+		x[i] = (Float)( length * std::cos( direction ) ) ;
+	}
+	// the axes, and a few near them
+	const Float special[][2] = { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 }, { 1e-30f, -1 }, { -1e-30f, -1 }, { 1, 1e-30f }, { -3, 3 } } ;
+	for ( uInt i = 0 ; i < sizeof( special ) / sizeof( special[0] ) ; i++ )
+	{
+		y[i] = special[i][0] ;
+		x[i] = special[i][1] ;
+	}
+
+	FastMath::Atan2( &y[0], &x[0], &angle[0], count ) ;
+
+	error = 0 ;
+	Int differ = 0 ;
+	for ( uInt i = 0 ; i < count ; i++ )
+	{
+		// the same direction may come out as pi or -pi
+		Double difference = fabs( angle[i] - atan2( (Double)y[i], (Double)x[i] ) ) ;
+		if ( difference > PI )
+			difference = fabs( difference - 2.0 * PI ) ;
+		error = Max( error, difference ) ;
+		differ += FastMath::Atan2( y[i], x[i] ) != angle[i] ;
+	}
+	printf( "Atan2     max error %.3g\n", error ) ;
+	Check( error <= atan2_error, "Atan2 error", error ) ;
+	Check( differ == 0, "batch Atan2 gives the scalar results", differ ) ;
+	Check( FastMath::Atan2( 0.0f, 0.0f ) == 0.0f, "Atan2( 0, 0 ) == 0", FastMath::Atan2( 0.0f, 0.0f ) ) ;
+
+	// the rotation builders, against the double precision ones
+	error = 0 ;
+	for ( Int i = -10000 ; i <= 10000 ; i++ )
+	{
+		Scalar radians = i * 0.0137f ;
+
+		Matrix2D fast2 ;
+		Matrix2Dd exact2 ;
+		fast2.FastRotation( radians ) ;
+		exact2.Rotation( radians ) ;
+		for ( Int e = 0 ; e < 4 ; e++ )
+			error = Max( error, fabs( fast2.Data()[e] - exact2.Data()[e] ) ) ;
+
+		for ( Int axis = X ; axis <= Z ; axis++ )
+		{
+			Matrix3D fast3 ;
+			Matrix3Dd exact3 ;
+			fast3.FastRotation( radians, axis ) ;
+			exact3.Rotation( radians, axis ) ;
+			for ( Int e = 0 ; e < 9 ; e++ )
+				error = Max( error, fabs( fast3.Data()[e] - exact3.Data()[e] ) ) ;
+
+			Matrix4D fast4 ;
+			Matrix4Dd exact4 ;
+			fast4.FastRotation( radians, axis ) ;
+			exact4.Rotation( radians, axis ) ;
+			for ( Int e = 0 ; e < 16 ; e++ )
+				error = Max( error, fabs( fast4.Data()[e] - exact4.Data()[e] ) ) ;
+		}
+	}
+	printf( "FastRotation max error %.3g\n", error ) ;
+	Check( error <= sincos_error, "FastRotation error", error ) ;
+
+	printf( failures == 0 ? "all passed\n" : "%d checks failed\n", failures ) ;
+	return failures == 0 ? 0 : 1 ;
+}
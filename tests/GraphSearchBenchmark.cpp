@@ -0,0 +1,298 @@
+//Times Graph::traverse against the search it replaced, on grids and random graphs.
+//Legacy_Traverse below is the old traverse as it was: list based open and closed sets scanned for the
+//cheapest record on every step and again for every connection, and a NodeRecord allocated per node
+//reached. The only change is that those records are freed after each query instead of leaking.
+//Both searches run the same start/end pairs and must find paths of the same total cost.
+//The old search takes minutes a query on the 50k node graphs, so it only runs on them when asked.
+//
+//sources: AI_Core/Graph.cpp Main_Core/ThreadPool.cpp (see README.txt)
+//usage  : GraphSearchBenchmark [all]    all also runs the old search on the 50k node graphs
+
+#include "Graph.h"
+#include <cfloat>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+	//the old search's record of a node reached
+	struct Legacy_Record
+	{
+		PathNode* node;
+		Connection* connection;
+		Legacy_Record* prevNode;
+		Float costSoFar;
+
+		Bool operator==(Legacy_Record otherRecord)
+		{
+			return node == otherRecord.node && connection == otherRecord.connection && costSoFar == otherRecord.costSoFar;
+		}
+	};
+
+	Bool Legacy_Traverse(std::vector<PathNode*>& nodes, PathNode* start, PathNode* end, list<Connection*>* path,
+						 std::vector<Legacy_Record*>& allocated)
+	{
+		path->clear();
+		for(uInt i = 0; i < nodes.size(); i++)
+			nodes[i]->openNode();
+
+		Legacy_Record startNode;
+		startNode.node = start;
+		startNode.connection = NULL;
+		startNode.prevNode = NULL;
+		startNode.costSoFar = 0;
+
+		list<Legacy_Record> open;
+		open.push_back(startNode);
+
+		Legacy_Record current = startNode;
+		while(open.size() > 0)
+		{
+			//find the lowest cost so far in the open set of nodes
+			Float lowestCost = FLT_MAX;
+			for(list<Legacy_Record>::iterator nodeItr = open.begin(); nodeItr != open.end(); nodeItr++)
+			{
+				if(nodeItr->costSoFar < lowestCost)
+				{
+					lowestCost = nodeItr->costSoFar;
+					current = *nodeItr;
+				}
+			}
+
+			if(current.node == end)
+				break;
+
+			list<Connection*> connections;
+			current.node->getConnections(&connections);
+
+			for(list<Connection*>::iterator conItr = connections.begin(); conItr != connections.end(); conItr++)
+			{
+				PathNode* endNode = (*conItr)->getToNode();
+				Float endNodeCost = current.costSoFar + (*conItr)->getCost();
+
+				if(!endNode->isOpen())
+					continue;
+
+				//check if this node is in the open set and is a worse route
+				Bool worseRoute = false;
+				Bool alreadyInOpen = false;
+				for(list<Legacy_Record>::iterator nodeItr = open.begin(); nodeItr != open.end(); nodeItr++)
+				{
+					if(nodeItr->node == endNode && nodeItr->connection == *conItr)
+					{
+						alreadyInOpen = true;
+						if(nodeItr->costSoFar <= endNodeCost)
+						{
+							worseRoute = true;
+							break;
+						}
+					}
+				}
+				if(worseRoute)
+					continue;
+
+				if(!alreadyInOpen)
+				{
+					Legacy_Record endNodeRecord;
+					endNodeRecord.node = endNode;
+					endNodeRecord.connection = *conItr;
+					endNodeRecord.costSoFar = endNodeCost;
+
+					endNodeRecord.prevNode = new Legacy_Record();
+					endNodeRecord.prevNode->node = current.node;
+					endNodeRecord.prevNode->connection = current.connection;
+					endNodeRecord.prevNode->prevNode = current.prevNode;
+					allocated.push_back(endNodeRecord.prevNode);
+
+					open.push_back(endNodeRecord);
+				}
+			}
+
+			current.node->closeNode();
+			open.remove(current);
+		}
+
+		if(current.node != end)
+			return false;
+
+		while(current.node != start)
+		{
+			path->push_back(current.connection);
+			current = *current.prevNode;
+		}
+		path->reverse();
+		return true;
+	}
+
+	//a small linear congruential generator, so every run builds the same graphs and queries
+	uInt Next_Random(uInt& state)
+	{
+		state = state * 1103515245u + 12345u;
+		return state >> 8;
+	}
+
+	struct TestGraph
+	{
+		Graph graph;
+		std::vector<PathNode*> nodes;
+
+		~TestGraph()
+		{
+			for(uInt i = 0; i < nodes.size(); i++)
+				delete nodes[i];
+		}
+
+		Void AddNodes(uInt count)
+		{
+			for(uInt i = 0; i < count; i++)
+			{
+				nodes.push_back(new PathNode());
+				graph.addNode(nodes.back());
+			}
+		}
+	};
+
+	//a 4-connected grid, with costs 1 to 9
+	Void Build_Grid(TestGraph& test, uInt width, uInt height, uInt& random)
+	{
+		test.AddNodes(width * height);
+		for(uInt y = 0; y < height; y++)
+			for(uInt x = 0; x < width; x++)
+			{
+				uInt i = y * width + x;
+				if(x + 1 < width)
+					test.nodes[i]->addConnection(test.nodes[i + 1], (Float)(1 + Next_Random(random) % 9));
+				if(y + 1 < height)
+					test.nodes[i]->addConnection(test.nodes[i + width], (Float)(1 + Next_Random(random) % 9));
+			}
+	}
+
+	//count nodes with about degree connections each, to random nodes, with costs 1 to 10.9
+	Void Build_Random(TestGraph& test, uInt count, uInt degree, uInt& random)
+	{
+		test.AddNodes(count);
+		for(uInt i = 0; i < count; i++)
+			for(uInt d = 0; d < degree / 2; d++)
+			{
+				uInt j = Next_Random(random) % count;
+				if(j != i)
+					test.nodes[i]->addConnection(test.nodes[j], 1 + (Next_Random(random) % 100) / 10.0f);
+			}
+	}
+
+	//total cost of a path, or -1 if it does not lead from start to end
+	Double Path_Cost(list<Connection*>& path, PathNode* start, PathNode* end)
+	{
+		Double cost = 0;
+		PathNode* at = start;
+		for(list<Connection*>::iterator itr = path.begin(); itr != path.end(); itr++)
+		{
+			if((*itr)->getFromNode() != at)
+				return -1;
+			cost += (*itr)->getCost();
+			at = (*itr)->getToNode();
+		}
+		return at == end ? cost : -1;
+	}
+
+	//times queries searches of both kinds over the same pairs; returns the number of failed checks
+	Int Run(const Char* name, TestGraph& test, uInt queries, Bool legacy)
+	{
+		uInt random = 777;
+		std::vector<PathNode*> starts, ends;
+		for(uInt q = 0; q < queries; q++)
+		{
+			starts.push_back(test.nodes[Next_Random(random) % test.nodes.size()]);
+			ends.push_back(test.nodes[Next_Random(random) % test.nodes.size()]);
+		}
+
+		Int failures = 0;
+		std::vector<Double> costs(queries, -1);
+		list<Connection*> path;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(uInt q = 0; q < queries; q++)
+		{
+			if(test.graph.traverse(starts[q], ends[q], &path))
+			{
+				costs[q] = Path_Cost(path, starts[q], ends[q]);
+				if(costs[q] < 0)
+					failures++;
+			}
+		}
+		Double heapMilliseconds = std::chrono::duration<Double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+
+		if(!legacy)
+		{
+			printf("%-26s legacy        -    heap %9.3f ms\n", name, heapMilliseconds);
+			return failures;
+		}
+
+		std::vector<Legacy_Record*> allocated;
+		start = std::chrono::steady_clock::now();
+		for(uInt q = 0; q < queries; q++)
+		{
+			Double cost = -1;
+			if(Legacy_Traverse(test.nodes, starts[q], ends[q], &path, allocated))
+				cost = Path_Cost(path, starts[q], ends[q]);
+
+			//the same cost, give or take the order the costs were added in
+			if((cost < 0) != (costs[q] < 0) || fabs(cost - costs[q]) > 1.0e-3 * (1.0 + cost))
+				failures++;
+
+			for(uInt i = 0; i < allocated.size(); i++)
+				delete allocated[i];
+			allocated.clear();
+		}
+		Double legacyMilliseconds = std::chrono::duration<Double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+
+		//the old search leaves nodes closed
+		for(uInt i = 0; i < test.nodes.size(); i++)
+			test.nodes[i]->openNode();
+
+		printf("%-26s legacy %9.3f ms   heap %9.3f ms   speedup %7.1fx\n", name, legacyMilliseconds, heapMilliseconds,
+			   legacyMilliseconds / heapMilliseconds);
+		return failures;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Bool legacyOnLarge = argc > 1 && strcmp(argv[1], "all") == 0;
+	Int failures = 0;
+	uInt random = 12345;
+
+	printf("mean time per query\n");
+	{
+		TestGraph test;
+		Build_Grid(test, 30, 30, random);
+		failures += Run("grid 30x30 (900)", test, 50, true);
+	}
+	{
+		TestGraph test;
+		Build_Random(test, 1000, 6, random);
+		failures += Run("random 1000, degree ~6", test, 50, true);
+	}
+	{
+		TestGraph test;
+		Build_Grid(test, 70, 70, random);
+		failures += Run("grid 70x70 (4900)", test, 10, true);
+	}
+	{
+		TestGraph test;
+		Build_Grid(test, 224, 224, random);
+		failures += Run("grid 224x224 (50k)", test, 20, legacyOnLarge);
+	}
+	{
+		TestGraph test;
+		Build_Random(test, 50000, 8, random);
+		failures += Run("random 50k, degree ~8", test, 20, legacyOnLarge);
+	}
+
+	if(failures != 0)
+		printf("FAILED: %d paths were broken or cost differently from the legacy search\n", failures);
+	return failures == 0 ? 0 : 1;
+}
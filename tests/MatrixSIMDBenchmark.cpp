@@ -0,0 +1,211 @@
+// Times the Vector4D and Matrix4D kernels against the per-element loops the classes used before them:
+// Legacy_Vector4D and Legacy_Matrix4D below are the old classes cut down to the operations timed, with
+// their loops as they were, out of line as they were in Vector4D.cpp and Matrix4D.cpp.
+// The arrays are placed 16 mod 32 bytes so the AVX build is timed, and checked, at its worst alignment.
+//
+// sources: none besides this file (see README.txt); build it once per SIMD configuration
+
+#include "CoreMathPhysics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#if defined( _MSC_VER )
+	#define NOINLINE __declspec( noinline )
+#else
+	#define NOINLINE __attribute__( ( noinline ) )
+#endif
+
+// operands per array, and passes over them per timing
+static const uInt count = 1024 ;
+static const uInt passes = 2000 ;
+
+struct Legacy_Vector4D
+{
+	Legacy_Vector4D()	{ for ( Int i = 0 ; i < 4 ; i++ ) v[i] = 0.0f ; }
+
+	Scalar& operator [] ( Int index )		{ assert( index >= 0 && index < 4 ) ; return v[index] ; }
+	Scalar  operator [] ( Int index ) const	{ assert( index >= 0 && index < 4 ) ; return v[index] ; }
+
+	NOINLINE Scalar operator * ( const Legacy_Vector4D& other ) const
+	{
+		Scalar dot_product = 0.0 ;
+		for ( Int i = 0 ; i < 4 ; i++ )
+			dot_product += v[i] * other.v[i] ;
+		return dot_product ;
+	}
+
+	NOINLINE Legacy_Vector4D operator % ( const Legacy_Vector4D& other ) const
+	{
+		Legacy_Vector4D result ;
+		result.v[0] = v[1] * other.v[2] - v[2] * other.v[1] ;
+		result.v[1] = v[2] * other.v[0] - v[0] * other.v[2] ;
+		result.v[2] = v[0] * other.v[1] - v[1] * other.v[0] ;
+		result.v[3] = 0.0f ;
+		return result ;
+	}
+
+	Scalar v[4] ;
+} ;
+
+struct Legacy_Matrix4D
+{
+	NOINLINE Legacy_Matrix4D operator * ( const Legacy_Matrix4D& other ) const
+	{
+		Legacy_Matrix4D result ;
+		for ( Int row = 0 ; row < 4 ; row++ )
+			for ( Int col = 0 ; col < 4 ; col++ )
+				for ( Int k = 0 ; k < 4 ; k++ )
+					result.m[row][col] += m[row][k] * other.m[k][col] ;
+		return result ;
+	}
+
+	NOINLINE Legacy_Vector4D operator * ( const Legacy_Vector4D& vector ) const
+	{
+		Legacy_Vector4D result ;
+		for ( Int row = 0 ; row < 4 ; row++ )
+			for ( Int col = 0 ; col < 4 ; col++ )
+				result[row] += m[row][col] * vector[col] ;
+		return result ;
+	}
+
+	Legacy_Vector4D m[4] ;
+} ;
+
+// count objects at an address that is 16 mod 32
+template < class Type >
+static Type* Allocate_Misaligned( std::vector< Byte >& storage )
+{
+	storage.resize( count * sizeof( Type ) + 64 ) ;
+	Byte* start = &storage[0] + ( 32 - (size_t)&storage[0] % 32 ) + 16 ;
+	return reinterpret_cast< Type* >( start ) ;
+}
+
+static Double Milliseconds_Since( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration< Double, std::milli >( std::chrono::steady_clock::now() - start ).count() ;
+}
+
+static Void Report( const Char* what, Double legacy, Double kernel )
+{
+	Double ops = (Double)count * passes ;
+	printf( "%-24s legacy %6.2f ns   kernel %6.2f ns   speedup %5.2fx\n", what,
+			legacy * 1.0e6 / ops, kernel * 1.0e6 / ops, legacy / kernel ) ;
+}
+
+int main()
+{
+#if defined( MATHPHYSICS_AVX )
+	printf( "kernels: AVX\n" ) ;
+#elif defined( MATHPHYSICS_SSE )
+	printf( "kernels: SSE\n" ) ;
+#else
+	printf( "kernels: scalar\n" ) ;
+#endif
+
+	std::vector< Byte > storage[6] ;
+	Matrix4D* a = Allocate_Misaligned< Matrix4D >( storage[0] ) ;
+	Matrix4D* b = Allocate_Misaligned< Matrix4D >( storage[1] ) ;
+	Matrix4D* product = Allocate_Misaligned< Matrix4D >( storage[2] ) ;
+	Vector4D* v = Allocate_Misaligned< Vector4D >( storage[3] ) ;
+	Vector4D* w = Allocate_Misaligned< Vector4D >( storage[4] ) ;
+	Vector4D* transformed = Allocate_Misaligned< Vector4D >( storage[5] ) ;
+
+	std::vector< Legacy_Matrix4D > legacy_a( count ), legacy_b( count ), legacy_product( count ) ;
+	std::vector< Legacy_Vector4D > legacy_v( count ), legacy_w( count ), legacy_transformed( count ) ;
+
+	srand( 1 ) ;
+	for ( uInt i = 0 ; i < count ; i++ )
+	{
+		for ( Int j = 0 ; j < 16 ; j++ )
+		{
+			a[i].Data()[j] = legacy_a[i].m[j/4][j%4] = rand() / (Scalar)RAND_MAX ;
+			b[i].Data()[j] = legacy_b[i].m[j/4][j%4] = rand() / (Scalar)RAND_MAX ;
+		}
+		for ( Int j = 0 ; j < 4 ; j++ )
+		{
+			v[i][j] = legacy_v[i][j] = rand() / (Scalar)RAND_MAX ;
+			w[i][j] = legacy_w[i][j] = rand() / (Scalar)RAND_MAX ;
+		}
+	}
+
+	Int failures = 0 ;
+	std::chrono::steady_clock::time_point start ;
+	Double legacy, kernel ;
+
+	// matrix * matrix
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_product[i] = legacy_a[i] * legacy_b[( i + pass ) % count] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			product[i] = a[i] * b[( i + pass ) % count] ;
+	kernel = Milliseconds_Since( start ) ;
+	Report( "Matrix4D * Matrix4D", legacy, kernel ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 16 ; j++ )
+			failures += fabs( product[i].Data()[j] - legacy_product[i].m[j/4][j%4] ) > 1.0e-4f ;
+
+	// matrix * vector
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_transformed[i] = legacy_a[( i + pass ) % count] * legacy_v[i] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			transformed[i] = a[( i + pass ) % count] * v[i] ;
+	kernel = Milliseconds_Since( start ) ;
+	Report( "Matrix4D * Vector4D", legacy, kernel ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 4 ; j++ )
+			failures += fabs( transformed[i][j] - legacy_transformed[i][j] ) > 1.0e-4f ;
+
+	// dot
+	Scalar legacy_sum = 0, sum = 0 ;
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_sum += legacy_v[i] * legacy_w[( i + pass ) % count] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			sum += v[i] * w[( i + pass ) % count] ;
+	kernel = Milliseconds_Since( start ) ;
+	Report( "Vector4D dot", legacy, kernel ) ;
+
+	failures += fabs( sum - legacy_sum ) > 1.0e-3f * fabs( legacy_sum ) ;
+
+	// cross
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_transformed[i] = legacy_v[i] % legacy_w[( i + pass ) % count] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			transformed[i] = v[i] % w[( i + pass ) % count] ;
+	kernel = Milliseconds_Since( start ) ;
+	Report( "Vector4D cross", legacy, kernel ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 4 ; j++ )
+			failures += fabs( transformed[i][j] - legacy_transformed[i][j] ) > 1.0e-4f ;
+
+	if ( failures != 0 )
+		printf( "FAILED: %d results differ from the legacy loops\n", failures ) ;
+	return failures == 0 ? 0 : 1 ;
+}
@@ -0,0 +1,132 @@
+// Checks the Vector4D and Matrix4D kernels of SIMD.h against plain loops.
+// Matrix4D and Vector4D only promise 16-byte alignment, so every operand is placed at an address that
+// is 16-byte but not 32-byte aligned, which is what the 8-wide AVX kernels get from new or the stack
+// half of the time.
+//
+// sources: none besides this file (see README.txt); build it once per SIMD configuration
+
+#include "CoreMathPhysics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+static Int failures = 0 ;
+
+static Void Check( Bool ok, const Char* what, Int trial )
+{
+	if ( ok )
+		return ;
+	failures++ ;
+	printf( "FAILED: %s (trial %d)\n", what, trial ) ;
+}
+
+static Scalar Random_Scalar()
+{
+	return rand() / (Scalar)RAND_MAX * 2.0f - 1.0f ;
+}
+
+static Bool Close( Scalar a, Scalar b )
+{
+	return fabs( a - b ) <= 1.0e-5f * ( 1.0f + fabs( b ) ) ;
+}
+
+// storage for a math type at an address that is 16 mod 32
+template < class Type >
+struct Misaligned
+{
+	Misaligned()		{ value = new ( storage + 16 ) Type( uninitialized ) ; }
+	Type& operator * ()	{ return *value ; }
+
+	MATHPHYSICS_ALIGN( 32 ) Byte storage[ sizeof( Type ) + 32 ] ;
+	Type* value ;
+} ;
+
+static Void Reference_Multiply( const Scalar* a, const Scalar* b, Scalar* result )
+{
+	for ( Int row = 0 ; row < 4 ; row++ )
+		for ( Int col = 0 ; col < 4 ; col++ )
+		{
+			Scalar sum = 0 ;
+			for ( Int k = 0 ; k < 4 ; k++ )
+				sum += a[row*4+k] * b[k*4+col] ;
+			result[row*4+col] = sum ;
+		}
+}
+
+int main()
+{
+	srand( 1 ) ;
+
+#if defined( MATHPHYSICS_AVX )
+	printf( "kernels: AVX\n" ) ;
+#elif defined( MATHPHYSICS_SSE )
+	printf( "kernels: SSE\n" ) ;
+#else
+	printf( "kernels: scalar\n" ) ;
+#endif
+
+	Misaligned< Matrix4D > a, b, product ;
+	Misaligned< Vector4D > v, w, transformed ;
+	Check( (uInt64)(size_t)&*a % 32 == 16 && (uInt64)(size_t)&*v % 32 == 16, "operands are 16 mod 32", 0 ) ;
+
+	for ( Int trial = 0 ; trial < 1000 ; trial++ )
+	{
+		for ( Int i = 0 ; i < 16 ; i++ )
+		{
+			( *a ).Data()[i] = Random_Scalar() ;
+			( *b ).Data()[i] = Random_Scalar() ;
+		}
+		for ( Int i = 0 ; i < 4 ; i++ )
+		{
+			( *v )[i] = Random_Scalar() ;
+			( *w )[i] = Random_Scalar() ;
+		}
+
+		Scalar expected[16] ;
+		Reference_Multiply( ( *a ).Data(), ( *b ).Data(), expected ) ;
+
+		// a * b
+		*product = *a * *b ;
+		Bool ok = true ;
+		for ( Int i = 0 ; i < 16 ; i++ )
+			ok &= Close( ( *product ).Data()[i], expected[i] ) ;
+		Check( ok, "Matrix4D * Matrix4D", trial ) ;
+
+		// a *= b pre-multiplies, this = b * a, in place
+		Scalar pre[16] ;
+		Reference_Multiply( ( *b ).Data(), ( *a ).Data(), pre ) ;
+		*product = *a ;
+		*product *= *b ;
+		ok = true ;
+		for ( Int i = 0 ; i < 16 ; i++ )
+			ok &= Close( ( *product ).Data()[i], pre[i] ) ;
+		Check( ok, "Matrix4D *= Matrix4D", trial ) ;
+
+		// m * v and v * m
+		const Scalar* m = ( *a ).Data() ;
+		*transformed = *a * *v ;
+		ok = true ;
+		for ( Int row = 0 ; row < 4 ; row++ )
+			ok &= Close( ( *transformed )[row], m[row*4+0] * ( *v )[0] + m[row*4+1] * ( *v )[1] + m[row*4+2] * ( *v )[2] + m[row*4+3] * ( *v )[3] ) ;
+		Check( ok, "Matrix4D * Vector4D", trial ) ;
+
+		*transformed = *v * *a ;
+		ok = true ;
+		for ( Int col = 0 ; col < 4 ; col++ )
+			ok &= Close( ( *transformed )[col], ( *v )[0] * m[col] + ( *v )[1] * m[4+col] + ( *v )[2] * m[8+col] + ( *v )[3] * m[12+col] ) ;
+		Check( ok, "Vector4D * Matrix4D", trial ) ;
+
+		// dot and cross
+		Scalar dot = ( *v )[0] * ( *w )[0] + ( *v )[1] * ( *w )[1] + ( *v )[2] * ( *w )[2] + ( *v )[3] * ( *w )[3] ;
+		Check( Close( *v * *w, dot ), "Vector4D dot", trial ) ;
+
+		*transformed = *v % *w ;
+		Check( Close( ( *transformed )[0], ( *v )[1] * ( *w )[2] - ( *v )[2] * ( *w )[1] ) &&
+			   Close( ( *transformed )[1], ( *v )[2] * ( *w )[0] - ( *v )[0] * ( *w )[2] ) &&
+			   Close( ( *transformed )[2], ( *v )[0] * ( *w )[1] - ( *v )[1] * ( *w )[0] ) &&
+			   ( *transformed )[3] == 0, "Vector4D cross", trial ) ;
+	}
+
+	printf( failures == 0 ? "all passed\n" : "%d checks failed\n", failures ) ;
+	return failures == 0 ? 0 : 1 ;
+}
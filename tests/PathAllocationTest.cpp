@@ -0,0 +1,160 @@
+//Checks that path searches allocate nothing once they are warmed up: Graph::findPath and
+//CsrGraph::FindPath reusing their results, with and without a heuristic, on a 60x60 grid with a few
+//closed nodes. operator new is replaced to count every allocation the program makes.
+//Then deletes the nodes in a shuffled order, together with the graph, which must not touch freed
+//connections (build with -fsanitize=address to be sure).
+//
+//sources: AI_Core/Graph.cpp AI_Core/CsrGraph.cpp AI_Core/PathHeuristics.cpp Main_Core/ThreadPool.cpp (see README.txt)
+
+#include "Graph.h"
+#include "CsrGraph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+//the grid is gridSize x gridSize nodes
+static const uInt gridSize = 60;
+//searches run before counting, to size the contexts and results
+static const uInt warmUpSearches = 50;
+//searches counted
+static const uInt countedSearches = 500;
+
+//allocations made by the whole program so far
+static uInt64 allocations = 0;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	void* memory = malloc(size != 0 ? size : 1);
+	if(memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+namespace
+{
+	Int failures = 0;
+
+	Void Check(Bool ok, const Char* what, uInt64 value)
+	{
+		if(ok)
+			return;
+		failures++;
+		printf("FAILED: %s (%llu)\n", what, (unsigned long long)value);
+	}
+
+	//a small linear congruential generator, so every run searches the same pairs
+	uInt Next_Random(uInt& state)
+	{
+		state = state * 1103515245u + 12345u;
+		return state >> 8;
+	}
+
+	//searches between random pairs of nodes with findPath, returning how many allocations the last
+	//countedSearches made
+	uInt64 Count_FindPath(Graph& graph, const Heuristic& heuristic)
+	{
+		uInt random = 1;
+		PathResult result;
+		uInt64 before = 0;
+		uInt found = 0;
+		for(uInt i = 0; i < warmUpSearches + countedSearches; i++)
+		{
+			if(i == warmUpSearches)
+				before = allocations;
+			PathNode* start = graph.getNode(Next_Random(random) % graph.getNodeCount());
+			PathNode* goal = graph.getNode(Next_Random(random) % graph.getNodeCount());
+			found += graph.findPath(start, goal, heuristic, &result);
+		}
+		Check(found > countedSearches / 2, "findPath found most paths", found);
+		return allocations - before;
+	}
+
+	//the same with CsrGraph::FindPath
+	uInt64 Count_CsrFindPath(CsrGraph& graph, const Heuristic& heuristic)
+	{
+		uInt random = 1;
+		NodePathResult result;
+		uInt64 before = 0;
+		uInt found = 0;
+		for(uInt i = 0; i < warmUpSearches + countedSearches; i++)
+		{
+			if(i == warmUpSearches)
+				before = allocations;
+			uInt start = Next_Random(random) % graph.NodeCount();
+			uInt goal = Next_Random(random) % graph.NodeCount();
+			found += graph.FindPath(start, goal, heuristic, &result);
+		}
+		Check(found > countedSearches / 2, "CsrGraph::FindPath found most paths", found);
+		return allocations - before;
+	}
+}
+
+int main()
+{
+	Graph graph;
+	std::vector<PathNode*> nodes(gridSize * gridSize);
+	for(uInt i = 0; i < nodes.size(); i++)
+	{
+		nodes[i] = new PathNode();
+		nodes[i]->setPosition(Vector2D((Float)(i % gridSize), (Float)(i / gridSize)));
+		graph.addNode(nodes[i]);
+	}
+	for(uInt y = 0; y < gridSize; y++)
+		for(uInt x = 0; x < gridSize; x++)
+		{
+			uInt i = y * gridSize + x;
+			if(x + 1 < gridSize)
+				nodes[i]->addConnection(nodes[i + 1], 1);
+			if(y + 1 < gridSize)
+				nodes[i]->addConnection(nodes[i + gridSize], 1);
+		}
+	//a connection of a node to itself, and a wall with a gap
+	nodes[5]->addConnection(nodes[5], 1);
+	for(uInt y = 0; y + 1 < gridSize; y++)
+		graph.closeNode(nodes[y * gridSize + gridSize / 2]);
+
+	Heuristic manhattan = ManhattanHeuristic(1);
+	Heuristic none;
+
+	uInt64 counted = Count_FindPath(graph, manhattan);
+	printf("Graph::findPath A*          %llu allocations in %u searches\n", (unsigned long long)counted, countedSearches);
+	Check(counted == 0, "Graph::findPath A* allocates", counted);
+
+	counted = Count_FindPath(graph, none);
+	printf("Graph::findPath Dijkstra    %llu allocations in %u searches\n", (unsigned long long)counted, countedSearches);
+	Check(counted == 0, "Graph::findPath Dijkstra allocates", counted);
+
+	CsrGraph csr;
+	csr.Build(graph);
+
+	counted = Count_CsrFindPath(csr, manhattan);
+	printf("CsrGraph::FindPath A*       %llu allocations in %u searches\n", (unsigned long long)counted, countedSearches);
+	Check(counted == 0, "CsrGraph::FindPath A* allocates", counted);
+
+	counted = Count_CsrFindPath(csr, none);
+	printf("CsrGraph::FindPath Dijkstra %llu allocations in %u searches\n", (unsigned long long)counted, countedSearches);
+	Check(counted == 0, "CsrGraph::FindPath Dijkstra allocates", counted);
+
+	//nodes are deleted together with their graph, in any order
+	uInt random = 2;
+	for(uInt i = (uInt)nodes.size() - 1; i > 0; i--)
+		std::swap(nodes[i], nodes[Next_Random(random) % (i + 1)]);
+	for(uInt i = 0; i < nodes.size(); i++)
+		delete nodes[i];
+
+	printf(failures == 0 ? "all passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+//Times SpatialGrid on the frame it was written for: 100k agents that each move, then each look at
+//their neighbours, 60 times a second. A tick rebuilds the grid and runs a separation pass (every agent
+//sums the offsets of the agents within its radius, found cell by cell with ForEachNeighbour), both
+//split across ThreadPool::Shared(). The agents are kept in cell order, as a game would keep them.
+//The ticks are measured against the 16.7 ms of a 60 Hz frame, and a sample of the agents is checked
+//against a scan of every agent. Move is not timed: it is for the few agents that jump between
+//rebuilds, and an item moved out of its cell stays on a side list until the next Build.
+//
+//sources: AI_Core/SpatialGrid.cpp Main_Core/ThreadPool.cpp MathPhysics_Core/Random.cpp (see README.txt)
+//usage  : SpatialGridBenchmark [agents] [ticks]
+
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+#include "Random.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+//the world is square, with the agents spread evenly at this many per square unit
+static const Float agentDensity = 0.1f;
+//the separation radius; about 8 neighbours at this density
+static const Float neighbourRadius = 5.0f;
+//how far an agent may move in a tick
+static const Float maxStep = 0.5f;
+//agents checked against a scan of every agent
+static const uInt checkedAgents = 500;
+//the frame at 60 Hz
+static const Double frameMilliseconds = 1000.0 / 60.0;
+
+namespace
+{
+	Double Milliseconds_Since(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<Double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	//every agent sums the offsets to its neighbours. ForEachNeighbour makes all the calls for an agent
+	//on one thread, so each thread only writes to its own agents
+	Void Separate(const SpatialGrid& grid, const std::vector<Float>& x, const std::vector<Float>& y,
+				  std::vector<Float>& pushX, std::vector<Float>& pushY, std::vector<uInt>& neighbours, ThreadPool& pool)
+	{
+		std::fill(pushX.begin(), pushX.end(), 0.0f);
+		std::fill(pushY.begin(), pushY.end(), 0.0f);
+		std::fill(neighbours.begin(), neighbours.end(), 0u);
+		grid.ForEachNeighbour(neighbourRadius, [&](uInt agent, uInt, Float neighbourX, Float neighbourY, Float)
+		{
+			pushX[agent] += x[agent] - neighbourX;
+			pushY[agent] += y[agent] - neighbourY;
+			neighbours[agent]++;
+		}, &pool);
+	}
+
+	//stores the agents row of cells by row of cells, as a game would every so often, so agents that
+	//are near each other are near each other in memory too. They wander too little in a run to undo it
+	Void Order_By_Cell(std::vector<Float>& x, std::vector<Float>& y)
+	{
+		std::vector<uInt> order(x.size());
+		for(uInt i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](uInt a, uInt b)
+		{
+			Int rowA = (Int)(y[a] / neighbourRadius), rowB = (Int)(y[b] / neighbourRadius);
+			if(rowA != rowB)
+				return rowA < rowB;
+			return (Int)(x[a] / neighbourRadius) < (Int)(x[b] / neighbourRadius);
+		});
+
+		std::vector<Float> orderedX(x.size()), orderedY(y.size());
+		for(uInt i = 0; i < order.size(); i++)
+		{
+			orderedX[i] = x[order[i]];
+			orderedY[i] = y[order[i]];
+		}
+		x.swap(orderedX);
+		y.swap(orderedY);
+	}
+
+	//checks the neighbour counts of a sample of agents against a scan of every agent
+	Int Check(const std::vector<Float>& x, const std::vector<Float>& y, const std::vector<uInt>& neighbours)
+	{
+		Int failures = 0;
+		uInt count = (uInt)x.size();
+		for(uInt i = 0; i < count; i += std::max(1u, count / checkedAgents))
+		{
+			uInt found = 0;
+			for(uInt j = 0; j < count; j++)
+			{
+				Float dx = x[j] - x[i], dy = y[j] - y[i];
+				if(j != i && dx * dx + dy * dy <= neighbourRadius * neighbourRadius)
+					found++;
+			}
+			if(found != neighbours[i])
+				failures++;
+		}
+		return failures;
+	}
+
+	//runs ticks frames and prints how long they took; returns the number of failed checks
+	Int Run(uInt count, uInt ticks, ThreadPool& pool)
+	{
+		Float side = sqrtf(count / agentDensity);
+		std::vector<Float> x(count), y(count), pushX(count), pushY(count);
+		std::vector<uInt> neighbours(count);
+
+		Random random(7);
+		for(uInt i = 0; i < count; i++)
+		{
+			x[i] = random.Range(0, side);
+			y[i] = random.Range(0, side);
+		}
+		Order_By_Cell(x, y);
+
+		SpatialGrid grid(neighbourRadius);
+		grid.Build(&x[0], &y[0], count, &pool);
+
+		std::vector<Double> tickTimes, buildTimes;
+		for(uInt tick = 0; tick < ticks; tick++)
+		{
+			//the agents wander, and stay in the world
+			for(uInt i = 0; i < count; i++)
+			{
+				x[i] = std::min(std::max(x[i] + random.Range(-maxStep, maxStep), 0.0f), side);
+				y[i] = std::min(std::max(y[i] + random.Range(-maxStep, maxStep), 0.0f), side);
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			grid.Build(&x[0], &y[0], count, &pool);
+			buildTimes.push_back(Milliseconds_Since(start));
+
+			Separate(grid, x, y, pushX, pushY, neighbours, pool);
+			tickTimes.push_back(Milliseconds_Since(start));
+		}
+
+		Double total = 0, buildTotal = 0;
+		for(uInt i = 0; i < ticks; i++)
+		{
+			total += tickTimes[i];
+			buildTotal += buildTimes[i];
+		}
+		std::sort(tickTimes.begin(), tickTimes.end());
+		Double worst = tickTimes[ticks * 99 / 100];
+
+		uInt64 neighbourTotal = 0;
+		for(uInt i = 0; i < count; i++)
+			neighbourTotal += neighbours[i];
+
+		printf("Build %.2f ms + separation %.2f ms = %.2f ms a tick, p99 %.2f ms (%.1f neighbours each); 60 Hz %s\n",
+			   buildTotal / ticks, (total - buildTotal) / ticks, total / ticks,
+			   worst, (Double)neighbourTotal / count, worst <= frameMilliseconds ? "sustained" : "NOT sustained");
+
+		Int failures = Check(x, y, neighbours);
+		if(failures != 0)
+			printf("FAILED: %d agents found the wrong neighbours\n", failures);
+		return failures;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uInt count = argc > 1 ? (uInt)atoi(argv[1]) : 100000;
+	uInt ticks = argc > 2 ? (uInt)atoi(argv[2]) : 120;
+
+	ThreadPool& pool = ThreadPool::Shared();
+	printf("%u agents, %u ticks, %u threads\n", count, ticks, pool.WorkerCount() + 1);
+
+	Int failures = Run(count, ticks, pool);
+	return failures == 0 ? 0 : 1;
+}
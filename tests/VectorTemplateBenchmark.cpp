@@ -0,0 +1,270 @@
+// Times the Vector<N,T> / Matrix<N,T> templates against the hand-written classes they replaced.
+// Legacy_Vector2D, Legacy_Vector3D and Legacy_Matrix3D below are those classes cut down to the
+// operations timed, with their loops over dimension and their non-const reference operands as they
+// were, out of line as they were in Vector2D.cpp, Vector3D.cpp and Matrix3D.cpp.
+// Legacy_Matrix3D::operator * computed other * this, so it is called with its operands swapped to
+// compute the same products.
+//
+// sources: none besides this file (see README.txt)
+
+#include "CoreMathPhysics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#if defined( _MSC_VER )
+	#define NOINLINE __declspec( noinline )
+#else
+	#define NOINLINE __attribute__( ( noinline ) )
+#endif
+
+// operands per array, and passes over them per timing
+static const uInt count = 4096 ;
+static const uInt passes = 500 ;
+
+struct Legacy_Vector2D
+{
+	static const Int dimension = 2 ;
+
+	NOINLINE Legacy_Vector2D()	{ for ( Int i = 0 ; i < dimension ; i++ ) v[i] = 0.0f ; }
+
+	NOINLINE Scalar Length()
+	{
+		Scalar length = 0.0 ;
+		for ( Int i = 0 ; i < dimension ; i++ ) length += v[i] * v[i] ;
+		return std::sqrt( length ) ;
+	}
+
+	NOINLINE Void Normalize()
+	{
+		Scalar length = Length() ;
+		if ( length > epsilon )
+			for ( Int i = 0 ; i < dimension ; i++ )
+				v[i] /= length ;
+	}
+
+	NOINLINE Legacy_Vector2D operator * ( Scalar scalar ) const
+	{
+		Legacy_Vector2D result ;
+		for ( Int i = 0 ; i < dimension ; i++ )
+			result.v[i] = v[i] * scalar ;
+		return result ;
+	}
+
+	NOINLINE Void operator += ( Legacy_Vector2D& other )
+	{
+		for ( Int i = 0 ; i < dimension ; i++ )
+			v[i] += other.v[i] ;
+	}
+
+	Scalar v[dimension] ;
+} ;
+
+struct Legacy_Vector3D
+{
+	static const Int dimension = 3 ;
+
+	NOINLINE Legacy_Vector3D()	{ for ( Int i = 0 ; i < dimension ; i++ ) v[i] = 0.0f ; }
+
+	NOINLINE Scalar& operator [] ( Int index )	{ return v[index] ; }
+
+	NOINLINE Legacy_Vector3D operator + ( Legacy_Vector3D& other ) const
+	{
+		Legacy_Vector3D result ;
+		for ( Int i = 0 ; i < dimension ; i++ )
+			result.v[i] = v[i] + other.v[i] ;
+		return result ;
+	}
+
+	NOINLINE Scalar operator * ( Legacy_Vector3D& other ) const
+	{
+		Scalar dot_product = 0.0 ;
+		for ( Int i = 0 ; i < dimension ; i++ )
+			dot_product += v[i] * other.v[i] ;
+		return dot_product ;
+	}
+
+	NOINLINE Legacy_Vector3D operator % ( const Legacy_Vector3D& other ) const
+	{
+		Legacy_Vector3D result ;
+		result.v[X] = v[Y] * other.v[Z] - other.v[Y] * v[Z] ;
+		result.v[Y] = v[Z] * other.v[X] - other.v[Z] * v[X] ;
+		result.v[Z] = v[X] * other.v[Y] - other.v[X] * v[Y] ;
+		return result ;
+	}
+
+	Scalar v[dimension] ;
+} ;
+
+struct Legacy_Matrix3D
+{
+	static const Int dimension = 3 ;
+
+	NOINLINE Legacy_Matrix3D operator * ( const Legacy_Matrix3D& other ) const
+	{
+		Legacy_Matrix3D result ;
+		for ( Int row = 0 ; row < dimension ; row++ )
+			for ( Int col = 0 ; col < dimension ; col++ )
+				for ( Int k = 0 ; k < dimension ; k++ )
+					result.m[row].v[col] += other.m[row].v[k] * m[k].v[col] ;
+		return result ;
+	}
+
+	NOINLINE Legacy_Vector3D operator * ( const Legacy_Vector3D& vector ) const
+	{
+		Legacy_Vector3D result ;
+		for ( Int row = 0 ; row < dimension ; row++ )
+			for ( Int col = 0 ; col < dimension ; col++ )
+				result[row] += m[row].v[col] * vector.v[col] ;
+		return result ;
+	}
+
+	Legacy_Vector3D m[dimension] ;
+} ;
+
+static Scalar Random_Scalar()
+{
+	return rand() / (Scalar)RAND_MAX * 2.0f - 1.0f ;
+}
+
+static Double Milliseconds_Since( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration< Double, std::milli >( std::chrono::steady_clock::now() - start ).count() ;
+}
+
+static Void Report( const Char* what, Double legacy, Double templated )
+{
+	Double ops = (Double)count * passes ;
+	printf( "%-36s legacy %6.2f ns   template %6.2f ns   speedup %5.2fx\n", what,
+			legacy * 1.0e6 / ops, templated * 1.0e6 / ops, legacy / templated ) ;
+}
+
+int main()
+{
+	std::vector< Legacy_Vector2D > legacy_position( count ), legacy_velocity( count ) ;
+	std::vector< Legacy_Vector3D > legacy_a( count ), legacy_b( count ), legacy_out( count ) ;
+	std::vector< Legacy_Matrix3D > legacy_m( count ), legacy_n( count ), legacy_product( count ) ;
+	std::vector< Vector2D > position( count ), velocity( count ) ;
+	std::vector< Vector3D > a( count ), b( count ), out( count ) ;
+	std::vector< Matrix3D > m( count ), n( count ), product( count ) ;
+
+	srand( 1 ) ;
+	for ( uInt i = 0 ; i < count ; i++ )
+	{
+		for ( Int j = 0 ; j < 2 ; j++ )
+		{
+			position[i][j] = legacy_position[i].v[j] = Random_Scalar() ;
+			velocity[i][j] = legacy_velocity[i].v[j] = Random_Scalar() ;
+		}
+		for ( Int j = 0 ; j < 3 ; j++ )
+		{
+			a[i][j] = legacy_a[i].v[j] = Random_Scalar() ;
+			b[i][j] = legacy_b[i].v[j] = Random_Scalar() ;
+		}
+		for ( Int j = 0 ; j < 9 ; j++ )
+		{
+			m[i].Data()[j] = legacy_m[i].m[j/3].v[j%3] = Random_Scalar() ;
+			n[i].Data()[j] = legacy_n[i].m[j/3].v[j%3] = Random_Scalar() ;
+		}
+	}
+
+	Int failures = 0 ;
+	std::chrono::steady_clock::time_point start ;
+	Double legacy, templated ;
+	const Scalar dt = 1.0f / 60.0f ;
+
+	// the Kinematic update: position += velocity * dt, velocity normalized
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+		{
+			Legacy_Vector2D step = legacy_velocity[i] * dt ;
+			legacy_position[i] += step ;
+			legacy_velocity[i].Normalize() ;
+		}
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+		{
+			position[i] += velocity[i] * dt ;
+			velocity[i].Normalize() ;
+		}
+	templated = Milliseconds_Since( start ) ;
+	Report( "Vector2D p += v * dt, v.Normalize()", legacy, templated ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 2 ; j++ )
+			failures += fabs( position[i][j] - legacy_position[i].v[j] ) > 1.0e-3f ;
+
+	// Vector3D sum, dot and cross
+	Scalar legacy_sum = 0, sum = 0 ;
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+		{
+			Legacy_Vector3D& other = legacy_b[( i + pass ) % count] ;
+			Legacy_Vector3D cross = legacy_a[i] % other ;
+			legacy_out[i] = cross + other ;
+			legacy_sum += legacy_a[i] * other ;
+		}
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+		{
+			const Vector3D& other = b[( i + pass ) % count] ;
+			out[i] = a[i] % other + other ;
+			sum += a[i] * other ;
+		}
+	templated = Milliseconds_Since( start ) ;
+	Report( "Vector3D a % b + b, a * b", legacy, templated ) ;
+
+	failures += fabs( sum - legacy_sum ) > 1.0e-3f * ( 1.0f + fabs( legacy_sum ) ) ;
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 3 ; j++ )
+			failures += fabs( out[i][j] - legacy_out[i].v[j] ) > 1.0e-4f ;
+
+	// Matrix3D * Matrix3D
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_product[i] = legacy_n[( i + pass ) % count] * legacy_m[i] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			product[i] = m[i] * n[( i + pass ) % count] ;
+	templated = Milliseconds_Since( start ) ;
+	Report( "Matrix3D * Matrix3D", legacy, templated ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 9 ; j++ )
+			failures += fabs( product[i].Data()[j] - legacy_product[i].m[j/3].v[j%3] ) > 1.0e-4f ;
+
+	// Matrix3D * Vector3D
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			legacy_out[i] = legacy_m[( i + pass ) % count] * legacy_a[i] ;
+	legacy = Milliseconds_Since( start ) ;
+
+	start = std::chrono::steady_clock::now() ;
+	for ( uInt pass = 0 ; pass < passes ; pass++ )
+		for ( uInt i = 0 ; i < count ; i++ )
+			out[i] = m[( i + pass ) % count] * a[i] ;
+	templated = Milliseconds_Since( start ) ;
+	Report( "Matrix3D * Vector3D", legacy, templated ) ;
+
+	for ( uInt i = 0 ; i < count ; i++ )
+		for ( Int j = 0 ; j < 3 ; j++ )
+			failures += fabs( out[i][j] - legacy_out[i].v[j] ) > 1.0e-4f ;
+
+	if ( failures != 0 )
+		printf( "FAILED: %d results differ from the legacy classes\n", failures ) ;
+	return failures == 0 ? 0 : 1 ;
+}